@@ -40,17 +40,25 @@
 #include <glm/ext.hpp>
 
 #include "common.h"
+#include "macros.h"
+#include "streamwrapper.h"
 #include "3d_cache.h"
 #include "3d_info.h"
+#include "3d_model_lod.h"
 #include "sg/scenegraph.h"
 #include "3d_filename_resolver.h"
 #include "3d_plugin_manager.h"
 #include "plugins/3dapi/ifsg_api.h"
 
+#ifdef USE_OPENMP
+#include <omp.h>
+#endif /* USE_OPENMP */
+
 
 #define MASK_3D_CACHE "3D_CACHE"
 
-static wxCriticalSection lock3D_cache;
+// name of the hash index file in the cache directory
+#define HASH_INDEX_FILE "hash_index"
 
 static bool isSHA1Same( const unsigned char* shaA, const unsigned char* shaB )
 {
@@ -61,15 +69,6 @@ static bool isSHA1Same( const unsigned char* shaA, const unsigned char* shaB )
     return true;
 }
 
-static bool checkTag( const char* aTag, void* aPluginMgrPtr )
-{
-    if( NULL == aTag || NULL == aPluginMgrPtr )
-        return false;
-
-    S3D_PLUGIN_MANAGER *pp = (S3D_PLUGIN_MANAGER*) aPluginMgrPtr;
-
-    return pp->CheckTag( aTag );
-}
 
 static const wxString sha1ToWXString( const unsigned char* aSHA1Sum )
 {
@@ -105,6 +104,35 @@ static const wxString sha1ToWXString( const unsigned char* aSHA1Sum )
 }
 
 
+static bool hexToSHA1( const std::string& aHex, unsigned char* aSHA1Sum )
+{
+    if( aHex.size() != 40 )
+        return false;
+
+    for( int i = 0; i < 20; ++i )
+    {
+        unsigned int val = 0;
+
+        for( int j = 0; j < 2; ++j )
+        {
+            char c = aHex[2 * i + j];
+            val <<= 4;
+
+            if( c >= '0' && c <= '9' )
+                val += c - '0';
+            else if( c >= 'a' && c <= 'f' )
+                val += c - 'a' + 10;
+            else
+                return false;
+        }
+
+        aSHA1Sum[i] = (unsigned char) val;
+    }
+
+    return true;
+}
+
+
 class S3D_CACHE_ENTRY
 {
 private:
@@ -126,6 +154,18 @@ public:
     std::string   pluginInfo;   // PluginName:Version string
     SCENEGRAPH*   sceneData;
     S3DMODEL*     renderData;
+    bool          loaded;       // true once the file was read (even if it failed)
+
+    // simplified render data, from level 1 to S3D_LOD_LEVELS - 1; NULL for
+    // the models too small to be simplified
+    S3DMODEL*     lodData[S3D_LOD_LEVELS - 1];
+    bool          lodLoaded;    // true once the levels of detail were built
+
+    void ClearLODs( void );
+
+    // the data of an entry is loaded by one thread at a time; other threads
+    // requesting the same model wait for it
+    wxCriticalSection lock;
 };
 
 
@@ -133,7 +173,12 @@ S3D_CACHE_ENTRY::S3D_CACHE_ENTRY()
 {
     sceneData = NULL;
     renderData = NULL;
+    loaded = false;
+    lodLoaded = false;
     memset( sha1sum, 0, 20 );
+
+    for( int i = 0; i < S3D_LOD_LEVELS - 1; ++i )
+        lodData[i] = NULL;
 }
 
 
@@ -144,6 +189,20 @@ S3D_CACHE_ENTRY::~S3D_CACHE_ENTRY()
 
     if( NULL != renderData )
         S3D::Destroy3DModel( &renderData );
+
+    ClearLODs();
+}
+
+
+void S3D_CACHE_ENTRY::ClearLODs( void )
+{
+    for( int i = 0; i < S3D_LOD_LEVELS - 1; ++i )
+    {
+        if( NULL != lodData[i] )
+            S3D::Destroy3DModel( &lodData[i] );
+    }
+
+    lodLoaded = false;
 }
 
 
@@ -164,6 +223,7 @@ void S3D_CACHE_ENTRY::SetSHA1( const unsigned char* aSHA1Sum )
     }
 
     memcpy( sha1sum, aSHA1Sum, 20 );
+    m_CacheBaseName.clear();
     return;
 }
 
@@ -200,7 +260,8 @@ S3D_CACHE::~S3D_CACHE()
 }
 
 
-SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr )
+SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr,
+                             bool aSceneData )
 {
     if( aCachePtr )
         *aCachePtr = NULL;
@@ -215,56 +276,85 @@ SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCach
         return NULL;
     }
 
-    // check cache if file is already loaded
-    wxCriticalSectionLocker lock( lock3D_cache );
-    std::map< wxString, S3D_CACHE_ENTRY*, S3D::rsort_wxString >::iterator mi;
-    mi = m_CacheMap.find( full3Dpath );
+    // find or create the cache entry; only the map is locked here, so that
+    // different models can be loaded at the same time
+    S3D_CACHE_ENTRY* ep = NULL;
 
-    if( mi != m_CacheMap.end() )
     {
-        wxFileName fname( full3Dpath );
+        wxCriticalSectionLocker lock( m_CacheLock );
+        std::map< wxString, S3D_CACHE_ENTRY*, S3D::rsort_wxString >::iterator mi;
+        mi = m_CacheMap.find( full3Dpath );
 
-        if( fname.FileExists() )    // Only check if file exists. If not, it will
-        {                           // use the same model in cache.
-            bool reload = false;
-            wxDateTime fmdate = fname.GetModificationTime();
+        if( mi != m_CacheMap.end() )
+        {
+            ep = mi->second;
+        }
+        else
+        {
+            ep = new S3D_CACHE_ENTRY;
+            m_CacheList.push_back( ep );
+            m_CacheMap.insert( std::pair< wxString, S3D_CACHE_ENTRY* >( full3Dpath, ep ) );
+        }
+    }
+
+    wxCriticalSectionLocker entryLock( ep->lock );
+
+    if( NULL != aCachePtr )
+        *aCachePtr = ep;
 
-            if( fmdate != mi->second->modTime )
+    if( !ep->loaded )
+    {
+        // a new cache item; search the Filename->Cachename map
+        ep->loaded = true;
+        return checkCache( full3Dpath, ep, aSceneData );
+    }
+
+    // the file is already loaded
+    wxFileName fname( full3Dpath );
+
+    if( fname.FileExists() )    // Only check if file exists. If not, it will
+    {                           // use the same model in cache.
+        bool reload = false;
+        wxDateTime fmdate = fname.GetModificationTime();
+
+        if( fmdate != ep->modTime )
+        {
+            unsigned char hashSum[20];
+            getFileHash( full3Dpath, hashSum );
+            ep->modTime = fmdate;
+
+            if( !isSHA1Same( hashSum, ep->sha1sum ) )
             {
-                unsigned char hashSum[20];
-                getSHA1( full3Dpath, hashSum );
-                mi->second->modTime = fmdate;
-
-                if( !isSHA1Same( hashSum, mi->second->sha1sum ) )
-                {
-                    mi->second->SetSHA1( hashSum );
-                    reload = true;
-                }
+                ep->SetSHA1( hashSum );
+                reload = true;
             }
+        }
 
-            if( reload )
+        if( reload )
+        {
+            if( NULL != ep->sceneData )
             {
-                if( NULL != mi->second->sceneData )
-                {
-                    S3D::DestroyNode( mi->second->sceneData );
-                    mi->second->sceneData = NULL;
-                }
+                S3D::DestroyNode( ep->sceneData );
+                ep->sceneData = NULL;
+            }
 
-                if( NULL != mi->second->renderData )
-                    S3D::Destroy3DModel( &mi->second->renderData );
+            if( NULL != ep->renderData )
+                S3D::Destroy3DModel( &ep->renderData );
 
-                mi->second->sceneData = m_Plugins->Load3DModel( full3Dpath, mi->second->pluginInfo );
-            }
-        }
+            ep->ClearLODs();
 
-        if( NULL != aCachePtr )
-            *aCachePtr = mi->second;
+            if( aSceneData || !loadRenderData( ep ) )
+                loadSceneData( full3Dpath, ep );
 
-        return mi->second->sceneData;
+            return ep->sceneData;
+        }
     }
 
-    // a cache item does not exist; search the Filename->Cachename map
-    return checkCache( full3Dpath, aCachePtr );
+    // the entry may hold only the render data read from the cache
+    if( aSceneData && NULL == ep->sceneData && NULL != ep->renderData )
+        loadSceneData( full3Dpath, ep );
+
+    return ep->sceneData;
 }
 
 
@@ -274,89 +364,51 @@ SCENEGRAPH* S3D_CACHE::Load( const wxString& aModelFile )
 }
 
 
-SCENEGRAPH* S3D_CACHE::checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr )
+SCENEGRAPH* S3D_CACHE::checkCache( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheEntry,
+                                   bool aSceneData )
 {
-    if( aCachePtr )
-        *aCachePtr = NULL;
-
     unsigned char sha1sum[20];
+    wxFileName fname( aFileName );
+    aCacheEntry->modTime = fname.GetModificationTime();
 
-    if( !getSHA1( aFileName, sha1sum ) || m_CacheDir.empty() )
+    if( !getFileHash( aFileName, sha1sum ) || m_CacheDir.empty() )
     {
         // just in case we can't get a hash digest (for example, on access issues)
-        // or we do not have a configured cache file directory, we create an
-        // entry to prevent further attempts at loading the file
-        S3D_CACHE_ENTRY* ep = new S3D_CACHE_ENTRY;
-        m_CacheList.push_back( ep );
-        wxFileName fname( aFileName );
-        ep->modTime = fname.GetModificationTime();
-
-        if( m_CacheMap.insert( std::pair< wxString, S3D_CACHE_ENTRY* >
-            ( aFileName, ep ) ).second == false )
-        {
-            #ifdef DEBUG
-            do {
-                std::ostringstream ostr;
-                ostr << __FILE__ << ": " << __FUNCTION__ << ": " << __LINE__ << "\n";
-                ostr << " * [BUG] duplicate entry in map file; key = '";
-                ostr << aFileName.ToUTF8() << "'";
-                wxLogTrace( MASK_3D_CACHE, "%s\n", ostr.str().c_str() );
-            } while( 0 );
-            #endif
-
-            m_CacheList.pop_back();
-            delete ep;
-        }
-        else
-        {
-            if( aCachePtr )
-                *aCachePtr = ep;
-
-        }
-
+        // or we do not have a configured cache file directory, the entry is left
+        // empty to prevent further attempts at loading the file
         return NULL;
     }
 
-    S3D_CACHE_ENTRY* ep = new S3D_CACHE_ENTRY;
-    m_CacheList.push_back( ep );
-    wxFileName fname( aFileName );
-    ep->modTime = fname.GetModificationTime();
+    aCacheEntry->SetSHA1( sha1sum );
 
-    if( m_CacheMap.insert( std::pair< wxString, S3D_CACHE_ENTRY* >
-                               ( aFileName, ep ) ).second == false )
-    {
-        #ifdef DEBUG
-        do {
-            std::ostringstream ostr;
-            ostr << __FILE__ << ": " << __FUNCTION__ << ": " << __LINE__ << "\n";
-            ostr << " * [BUG] duplicate entry in map file; key = '";
-            ostr << aFileName.ToUTF8() << "'";
-            wxLogTrace( MASK_3D_CACHE, "%s\n", ostr.str().c_str() );
-        } while( 0 );
-        #endif
-
-        m_CacheList.pop_back();
-        delete ep;
+    // the renderers only need the render data; when it is cached there is
+    // no need to build the scene graph
+    if( !aSceneData && loadRenderData( aCacheEntry ) )
         return NULL;
-    }
 
-    if( aCachePtr )
-        *aCachePtr = ep;
+    return loadSceneData( aFileName, aCacheEntry );
+}
 
-    ep->SetSHA1( sha1sum );
 
-    wxString bname = ep->GetCacheBaseName();
+SCENEGRAPH* S3D_CACHE::loadSceneData( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheEntry )
+{
+    wxString bname = aCacheEntry->GetCacheBaseName();
     wxString cachename = m_CacheDir + bname + wxT( ".3dc" );
 
-    if( wxFileName::FileExists( cachename ) && loadCacheData( ep ) )
-        return ep->sceneData;
+    // the scene graph nodes are named from counters shared by all the models
+    // while they are read or written, so the scene data is handled by one
+    // thread at a time
+    wxCriticalSectionLocker pluginsLock( m_PluginsLock );
 
-    ep->sceneData = m_Plugins->Load3DModel( aFileName, ep->pluginInfo );
+    if( wxFileName::FileExists( cachename ) && loadCacheData( aCacheEntry ) )
+        return aCacheEntry->sceneData;
 
-    if( NULL != ep->sceneData )
-        saveCacheData( ep );
+    aCacheEntry->sceneData = m_Plugins->Load3DModel( aFileName, aCacheEntry->pluginInfo );
 
-    return ep->sceneData;
+    if( NULL != aCacheEntry->sceneData )
+        saveCacheData( aCacheEntry );
+
+    return aCacheEntry->sceneData;
 }
 
 
@@ -428,6 +480,138 @@ bool S3D_CACHE::getSHA1( const wxString& aFileName, unsigned char* aSHA1Sum )
 }
 
 
+bool S3D_CACHE::checkTag( const char* aTag, void* aCachePtr )
+{
+    if( NULL == aTag || NULL == aCachePtr )
+        return false;
+
+    S3D_CACHE* cp = (S3D_CACHE*) aCachePtr;
+
+    // called by ReadCache() under m_PluginsLock, but also by ReadModelCache()
+    // without it; the plugin list is only read here
+    return cp->m_Plugins->CheckTag( aTag );
+}
+
+
+bool S3D_CACHE::getFileHash( const wxString& aFileName, unsigned char* aSHA1Sum )
+{
+    wxFileName fname( aFileName );
+
+    if( !fname.FileExists() )
+        return false;
+
+    FILE_HASH fileHash;
+    fileHash.modTime = fname.GetModificationTime().GetTicks();
+    fileHash.size = fname.GetSize().GetValue();
+
+    {
+        wxCriticalSectionLocker lock( m_CacheLock );
+        std::map< wxString, FILE_HASH >::const_iterator hi = m_HashIndex.find( aFileName );
+
+        if( hi != m_HashIndex.end() && hi->second.modTime == fileHash.modTime
+            && hi->second.size == fileHash.size )
+        {
+            memcpy( aSHA1Sum, hi->second.sha1sum, 20 );
+            return true;
+        }
+    }
+
+    // the file is new or was modified: hash it (without locking the cache)
+    if( !getSHA1( aFileName, fileHash.sha1sum ) )
+        return false;
+
+    memcpy( aSHA1Sum, fileHash.sha1sum, 20 );
+
+    wxCriticalSectionLocker lock( m_CacheLock );
+    m_HashIndex[ aFileName ] = fileHash;
+    m_DirtyCache = true;
+
+    return true;
+}
+
+
+void S3D_CACHE::loadHashIndex()
+{
+    if( m_CacheDir.empty() )
+        return;
+
+    wxString fname = m_CacheDir + wxT( HASH_INDEX_FILE );
+
+    if( !wxFileName::FileExists( fname ) )
+        return;
+
+    OPEN_ISTREAM( file, TO_UTF8( fname ) );
+
+    if( file.fail() )
+    {
+        CLOSE_STREAM( file );
+        return;
+    }
+
+    wxCriticalSectionLocker lock( m_CacheLock );
+    std::string line;
+
+    // each line is: "<SHA1 hex digest> <modification time> <size> <full path>"
+    while( std::getline( file, line ) )
+    {
+        std::istringstream iline( line );
+        std::string sha1;
+        FILE_HASH fileHash;
+
+        if( !( iline >> sha1 >> fileHash.modTime >> fileHash.size ) )
+            continue;
+
+        if( !hexToSHA1( sha1, fileHash.sha1sum ) )
+            continue;
+
+        std::string path;
+        iline.ignore( 1 );
+
+        if( !std::getline( iline, path ) || path.empty() )
+            continue;
+
+        m_HashIndex[ wxString::FromUTF8( path.c_str() ) ] = fileHash;
+    }
+
+    CLOSE_STREAM( file );
+    m_DirtyCache = false;
+}
+
+
+bool S3D_CACHE::saveHashIndex()
+{
+    wxCriticalSectionLocker lock( m_CacheLock );
+
+    if( !m_DirtyCache || m_CacheDir.empty() )
+        return true;
+
+    wxString fname = m_CacheDir + wxT( HASH_INDEX_FILE );
+    OPEN_OSTREAM( file, TO_UTF8( fname ) );
+
+    if( file.fail() )
+    {
+        CLOSE_STREAM( file );
+        wxLogTrace( MASK_3D_CACHE, " * [3D model] cannot write hash index '%s'\n",
+            fname.GetData() );
+        return false;
+    }
+
+    for( const auto& entry : m_HashIndex )
+    {
+        file << sha1ToWXString( entry.second.sha1sum ).ToUTF8() << " "
+             << entry.second.modTime << " " << entry.second.size << " "
+             << entry.first.ToUTF8() << "\n";
+    }
+
+    bool ok = !file.fail();
+
+    CLOSE_STREAM( file );
+    m_DirtyCache = false;
+
+    return ok;
+}
+
+
 bool S3D_CACHE::loadCacheData( S3D_CACHE_ENTRY* aCacheItem )
 {
     wxString bname = aCacheItem->GetCacheBaseName();
@@ -462,7 +646,7 @@ bool S3D_CACHE::loadCacheData( S3D_CACHE_ENTRY* aCacheItem )
     if( NULL != aCacheItem->sceneData )
         S3D::DestroyNode( (SGNODE*) aCacheItem->sceneData );
 
-    aCacheItem->sceneData = (SCENEGRAPH*)S3D::ReadCache( fname.ToUTF8(), m_Plugins, checkTag );
+    aCacheItem->sceneData = (SCENEGRAPH*)S3D::ReadCache( fname.ToUTF8(), this, checkTag );
 
     if( NULL == aCacheItem->sceneData )
         return false;
@@ -539,6 +723,53 @@ bool S3D_CACHE::saveCacheData( S3D_CACHE_ENTRY* aCacheItem )
 }
 
 
+bool S3D_CACHE::loadRenderData( S3D_CACHE_ENTRY* aCacheItem )
+{
+    wxString bname = aCacheItem->GetCacheBaseName();
+
+    if( bname.empty() || m_CacheDir.empty() )
+        return false;
+
+    wxString fname = m_CacheDir + bname + wxT( ".3dr" );
+
+    if( !wxFileName::FileExists( fname ) )
+        return false;
+
+    if( NULL != aCacheItem->renderData )
+        S3D::Destroy3DModel( &aCacheItem->renderData );
+
+    aCacheItem->renderData = S3D::ReadModelCache( fname.ToUTF8(), this, checkTag );
+
+    return NULL != aCacheItem->renderData;
+}
+
+
+bool S3D_CACHE::saveRenderData( S3D_CACHE_ENTRY* aCacheItem )
+{
+    if( NULL == aCacheItem->renderData )
+        return false;
+
+    wxString bname = aCacheItem->GetCacheBaseName();
+
+    if( bname.empty() || m_CacheDir.empty() )
+        return false;
+
+    wxString fname = m_CacheDir + bname + wxT( ".3dr" );
+
+    if( wxFileName::Exists( fname ) && !wxFileName::FileExists( fname ) )
+    {
+        wxString errmsg = _( "path exists but is not a regular file" );
+        wxLogTrace( MASK_3D_CACHE, " * [3D model] %s '%s'\n", errmsg.GetData(),
+            fname.ToUTF8() );
+
+        return false;
+    }
+
+    return S3D::WriteModelCache( fname.ToUTF8(), aCacheItem->renderData,
+        aCacheItem->pluginInfo.c_str() );
+}
+
+
 bool S3D_CACHE::Set3DConfigDir( const wxString& aConfigDir )
 {
     if( !m_ConfigDir.empty() )
@@ -635,6 +866,8 @@ bool S3D_CACHE::Set3DConfigDir( const wxString& aConfigDir )
     }
 
     m_CacheDir = cfgdir.GetPathWithSep();
+    loadHashIndex();
+
     return true;
 }
 
@@ -703,6 +936,7 @@ bool S3D_CACHE::SetProjectDir( const wxString& aProjDir )
 
     if( m_FNResolver->SetProjectDir( aProjDir, &hasChanged ) && hasChanged )
     {
+        wxCriticalSectionLocker lock( m_CacheLock );
         m_CacheMap.clear();
 
         std::list< S3D_CACHE_ENTRY* >::iterator sL = m_CacheList.begin();
@@ -750,6 +984,9 @@ std::list< wxString > const* S3D_CACHE::GetFileFilters( void ) const
 
 void S3D_CACHE::FlushCache( bool closePlugins )
 {
+    saveHashIndex();
+
+    wxCriticalSectionLocker lock( m_CacheLock );
     std::list< S3D_CACHE_ENTRY* >::iterator sCL = m_CacheList.begin();
     std::list< S3D_CACHE_ENTRY* >::iterator eCL = m_CacheList.end();
 
@@ -781,10 +1018,7 @@ void S3D_CACHE::ClosePlugins( void )
 S3DMODEL* S3D_CACHE::GetModel( const wxString& aModelFileName )
 {
     S3D_CACHE_ENTRY* cp = NULL;
-    SCENEGRAPH* sp = load( aModelFileName, &cp );
-
-    if( !sp )
-        return NULL;
+    load( aModelFileName, &cp, false );
 
     if( !cp )
     {
@@ -800,16 +1034,158 @@ S3DMODEL* S3D_CACHE::GetModel( const wxString& aModelFileName )
         return NULL;
     }
 
-    if( cp->renderData )
-        return cp->renderData;
+    wxCriticalSectionLocker lock( cp->lock );
+
+    return getRenderData( cp );
+}
+
+
+S3DMODEL* S3D_CACHE::getRenderData( S3D_CACHE_ENTRY* aCacheEntry )
+{
+    if( aCacheEntry->renderData || !aCacheEntry->sceneData )
+        return aCacheEntry->renderData;
+
+    S3DMODEL* mp = S3D::GetModel( aCacheEntry->sceneData );
+    aCacheEntry->renderData = mp;
 
-    S3DMODEL* mp = S3D::GetModel( sp );
-    cp->renderData = mp;
+    // the next sessions read the render data without building the scene graph
+    saveRenderData( aCacheEntry );
 
     return mp;
 }
 
 
+S3DMODEL* S3D_CACHE::GetModelLOD( const wxString& aModelFileName, unsigned int aLevel )
+{
+    if( 0 == aLevel )
+        return GetModel( aModelFileName );
+
+    if( aLevel >= S3D_LOD_LEVELS )
+        return NULL;
+
+    S3D_CACHE_ENTRY* cp = NULL;
+    load( aModelFileName, &cp, false );
+
+    if( !cp )
+        return NULL;
+
+    wxCriticalSectionLocker lock( cp->lock );
+
+    if( !cp->lodLoaded )
+    {
+        cp->lodLoaded = true;
+        loadLODs( cp );
+    }
+
+    return cp->lodData[aLevel - 1];
+}
+
+
+void S3D_CACHE::loadLODs( S3D_CACHE_ENTRY* aCacheEntry )
+{
+    S3DMODEL* model = getRenderData( aCacheEntry );
+
+    if( S3D::CountTriangles( model ) < S3D_LOD_MIN_TRIANGLES )
+        return;
+
+    wxString bname = aCacheEntry->GetCacheBaseName();
+
+    for( unsigned int level = 1; level < S3D_LOD_LEVELS; ++level )
+    {
+        wxString fname;
+
+        if( !bname.empty() && !m_CacheDir.empty() )
+            fname = m_CacheDir + bname + wxString::Format( wxT( "_lod%u.3dr" ), level );
+
+        S3DMODEL*& lod = aCacheEntry->lodData[level - 1];
+
+        // each level is simplified from the previous one, which is much faster
+        // than simplifying the full model again
+        const S3DMODEL* source = ( level > 1 ) ? aCacheEntry->lodData[level - 2] : model;
+        bool            cached = false;
+
+        if( !fname.empty() && wxFileName::FileExists( fname ) )
+        {
+            lod = S3D::ReadModelCache( fname.ToUTF8(), this, checkTag );
+            cached = ( NULL != lod );
+        }
+
+        if( NULL == lod )
+            lod = S3D::SimplifyModel( source, S3D::GetLODRatio( level )
+                                              / S3D::GetLODRatio( level - 1 ) );
+
+        if( NULL == lod )
+            break;
+
+        // the simplification can remove almost nothing, e.g. when all the vertices
+        // are on creases; the renderer then uses the previous level
+        if( S3D::CountTriangles( lod )
+            > S3D_LOD_MAX_KEPT_RATIO * S3D::CountTriangles( source ) )
+        {
+            S3D::Destroy3DModel( &lod );
+            break;
+        }
+
+        if( !cached && !fname.empty() )
+            S3D::WriteModelCache( fname.ToUTF8(), lod, aCacheEntry->pluginInfo.c_str() );
+    }
+}
+
+
+void S3D_CACHE::LoadModels( const std::vector<wxString>& aModelFiles,
+                            std::function<void( const wxString&, S3DMODEL* )> aModelReady,
+                            bool aLoadLODs )
+{
+    const int count = (int) aModelFiles.size();
+    std::vector< S3DMODEL* > models( count, NULL );
+
+    // indexes of the models loaded but not yet passed to aModelReady
+    std::vector< int > readyList;
+    wxCriticalSection readyLock;
+
+    auto reportReadyModels = [&]()
+    {
+        std::vector< int > ready;
+
+        {
+            wxCriticalSectionLocker lock( readyLock );
+            ready.swap( readyList );
+        }
+
+        if( aModelReady )
+        {
+            for( int idx : ready )
+                aModelReady( aModelFiles[idx], models[idx] );
+        }
+    };
+
+    #pragma omp parallel for schedule(dynamic)
+    for( int ii = 0; ii < count; ++ii )
+    {
+        models[ii] = GetModel( aModelFiles[ii] );
+
+        // the levels of detail are built with the models, so the simplification
+        // of big models is also spread on all the cores
+        if( aLoadLODs && models[ii] )
+            GetModelLOD( aModelFiles[ii], 1 );
+
+        {
+            wxCriticalSectionLocker lock( readyLock );
+            readyList.push_back( ii );
+        }
+
+        // the callback can use the caller's context (OpenGL for instance):
+        // only the calling thread reports the models
+        #ifdef USE_OPENMP
+        if( omp_get_thread_num() == 0 )
+        #endif
+            reportReadyModels();
+    }
+
+    reportReadyModels();
+}
+
+
 wxString S3D_CACHE::GetModelHash( const wxString& aModelFileName )
 {
     wxString full3Dpath = m_FNResolver->ResolvePath( aModelFileName );
@@ -817,19 +1193,15 @@ wxString S3D_CACHE::GetModelHash( const wxString& aModelFileName )
     if( full3Dpath.empty() || !wxFileName::FileExists( full3Dpath ) )
         return wxEmptyString;
 
-    // check cache if file is already loaded
-    std::map< wxString, S3D_CACHE_ENTRY*, S3D::rsort_wxString >::iterator mi;
-    mi = m_CacheMap.find( full3Dpath );
-
-    if( mi != m_CacheMap.end() )
-        return mi->second->GetCacheBaseName();
-
-    // a cache item does not exist; search the Filename->Cachename map
+    // the cache item is created if it does not exist
     S3D_CACHE_ENTRY* cp = NULL;
-    checkCache( full3Dpath, &cp );
+    load( full3Dpath, &cp );
 
     if( NULL != cp )
+    {
+        wxCriticalSectionLocker lock( cp->lock );
         return cp->GetCacheBaseName();
+    }
 
     return wxEmptyString;
 }
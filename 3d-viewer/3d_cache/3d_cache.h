@@ -31,7 +31,10 @@
 
 #include <list>
 #include <map>
+#include <vector>
+#include <functional>
 #include <wx/string.h>
+#include <wx/thread.h>
 #include "str_rsort.h"
 #include "3d_filename_resolver.h"
 #include "3d_info.h"
@@ -61,9 +64,21 @@ private:
     /// plugin manager
     S3D_PLUGIN_MANAGER* m_Plugins;
 
-    /// set true if the cache needs to be updated
+    /// set true if the hash index needs to be saved
     bool m_DirtyCache;
 
+    /// the hash of a model file and the file properties it was computed for
+    struct FILE_HASH
+    {
+        long long     modTime;      // file modification time (seconds since the epoch)
+        long long     size;         // file size
+        unsigned char sha1sum[20];
+    };
+
+    /// index of the hashes of model files (full path), saved in the cache directory
+    /// to avoid hashing files which did not change
+    std::map< wxString, FILE_HASH > m_HashIndex;
+
     /// 3D cache directory
     wxString m_CacheDir;
 
@@ -73,18 +88,31 @@ private:
     /// current KiCad project dir
     wxString m_ProjDir;
 
-    /** Find or create cache entry for file name
+    /// protects m_CacheList and m_CacheMap; models can be loaded by several threads
+    wxCriticalSection m_CacheLock;
+
+    /// serializes the calls to the plugins, which are not reentrant, and the
+    /// reading and writing of the scene graph cache files
+    wxCriticalSection m_PluginsLock;
+
+    /** Fill a new cache entry for file name
      *
-     * Searches the cache list for the given filename and retrieves
-     * the cache data; a cache entry is created if one does not
-     * already exist.
+     * Retrieves the cache data of the given file from the cache file
+     * directory, or loads the file with the plugins and saves the
+     * cache data. The entry must be locked by the caller.
      *
-     * @param[in]   aFileName   file name (full or partial path)
-     * @param[out]  aCachePtr   optional return address for cache entry pointer
+     * @param[in]   aFileName   file name (full path)
+     * @param[in]   aCacheEntry the new cache entry of the file
+     * @param[in]   aSceneData  false if the render data is enough: the scene
+     *                          graph is then not built when the render data is cached
      * @return      SCENEGRAPH object associated with file name
-     * @retval      NULL    on error
+     * @retval      NULL    on error, or if only the render data was loaded
      */
-    SCENEGRAPH* checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr = NULL );
+    SCENEGRAPH* checkCache( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheEntry,
+                            bool aSceneData = true );
+
+    // load the scene data of an entry from the cache file or with the plugins
+    SCENEGRAPH* loadSceneData( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheEntry );
 
     /**
      * Function getSHA1
@@ -97,14 +125,59 @@ private:
      */
     bool getSHA1( const wxString& aFileName, unsigned char* aSHA1Sum );
 
+    /**
+     * Function getFileHash
+     * retrieves the SHA1 hash of the given file from the hash index if the
+     * modification time and the size of the file did not change, otherwise
+     * calculates it and updates the index
+     *
+     * @param[in]   aFileName   file name (full path)
+     * @param[out]  aSHA1Sum    a 20 byte character array to hold the SHA1 hash
+     * @retval      true        success
+     * @retval      false       failure
+     */
+    bool getFileHash( const wxString& aFileName, unsigned char* aSHA1Sum );
+
+    // load the hash index from the cache directory
+    void loadHashIndex();
+
+    // save the hash index to the cache directory
+    bool saveHashIndex();
+
+    /**
+     * Function checkTag
+     * callback used by S3D::ReadCache to check the plugin tag of a cache file
+     *
+     * @param[in]   aTag        the PluginName:Version string of the cache file
+     * @param[in]   aCachePtr   the S3D_CACHE object
+     * @retval      true        if the tag matches a plugin
+     */
+    static bool checkTag( const char* aTag, void* aCachePtr );
+
     // load scene data from a cache file
     bool loadCacheData( S3D_CACHE_ENTRY* aCacheItem );
 
     // save scene data to a cache file
     bool saveCacheData( S3D_CACHE_ENTRY* aCacheItem );
 
-    // the real load function (can supply a cache entry pointer to member functions)
-    SCENEGRAPH* load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr = NULL );
+    // load render data from a binary cache file
+    bool loadRenderData( S3D_CACHE_ENTRY* aCacheItem );
+
+    // save render data to a binary cache file
+    bool saveRenderData( S3D_CACHE_ENTRY* aCacheItem );
+
+    // return the render data of an entry, converting its scene data if needed;
+    // the entry must be locked by the caller
+    S3DMODEL* getRenderData( S3D_CACHE_ENTRY* aCacheEntry );
+
+    // read the simplified levels of detail of an entry from the cache files,
+    // or build and save them; the entry must be locked by the caller
+    void loadLODs( S3D_CACHE_ENTRY* aCacheEntry );
+
+    // the real load function (can supply a cache entry pointer to member functions);
+    // if aSceneData is false only the render data may be loaded
+    SCENEGRAPH* load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr = NULL,
+                      bool aSceneData = true );
 
 public:
     S3D_CACHE();
@@ -200,6 +273,39 @@ public:
      */
     S3DMODEL* GetModel( const wxString& aModelFileName );
 
+    /**
+     * Function GetModelLOD
+     * returns a simplified version of the render data of a model (see GetModel());
+     * the levels of detail are built once and kept in the cache directory.
+     *
+     * @param aModelFileName is the full path to the model to be loaded
+     * @param aLevel is the level of detail, from 0 (the full model, as returned
+     * by GetModel()) to S3D_LOD_LEVELS - 1
+     * @return is a pointer to the render data or NULL if not available; models
+     * too small to benefit from a simplification only have level 0, and the
+     * levels which would not significantly reduce the previous one are not built
+     */
+    S3DMODEL* GetModelLOD( const wxString& aModelFileName, unsigned int aLevel );
+
+    /**
+     * Function LoadModels
+     * loads the render data of a list of models (see GetModel()) using all the
+     * available cores: the files hashes, the render data cache files and the
+     * conversions into S3DMODEL are processed concurrently.  The scene graphs are
+     * loaded by one thread at a time, whether they come from a plugin or from a
+     * scene graph cache file, since their nodes are named from shared counters.
+     *
+     * @param aModelFiles is the list of the models to load, without duplicates
+     * @param aModelReady is called in the calling thread for each model, as soon
+     * as it is available, with the model file name and its render data (NULL if
+     * the model is not available)
+     * @param aLoadLODs is true to also prepare the levels of detail of the models
+     * (see GetModelLOD())
+     */
+    void LoadModels( const std::vector<wxString>& aModelFiles,
+                     std::function<void( const wxString&, S3DMODEL* )> aModelReady = nullptr,
+                     bool aLoadLODs = false );
+
     wxString GetModelHash( const wxString& aModelFileName );
 };
 
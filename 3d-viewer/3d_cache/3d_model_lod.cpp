@@ -0,0 +1,595 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file 3d_model_lod.cpp
+ * implements the simplification of the meshes of a 3D model by quadric
+ * edge collapse (M. Garland, P. Heckbert, "Surface Simplification Using
+ * Quadric Error Metrics", SIGGRAPH 1997)
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <queue>
+#include <vector>
+#include <stdint.h>
+
+#include "3d_model_lod.h"
+#include "plugins/3dapi/ifsg_api.h"
+
+
+// meshes having less triangles are copied as they are
+#define MIN_MESH_TRIANGLES 64
+
+// a collapse is rejected if it turns a face by more than about 80 degrees
+#define MAX_FACE_TURN_COS 0.2
+
+
+/// Symmetric 4x4 matrix giving the sum of the squared distances of a point
+/// to a set of planes
+class QUADRIC
+{
+public:
+    QUADRIC()
+    {
+        memset( m, 0, sizeof( m ) );
+    }
+
+    void AddPlane( double a, double b, double c, double d, double aWeight )
+    {
+        m[0] += aWeight * a * a; m[1] += aWeight * a * b; m[2] += aWeight * a * c;
+        m[3] += aWeight * a * d; m[4] += aWeight * b * b; m[5] += aWeight * b * c;
+        m[6] += aWeight * b * d; m[7] += aWeight * c * c; m[8] += aWeight * c * d;
+        m[9] += aWeight * d * d;
+    }
+
+    QUADRIC& operator+=( const QUADRIC& aOther )
+    {
+        for( int i = 0; i < 10; ++i )
+            m[i] += aOther.m[i];
+
+        return *this;
+    }
+
+    double Error( const QUADRIC& aOther, const SFVEC3F& aPos ) const
+    {
+        double q[10];
+
+        for( int i = 0; i < 10; ++i )
+            q[i] = m[i] + aOther.m[i];
+
+        const double x = aPos.x;
+        const double y = aPos.y;
+        const double z = aPos.z;
+
+        return q[0] * x * x + 2 * q[1] * x * y + 2 * q[2] * x * z + 2 * q[3] * x
+               + q[4] * y * y + 2 * q[5] * y * z + 2 * q[6] * y
+               + q[7] * z * z + 2 * q[8] * z
+               + q[9];
+    }
+
+private:
+    double m[10];
+};
+
+
+/// A candidate collapse of the vertex m_From on the vertex m_To.  The stamps
+/// tell if the candidate was computed before one of the vertices changed.
+struct COLLAPSE
+{
+    double       m_Cost;
+    unsigned int m_From;
+    unsigned int m_To;
+    unsigned int m_FromStamp;
+    unsigned int m_ToStamp;
+
+    // std::priority_queue keeps the largest element on top: invert the order
+    bool operator<( const COLLAPSE& aOther ) const
+    {
+        return m_Cost > aOther.m_Cost;
+    }
+};
+
+
+static inline uint64_t edgeKey( unsigned int aV0, unsigned int aV1 )
+{
+    if( aV0 > aV1 )
+        std::swap( aV0, aV1 );
+
+    return ( (uint64_t) aV0 << 32 ) | aV1;
+}
+
+
+static inline glm::dvec3 faceNormal( const SFVEC3F& aP0, const SFVEC3F& aP1, const SFVEC3F& aP2 )
+{
+    return glm::cross( glm::dvec3( aP1 - aP0 ), glm::dvec3( aP2 - aP0 ) );
+}
+
+
+class MESH_SIMPLIFIER
+{
+public:
+    MESH_SIMPLIFIER( const SMESH& aMesh ) :
+        m_mesh( aMesh )
+    {
+    }
+
+    bool Simplify( unsigned int aTargetFaces, SMESH& aResult );
+
+private:
+    void addCandidate( unsigned int aFrom, unsigned int aTo );
+    bool canCollapse( unsigned int aFrom, unsigned int aTo );
+    void collapse( unsigned int aFrom, unsigned int aTo );
+    void neighbours( unsigned int aVertex, std::vector< unsigned int >& aResult );
+    void buildResult( SMESH& aResult );
+
+    const SMESH&                                m_mesh;
+
+    std::vector< unsigned int >                 m_faces;        // 3 indexes per face
+    std::vector< bool >                         m_faceAlive;
+    unsigned int                                m_liveFaces;
+
+    std::vector< QUADRIC >                      m_quadrics;
+    std::vector< std::vector< unsigned int > >  m_vertexFaces;  // faces using each vertex
+    std::vector< bool >                         m_locked;       // vertices never removed
+    std::vector< bool >                         m_removed;
+    std::vector< unsigned int >                 m_stamps;
+
+    std::priority_queue< COLLAPSE >             m_candidates;
+
+    // work buffers of canCollapse()
+    std::vector< unsigned int >                 m_neighboursFrom;
+    std::vector< unsigned int >                 m_neighboursTo;
+};
+
+
+bool MESH_SIMPLIFIER::Simplify( unsigned int aTargetFaces, SMESH& aResult )
+{
+    const unsigned int nv = m_mesh.m_VertexSize;
+    const unsigned int nf = m_mesh.m_FaceIdxSize / 3;
+    const SFVEC3F* pos = m_mesh.m_Positions;
+
+    m_faces.assign( m_mesh.m_FaceIdx, m_mesh.m_FaceIdx + nf * 3 );
+    m_faceAlive.assign( nf, true );
+    m_liveFaces = nf;
+    m_quadrics.assign( nv, QUADRIC() );
+    m_vertexFaces.assign( nv, std::vector< unsigned int >() );
+    m_locked.assign( nv, false );
+    m_removed.assign( nv, false );
+    m_stamps.assign( nv, 0 );
+
+    std::vector< uint64_t > edges;
+    edges.reserve( nf * 3 );
+
+    for( unsigned int f = 0; f < nf; ++f )
+    {
+        const unsigned int* v = &m_faces[f * 3];
+
+        if( v[0] >= nv || v[1] >= nv || v[2] >= nv )
+            return false;
+
+        // the quadric of each vertex holds the planes of its faces, weighted
+        // by their area
+        glm::dvec3 n = faceNormal( pos[v[0]], pos[v[1]], pos[v[2]] );
+        double len = glm::length( n );
+
+        if( len > 0.0 )
+        {
+            n /= len;
+            double d = -glm::dot( n, glm::dvec3( pos[v[0]] ) );
+
+            for( int i = 0; i < 3; ++i )
+                m_quadrics[v[i]].AddPlane( n.x, n.y, n.z, d, len * 0.5 );
+        }
+
+        for( int i = 0; i < 3; ++i )
+        {
+            m_vertexFaces[v[i]].push_back( f );
+            edges.push_back( edgeKey( v[i], v[( i + 1 ) % 3] ) );
+        }
+    }
+
+    std::sort( edges.begin(), edges.end() );
+
+    // an edge used by one face only is on the border of the mesh: its vertices
+    // are kept so the border does not move away from the adjacent meshes
+    for( size_t i = 0; i < edges.size(); )
+    {
+        size_t j = i + 1;
+
+        while( j < edges.size() && edges[j] == edges[i] )
+            ++j;
+
+        if( j - i == 1 )
+        {
+            m_locked[edges[i] >> 32] = true;
+            m_locked[edges[i] & 0xFFFFFFFF] = true;
+        }
+
+        i = j;
+    }
+
+    // vertices sharing their position with other ones are on a crease (the
+    // normals differ) or a seam (the texture coordinates differ): keep them
+    std::vector< unsigned int > order( nv );
+
+    for( unsigned int i = 0; i < nv; ++i )
+        order[i] = i;
+
+    std::sort( order.begin(), order.end(),
+               [pos]( unsigned int a, unsigned int b )
+               {
+                   if( pos[a].x != pos[b].x )
+                       return pos[a].x < pos[b].x;
+
+                   if( pos[a].y != pos[b].y )
+                       return pos[a].y < pos[b].y;
+
+                   return pos[a].z < pos[b].z;
+               } );
+
+    for( unsigned int i = 1; i < nv; ++i )
+    {
+        if( pos[order[i]] == pos[order[i - 1]] )
+        {
+            m_locked[order[i]] = true;
+            m_locked[order[i - 1]] = true;
+        }
+    }
+
+    for( size_t i = 0; i < edges.size(); ++i )
+    {
+        if( i > 0 && edges[i] == edges[i - 1] )
+            continue;
+
+        unsigned int v0 = edges[i] >> 32;
+        unsigned int v1 = edges[i] & 0xFFFFFFFF;
+
+        addCandidate( v0, v1 );
+        addCandidate( v1, v0 );
+    }
+
+    edges.clear();
+    edges.shrink_to_fit();
+
+    while( m_liveFaces > aTargetFaces && !m_candidates.empty() )
+    {
+        COLLAPSE c = m_candidates.top();
+        m_candidates.pop();
+
+        if( m_removed[c.m_From] || m_removed[c.m_To]
+            || m_stamps[c.m_From] != c.m_FromStamp || m_stamps[c.m_To] != c.m_ToStamp )
+            continue;
+
+        if( canCollapse( c.m_From, c.m_To ) )
+            collapse( c.m_From, c.m_To );
+    }
+
+    buildResult( aResult );
+
+    return true;
+}
+
+
+void MESH_SIMPLIFIER::addCandidate( unsigned int aFrom, unsigned int aTo )
+{
+    if( m_locked[aFrom] )
+        return;
+
+    // the removed vertex is replaced by the kept one (no new vertex is
+    // created, so the attributes of the vertices do not need to be interpolated)
+    COLLAPSE c;
+    c.m_Cost = m_quadrics[aFrom].Error( m_quadrics[aTo], m_mesh.m_Positions[aTo] );
+    c.m_From = aFrom;
+    c.m_To = aTo;
+    c.m_FromStamp = m_stamps[aFrom];
+    c.m_ToStamp = m_stamps[aTo];
+
+    m_candidates.push( c );
+}
+
+
+void MESH_SIMPLIFIER::neighbours( unsigned int aVertex, std::vector< unsigned int >& aResult )
+{
+    aResult.clear();
+
+    for( unsigned int f : m_vertexFaces[aVertex] )
+    {
+        if( !m_faceAlive[f] )
+            continue;
+
+        for( int i = 0; i < 3; ++i )
+        {
+            if( m_faces[f * 3 + i] != aVertex )
+                aResult.push_back( m_faces[f * 3 + i] );
+        }
+    }
+
+    std::sort( aResult.begin(), aResult.end() );
+    aResult.erase( std::unique( aResult.begin(), aResult.end() ), aResult.end() );
+}
+
+
+bool MESH_SIMPLIFIER::canCollapse( unsigned int aFrom, unsigned int aTo )
+{
+    const SFVEC3F* pos = m_mesh.m_Positions;
+    int sharedFaces = 0;
+
+    for( unsigned int f : m_vertexFaces[aFrom] )
+    {
+        if( !m_faceAlive[f] )
+            continue;
+
+        const unsigned int* v = &m_faces[f * 3];
+
+        if( v[0] == aTo || v[1] == aTo || v[2] == aTo )
+        {
+            ++sharedFaces;
+            continue;
+        }
+
+        // the face must not fold over nor become degenerate when aFrom moves
+        SFVEC3F before[3] = { pos[v[0]], pos[v[1]], pos[v[2]] };
+        SFVEC3F after[3] = { before[0], before[1], before[2] };
+
+        for( int i = 0; i < 3; ++i )
+        {
+            if( v[i] == aFrom )
+                after[i] = pos[aTo];
+        }
+
+        glm::dvec3 n0 = faceNormal( before[0], before[1], before[2] );
+        glm::dvec3 n1 = faceNormal( after[0], after[1], after[2] );
+        double l0 = glm::length( n0 );
+        double l1 = glm::length( n1 );
+
+        if( l1 <= 0.0 || ( l0 > 0.0 && glm::dot( n0, n1 ) < MAX_FACE_TURN_COS * l0 * l1 ) )
+            return false;
+    }
+
+    // the vertices must only share the neighbours opposite to their common
+    // edge, otherwise the collapse would create a non manifold mesh
+    neighbours( aFrom, m_neighboursFrom );
+    neighbours( aTo, m_neighboursTo );
+
+    std::vector< unsigned int >::const_iterator a = m_neighboursFrom.begin();
+    std::vector< unsigned int >::const_iterator b = m_neighboursTo.begin();
+    int common = 0;
+
+    while( a != m_neighboursFrom.end() && b != m_neighboursTo.end() )
+    {
+        if( *a < *b )
+            ++a;
+        else if( *b < *a )
+            ++b;
+        else
+        {
+            ++common;
+            ++a;
+            ++b;
+        }
+    }
+
+    return common == sharedFaces;
+}
+
+
+void MESH_SIMPLIFIER::collapse( unsigned int aFrom, unsigned int aTo )
+{
+    std::vector< unsigned int >& toFaces = m_vertexFaces[aTo];
+
+    for( unsigned int f : m_vertexFaces[aFrom] )
+    {
+        if( !m_faceAlive[f] )
+            continue;
+
+        unsigned int* v = &m_faces[f * 3];
+
+        if( v[0] == aTo || v[1] == aTo || v[2] == aTo )
+        {
+            m_faceAlive[f] = false;
+            --m_liveFaces;
+            continue;
+        }
+
+        for( int i = 0; i < 3; ++i )
+        {
+            if( v[i] == aFrom )
+                v[i] = aTo;
+        }
+
+        toFaces.push_back( f );
+    }
+
+    std::vector< unsigned int >().swap( m_vertexFaces[aFrom] );
+    m_removed[aFrom] = true;
+    m_quadrics[aTo] += m_quadrics[aFrom];
+
+    // the candidates using aTo are now stale
+    ++m_stamps[aTo];
+
+    std::vector< unsigned int >::iterator last =
+            std::remove_if( toFaces.begin(), toFaces.end(),
+                            [this]( unsigned int f ) { return !m_faceAlive[f]; } );
+    toFaces.erase( last, toFaces.end() );
+
+    neighbours( aTo, m_neighboursTo );
+
+    for( unsigned int v : m_neighboursTo )
+    {
+        addCandidate( v, aTo );
+        addCandidate( aTo, v );
+    }
+}
+
+
+void MESH_SIMPLIFIER::buildResult( SMESH& aResult )
+{
+    const unsigned int nv = m_mesh.m_VertexSize;
+    const unsigned int none = 0xFFFFFFFF;
+    std::vector< unsigned int > newIndex( nv, none );
+    unsigned int vertexCount = 0;
+
+    for( size_t f = 0; f < m_faceAlive.size(); ++f )
+    {
+        if( !m_faceAlive[f] )
+            continue;
+
+        for( int i = 0; i < 3; ++i )
+        {
+            unsigned int& idx = newIndex[m_faces[f * 3 + i]];
+
+            if( none == idx )
+                idx = vertexCount++;
+        }
+    }
+
+    aResult.m_VertexSize = vertexCount;
+    aResult.m_Positions = new SFVEC3F[vertexCount];
+    aResult.m_Normals = m_mesh.m_Normals ? new SFVEC3F[vertexCount] : NULL;
+    aResult.m_Texcoords = m_mesh.m_Texcoords ? new SFVEC2F[vertexCount] : NULL;
+    aResult.m_Color = m_mesh.m_Color ? new SFVEC3F[vertexCount] : NULL;
+
+    for( unsigned int i = 0; i < nv; ++i )
+    {
+        unsigned int idx = newIndex[i];
+
+        if( none == idx )
+            continue;
+
+        aResult.m_Positions[idx] = m_mesh.m_Positions[i];
+
+        if( aResult.m_Normals )
+            aResult.m_Normals[idx] = m_mesh.m_Normals[i];
+
+        if( aResult.m_Texcoords )
+            aResult.m_Texcoords[idx] = m_mesh.m_Texcoords[i];
+
+        if( aResult.m_Color )
+            aResult.m_Color[idx] = m_mesh.m_Color[i];
+    }
+
+    aResult.m_FaceIdxSize = m_liveFaces * 3;
+    aResult.m_FaceIdx = new unsigned int[aResult.m_FaceIdxSize];
+    unsigned int* dst = aResult.m_FaceIdx;
+
+    for( size_t f = 0; f < m_faceAlive.size(); ++f )
+    {
+        if( !m_faceAlive[f] )
+            continue;
+
+        for( int i = 0; i < 3; ++i )
+            *dst++ = newIndex[m_faces[f * 3 + i]];
+    }
+
+    aResult.m_MaterialIdx = m_mesh.m_MaterialIdx;
+}
+
+
+template <typename T>
+static T* copyArray( const T* aArray, unsigned int aSize )
+{
+    if( NULL == aArray )
+        return NULL;
+
+    T* copy = new T[aSize];
+    std::copy( aArray, aArray + aSize, copy );
+
+    return copy;
+}
+
+
+static void copyMesh( const SMESH& aMesh, SMESH& aResult )
+{
+    aResult.m_VertexSize = aMesh.m_VertexSize;
+    aResult.m_Positions = copyArray( aMesh.m_Positions, aMesh.m_VertexSize );
+    aResult.m_Normals = copyArray( aMesh.m_Normals, aMesh.m_VertexSize );
+    aResult.m_Texcoords = copyArray( aMesh.m_Texcoords, aMesh.m_VertexSize );
+    aResult.m_Color = copyArray( aMesh.m_Color, aMesh.m_VertexSize );
+    aResult.m_FaceIdxSize = aMesh.m_FaceIdxSize;
+    aResult.m_FaceIdx = copyArray( aMesh.m_FaceIdx, aMesh.m_FaceIdxSize );
+    aResult.m_MaterialIdx = aMesh.m_MaterialIdx;
+}
+
+
+float S3D::GetLODRatio( unsigned int aLevel )
+{
+    // each level keeps about a quarter of the triangles of the previous one
+    static const float ratios[S3D_LOD_LEVELS] = { 1.0f, 0.25f, 0.0625f };
+
+    if( aLevel >= S3D_LOD_LEVELS )
+        return ratios[S3D_LOD_LEVELS - 1];
+
+    return ratios[aLevel];
+}
+
+
+unsigned int S3D::CountTriangles( const S3DMODEL* aModel )
+{
+    unsigned int count = 0;
+
+    if( NULL == aModel )
+        return 0;
+
+    for( unsigned int i = 0; i < aModel->m_MeshesSize; ++i )
+        count += aModel->m_Meshes[i].m_FaceIdxSize / 3;
+
+    return count;
+}
+
+
+S3DMODEL* S3D::SimplifyModel( const S3DMODEL* aModel, float aRatio )
+{
+    if( NULL == aModel || 0 == aModel->m_MeshesSize || aRatio <= 0.0f || aRatio >= 1.0f )
+        return NULL;
+
+    S3DMODEL* model = S3D::New3DModel();
+
+    model->m_MaterialsSize = aModel->m_MaterialsSize;
+    model->m_Materials = copyArray( aModel->m_Materials, aModel->m_MaterialsSize );
+    model->m_MeshesSize = aModel->m_MeshesSize;
+    model->m_Meshes = new SMESH[aModel->m_MeshesSize];
+
+    for( unsigned int i = 0; i < aModel->m_MeshesSize; ++i )
+        S3D::Init3DMesh( model->m_Meshes[i] );
+
+    for( unsigned int i = 0; i < aModel->m_MeshesSize; ++i )
+    {
+        const SMESH& mesh = aModel->m_Meshes[i];
+        unsigned int faceCount = mesh.m_FaceIdxSize / 3;
+        bool simplified = false;
+
+        if( faceCount >= MIN_MESH_TRIANGLES && NULL != mesh.m_Positions )
+        {
+            MESH_SIMPLIFIER simplifier( mesh );
+            simplified = simplifier.Simplify( (unsigned int)( faceCount * aRatio ),
+                                              model->m_Meshes[i] );
+        }
+
+        if( !simplified )
+            copyMesh( mesh, model->m_Meshes[i] );
+    }
+
+    return model;
+}
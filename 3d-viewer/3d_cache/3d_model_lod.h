@@ -0,0 +1,76 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file 3d_model_lod.h
+ * defines the generation of the simplified levels of detail of a 3D model.
+ */
+
+#ifndef MODEL_LOD_3D_H
+#define MODEL_LOD_3D_H
+
+#include <plugins/3dapi/c3dmodel.h>
+
+/// number of levels of detail of a model, including the full model (level 0)
+#define S3D_LOD_LEVELS 3
+
+/// models having less triangles are always rendered at full detail
+#define S3D_LOD_MIN_TRIANGLES 5000
+
+/// a level of detail keeping more than this fraction of the triangles of the
+/// previous level is not worth rendering, and the deeper levels are not built
+#define S3D_LOD_MAX_KEPT_RATIO 0.9
+
+namespace S3D
+{
+    /**
+     * Function GetLODRatio
+     * returns the fraction of the triangles of a model which is kept at the
+     * given level of detail
+     */
+    float GetLODRatio( unsigned int aLevel );
+
+    /**
+     * Function CountTriangles
+     * returns the total number of triangles of the meshes of a model
+     */
+    unsigned int CountTriangles( const S3DMODEL* aModel );
+
+    /**
+     * Function SimplifyModel
+     * creates a copy of a model with about aRatio of its triangles, by
+     * collapsing the edges which least change the shape of the meshes
+     * (quadric error metric).  The borders of the meshes and their creases
+     * (vertices shared by faces of different normals) are kept so the
+     * simplified meshes do not crack; the vertex attributes (normals,
+     * texture coordinates and colors) are the ones of the kept vertices.
+     *
+     * @param aModel is the model to simplify
+     * @param aRatio is the fraction of the triangles to keep (0.0 to 1.0)
+     * @return the simplified model, to be destroyed by S3D::Destroy3DModel(),
+     * or NULL if the model could not be simplified
+     */
+    S3DMODEL* SimplifyModel( const S3DMODEL* aModel, float aRatio );
+}
+
+#endif  // MODEL_LOD_3D_H
@@ -24,6 +24,7 @@
 #include <iostream>
 #include <sstream>
 #include <fstream>
+#include <stdint.h>
 #include <wx/filename.h>
 #include <wx/log.h>
 #include "plugins/3dapi/ifsg_api.h"
@@ -43,6 +44,17 @@ static char BadNode[] = " * [BUG] NULL pointer passed for aNode\n";
 // version format of the cache file
 #define SG_VERSION_TAG "VERSION:2"
 
+// version format of the render data cache file
+#define MODEL_CACHE_VERSION_TAG "S3DMODEL:1"
+
+// written after the tags of a render data cache file, to reject the files
+// written by a machine having a different byte order
+#define MODEL_CACHE_BYTE_ORDER 0x01020304
+
+// flags of the optional arrays of a mesh in a render data cache file
+#define MODEL_CACHE_TEXCOORDS  1
+#define MODEL_CACHE_COLORS     2
+
 
 static void formatMaterial( SMATERIAL& mat, SGAPPEARANCE const* app )
 {
@@ -78,6 +90,292 @@ static void formatMaterial( SMATERIAL& mat, SGAPPEARANCE const* app )
 }
 
 
+// read a "(tag)" string from a cache file
+static bool readCacheTag( std::istream& aFile, std::string& aTag )
+{
+    char schar;
+    aTag.clear();
+    aFile.get( schar );
+
+    if( '(' != schar || !aFile.good() )
+        return false;
+
+    aFile.get( schar );
+
+    while( ')' != schar && aFile.good() )
+    {
+        aTag.push_back( schar );
+        aFile.get( schar );
+    }
+
+    return aFile.good();
+}
+
+
+// the arrays are written as they are stored in memory: check they are packed
+static_assert( sizeof( SFVEC3F ) == 3 * sizeof( float ), "SFVEC3F is not packed" );
+static_assert( sizeof( SFVEC2F ) == 2 * sizeof( float ), "SFVEC2F is not packed" );
+
+
+template <typename T>
+static void writeArray( std::ostream& aFile, const T* aArray, size_t aCount )
+{
+    aFile.write( (const char*) aArray, aCount * sizeof( T ) );
+}
+
+
+// returns the number of bytes left to read in a file of aFileSize bytes
+static uint64_t remainingBytes( std::istream& aFile, uint64_t aFileSize )
+{
+    std::streamoff pos = aFile.tellg();
+
+    if( pos < 0 || (uint64_t) pos > aFileSize )
+        return 0;
+
+    return aFileSize - (uint64_t) pos;
+}
+
+
+// the count is checked against the file size before allocating the array: a
+// corrupt cache file must not make us allocate huge amounts of memory
+template <typename T>
+static bool readArray( std::istream& aFile, uint64_t aFileSize, T*& aArray, size_t aCount )
+{
+    if( aCount > remainingBytes( aFile, aFileSize ) / sizeof( T ) )
+        return false;
+
+    aArray = new T[aCount];
+    aFile.read( (char*) aArray, aCount * sizeof( T ) );
+
+    return aFile.good();
+}
+
+
+bool S3D::WriteModelCache( const char* aFileName, const S3DMODEL* aModel,
+    const char* aPluginInfo )
+{
+    if( NULL == aFileName || aFileName[0] == 0 || NULL == aModel )
+        return false;
+
+    wxString ofile = wxString::FromUTF8Unchecked( aFileName );
+
+    // make sure we make no attempt to write a directory
+    if( wxFileName::Exists( ofile ) && !wxFileName::FileExists( ofile ) )
+        return false;
+
+    OPEN_OSTREAM( output, aFileName );
+
+    if( output.fail() )
+    {
+        wxString errmsg;
+        errmsg << __FILE__ << ": " << __FUNCTION__ << ": " << __LINE__ << "\n";
+        errmsg << " * [INFO] " << "failed to open file" << " '" << aFileName << "'";
+        wxLogTrace( MASK_3D_SG, errmsg );
+        return false;
+    }
+
+    output << "(" << MODEL_CACHE_VERSION_TAG << ")";
+
+    if( NULL != aPluginInfo && aPluginInfo[0] != 0 )
+        output << "(" << aPluginInfo << ")";
+    else
+        output << "(INTERNAL:0.0.0.0)";
+
+    uint32_t header[2] = { MODEL_CACHE_BYTE_ORDER, aModel->m_MaterialsSize };
+    writeArray( output, header, 2 );
+
+    for( unsigned int i = 0; i < aModel->m_MaterialsSize; ++i )
+    {
+        const SMATERIAL& mat = aModel->m_Materials[i];
+        writeArray( output, &mat.m_Ambient, 1 );
+        writeArray( output, &mat.m_Diffuse, 1 );
+        writeArray( output, &mat.m_Emissive, 1 );
+        writeArray( output, &mat.m_Specular, 1 );
+        writeArray( output, &mat.m_Shininess, 1 );
+        writeArray( output, &mat.m_Transparency, 1 );
+    }
+
+    uint32_t meshCount = aModel->m_MeshesSize;
+    writeArray( output, &meshCount, 1 );
+
+    for( unsigned int i = 0; i < aModel->m_MeshesSize; ++i )
+    {
+        const SMESH& mesh = aModel->m_Meshes[i];
+        uint32_t flags = ( mesh.m_Texcoords ? MODEL_CACHE_TEXCOORDS : 0 )
+                         | ( mesh.m_Color ? MODEL_CACHE_COLORS : 0 );
+        uint32_t sizes[4] = { mesh.m_VertexSize, mesh.m_FaceIdxSize, mesh.m_MaterialIdx, flags };
+        writeArray( output, sizes, 4 );
+
+        // the vertex arrays are written in one block each, so they can be read in one call
+        writeArray( output, mesh.m_Positions, mesh.m_VertexSize );
+        writeArray( output, mesh.m_Normals, mesh.m_VertexSize );
+
+        if( mesh.m_Texcoords )
+            writeArray( output, mesh.m_Texcoords, mesh.m_VertexSize );
+
+        if( mesh.m_Color )
+            writeArray( output, mesh.m_Color, mesh.m_VertexSize );
+
+        writeArray( output, mesh.m_FaceIdx, mesh.m_FaceIdxSize );
+    }
+
+    bool rval = !output.fail();
+    CLOSE_STREAM( output );
+
+    if( !rval )
+    {
+        // delete the defective file
+        wxRemoveFile( ofile );
+    }
+
+    return rval;
+}
+
+
+S3DMODEL* S3D::ReadModelCache( const char* aFileName, void* aPluginMgr,
+        bool (*aTagCheck)( const char*, void* ) )
+{
+    if( NULL == aFileName || aFileName[0] == 0 )
+        return NULL;
+
+    if( !wxFileName::FileExists( aFileName ) )
+        return NULL;
+
+    OPEN_ISTREAM( file, aFileName );
+
+    if( file.fail() )
+        return NULL;
+
+    file.seekg( 0, std::ios_base::end );
+    std::streamoff fileSize = file.tellg();
+    file.seekg( 0, std::ios_base::beg );
+
+    if( fileSize <= 0 || file.fail() )
+    {
+        CLOSE_STREAM( file );
+        return NULL;
+    }
+
+    // a render data cache file is only valid for the current version of the
+    // format, and for the plugin which loaded the model
+    std::string tag;
+
+    if( !readCacheTag( file, tag ) || tag.compare( MODEL_CACHE_VERSION_TAG ) )
+    {
+        CLOSE_STREAM( file );
+        return NULL;
+    }
+
+    if( !readCacheTag( file, tag )
+        || ( NULL != aTagCheck && NULL != aPluginMgr && !aTagCheck( tag.c_str(), aPluginMgr ) ) )
+    {
+        CLOSE_STREAM( file );
+        return NULL;
+    }
+
+    uint32_t header[2] = { 0, 0 };
+    file.read( (char*) header, sizeof( header ) );
+
+    // size of a material in the file, see WriteModelCache()
+    const uint64_t materialBytes = 4 * sizeof( SFVEC3F ) + 2 * sizeof( float );
+
+    if( !file.good() || header[0] != MODEL_CACHE_BYTE_ORDER || header[1] == 0
+        || header[1] > remainingBytes( file, fileSize ) / materialBytes )
+    {
+        CLOSE_STREAM( file );
+        return NULL;
+    }
+
+    S3DMODEL* model = S3D::New3DModel();
+    bool ok = true;
+
+    model->m_MaterialsSize = header[1];
+    model->m_Materials = new SMATERIAL[model->m_MaterialsSize];
+
+    for( unsigned int i = 0; i < model->m_MaterialsSize && ok; ++i )
+    {
+        SMATERIAL& mat = model->m_Materials[i];
+        file.read( (char*) &mat.m_Ambient, sizeof( SFVEC3F ) );
+        file.read( (char*) &mat.m_Diffuse, sizeof( SFVEC3F ) );
+        file.read( (char*) &mat.m_Emissive, sizeof( SFVEC3F ) );
+        file.read( (char*) &mat.m_Specular, sizeof( SFVEC3F ) );
+        file.read( (char*) &mat.m_Shininess, sizeof( float ) );
+        file.read( (char*) &mat.m_Transparency, sizeof( float ) );
+        ok = file.good();
+    }
+
+    uint32_t meshCount = 0;
+
+    if( ok )
+    {
+        file.read( (char*) &meshCount, sizeof( meshCount ) );
+        ok = file.good() && meshCount > 0
+             && meshCount <= remainingBytes( file, fileSize ) / ( 4 * sizeof( uint32_t ) );
+    }
+
+    if( ok )
+    {
+        model->m_Meshes = new SMESH[meshCount];
+
+        for( unsigned int i = 0; i < meshCount; ++i )
+            S3D::Init3DMesh( model->m_Meshes[i] );
+
+        model->m_MeshesSize = meshCount;
+    }
+
+    for( unsigned int i = 0; i < meshCount && ok; ++i )
+    {
+        SMESH& mesh = model->m_Meshes[i];
+        uint32_t sizes[4];
+        file.read( (char*) sizes, sizeof( sizes ) );
+
+        // the faces are triangles
+        if( !file.good() || sizes[2] >= model->m_MaterialsSize || ( sizes[1] % 3 ) != 0 )
+        {
+            ok = false;
+            break;
+        }
+
+        mesh.m_VertexSize = sizes[0];
+        mesh.m_FaceIdxSize = sizes[1];
+        mesh.m_MaterialIdx = sizes[2];
+
+        ok = readArray( file, fileSize, mesh.m_Positions, mesh.m_VertexSize )
+             && readArray( file, fileSize, mesh.m_Normals, mesh.m_VertexSize );
+
+        if( ok && ( sizes[3] & MODEL_CACHE_TEXCOORDS ) )
+            ok = readArray( file, fileSize, mesh.m_Texcoords, mesh.m_VertexSize );
+
+        if( ok && ( sizes[3] & MODEL_CACHE_COLORS ) )
+            ok = readArray( file, fileSize, mesh.m_Color, mesh.m_VertexSize );
+
+        if( ok )
+            ok = readArray( file, fileSize, mesh.m_FaceIdx, mesh.m_FaceIdxSize );
+
+        // a corrupt index would crash the renderers
+        for( unsigned int j = 0; j < mesh.m_FaceIdxSize && ok; ++j )
+            ok = mesh.m_FaceIdx[j] < mesh.m_VertexSize;
+    }
+
+    CLOSE_STREAM( file );
+
+    if( !ok )
+    {
+        std::ostringstream ostr;
+        ostr << __FILE__ << ": " << __FUNCTION__ << ": " << __LINE__ << "\n";
+        wxString errmsg = "problems encountered reading render data cache file";
+        ostr << " * [INFO] " << errmsg.ToUTF8() << " '";
+        ostr << aFileName << "'";
+        wxLogTrace( MASK_3D_SG, "%s\n", ostr.str().c_str() );
+
+        S3D::Destroy3DModel( &model );
+        return NULL;
+    }
+
+    return model;
+}
+
+
 bool S3D::WriteVRML( const char* filename, bool overwrite, SGNODE* aTopNode,
     bool reuse, bool renameNodes )
 {
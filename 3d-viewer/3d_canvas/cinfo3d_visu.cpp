@@ -60,6 +60,8 @@ CINFO3D_VISU::CINFO3D_VISU() :
 
     m_render_engine = RENDER_ENGINE_OPENGL_LEGACY;
     m_material_mode = MATERIAL_MODE_NORMAL;
+    m_sampling_mode = SAMPLING_MODE_FIXED;
+    m_sampling_time_budget = 0.0f;
 
     m_boardPos = wxPoint();
     m_boardSize = wxSize();
@@ -245,6 +245,31 @@ class CINFO3D_VISU
      */
     MATERIAL_MODE MaterialModeGet() const { return m_material_mode; }
 
+    /**
+     * @brief SamplingModeSet
+     * @param aSamplingMode = the raytracing anti-aliasing sampling mode
+     */
+    void SamplingModeSet( SAMPLING_MODE aSamplingMode ) { m_sampling_mode = aSamplingMode; }
+
+    /**
+     * @brief SamplingModeGet
+     * @return raytracing anti-aliasing sampling mode
+     */
+    SAMPLING_MODE SamplingModeGet() const { return m_sampling_mode; }
+
+    /**
+     * @brief SamplingTimeBudgetSet
+     * @param aSeconds = time after which the adaptive sampling stops refining
+     * the render, 0 to refine until the quality is reached
+     */
+    void SamplingTimeBudgetSet( float aSeconds ) { m_sampling_time_budget = aSeconds; }
+
+    /**
+     * @brief SamplingTimeBudgetGet
+     * @return adaptive sampling time budget in seconds, 0 if unlimited
+     */
+    float SamplingTimeBudgetGet() const { return m_sampling_time_budget; }
+
     /**
      * @brief GetBoardPoly - Get the current polygon of the epoxy board
      * @return the shape polygon
@@ -532,6 +557,12 @@ class CINFO3D_VISU
     /// mode to render the 3d shape models material
     MATERIAL_MODE       m_material_mode;
 
+    /// raytracing anti-aliasing sampling mode
+    SAMPLING_MODE       m_sampling_mode;
+
+    /// time budget of the adaptive sampling, in seconds (0 = no limit)
+    float               m_sampling_time_budget;
+
 
     // Pcb board position
 
@@ -47,6 +47,7 @@ enum DISPLAY3D_FLG {
     // OpenGL options
     FL_RENDER_OPENGL_SHOW_MODEL_BBOX,
     FL_RENDER_OPENGL_COPPER_THICKNESS,
+    FL_RENDER_OPENGL_MODELS_LOD,
 
     // Raytracing options
     FL_RENDER_RAYTRACING_SHADOWS,
@@ -94,4 +95,14 @@ enum MATERIAL_MODE
     MATERIAL_MODE_CAD_MODE      ///< Use a gray shading based on diffuse material
 };
 
+
+/// Raytracing anti-aliasing sampling mode
+enum SAMPLING_MODE
+{
+    SAMPLING_MODE_FIXED,            ///< Trace the same number of samples in all pixels
+    SAMPLING_MODE_ADAPTIVE_DRAFT,   ///< Add samples only to noisy tiles, low quality
+    SAMPLING_MODE_ADAPTIVE_NORMAL,  ///< Add samples only to noisy tiles, normal quality
+    SAMPLING_MODE_ADAPTIVE_HIGH     ///< Add samples only to noisy tiles, high quality
+};
+
 #endif // _3D_ENUMS_H_
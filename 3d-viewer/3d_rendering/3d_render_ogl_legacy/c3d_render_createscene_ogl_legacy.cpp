@@ -36,6 +36,7 @@
 #include <trigo.h>
 #include <project.h>
 #include <profile.h>        // To use GetRunningMicroSecs or an other profiling utility
+#include <set>
 
 
 void C3D_RENDER_OGL_LEGACY::add_object_to_triangle_layer( const CFILLEDCIRCLE2D * aFilledCircle,
@@ -930,43 +931,54 @@ void C3D_RENDER_OGL_LEGACY::load_3D_models()
         (!m_settings.GetFlag( FL_MODULE_ATTRIBUTES_VIRTUAL )) )
         return;
 
-    // Go for all modules
+    // Collect the models not present in our cache map
+    std::vector< wxString > modelFiles;
+    std::set< wxString > modelNames;
+
     for( const MODULE* module = m_settings.GetBoard()->m_Modules;
          module;
          module = module->Next() )
     {
-        if( !module->Models().empty() )
+        for( const MODULE_3D_SETTINGS& model : module->Models() )
         {
-            // Get the list of model files for this model
-            auto sM = module->Models().begin();
-            auto eM = module->Models().end();
+            if( model.m_Filename.empty() )
+                continue;
+
+            if( m_3dmodel_map.find( model.m_Filename ) != m_3dmodel_map.end() )
+                continue;
+
+            if( modelNames.insert( model.m_Filename ).second )
+                modelFiles.push_back( model.m_Filename );
+        }
+    }
+
+    const bool useLODs = m_settings.GetFlag( FL_RENDER_OPENGL_MODELS_LOD );
+    S3D_CACHE* cacheMgr = m_settings.Get3DCacheManager();
 
-            while( sM != eM )
+    // Get them from the cache, which loads them concurrently; the openGL lists
+    // of each model are created as soon as it is available
+    cacheMgr->LoadModels( modelFiles,
+            [&]( const wxString& aModelFile, const S3DMODEL* aModel )
             {
-                if( !sM->m_Filename.empty() )
+                // only add it if the return is not NULL
+                if( aModel )
                 {
-                    // Check if the model is not present in our cache map
-                    if( m_3dmodel_map.find( sM->m_Filename ) == m_3dmodel_map.end() )
+                    C_OGL_3DMODEL* ogl_model =
+                            new C_OGL_3DMODEL( *aModel, m_settings.MaterialModeGet() );
+
+                    if( ogl_model )
+                        m_3dmodel_map[ aModelFile ] = ogl_model;
+
+                    // the simplified models were prepared by LoadModels()
+                    for( unsigned int level = 1; useLODs && level < S3D_LOD_LEVELS; ++level )
                     {
-                        // It is not present, try get it from cache
-                        const S3DMODEL *modelPtr =
-                                m_settings.Get3DCacheManager()->GetModel( sM->m_Filename );
-
-                        // only add it if the return is not NULL
-                        if( modelPtr )
-                        {
-                            C_OGL_3DMODEL* ogl_model =
-                                    new C_OGL_3DMODEL( *modelPtr,
-                                                       m_settings.MaterialModeGet() );
-
-                            if( ogl_model )
-                                m_3dmodel_map[ sM->m_Filename ] = ogl_model;
-                        }
+                        const S3DMODEL* lod = cacheMgr->GetModelLOD( aModelFile, level );
+
+                        m_3dmodel_lod_map[level - 1][ aModelFile ] = lod ?
+                                new C_OGL_3DMODEL( *lod, m_settings.MaterialModeGet() ) : NULL;
                     }
                 }
+            }, useLODs );
 
-                ++sM;
-            }
-        }
-    }
+    build_3D_model_instances();
 }
@@ -892,6 +892,19 @@ void C3D_RENDER_OGL_LEGACY::ogl_free_all_display_lists()
     }
 
     m_3dmodel_map.clear();
+    m_3dmodel_instances.clear();
+
+    for( unsigned int level = 0; level < S3D_LOD_LEVELS - 1; ++level )
+    {
+        for( MAP_3DMODEL::const_iterator ii = m_3dmodel_lod_map[level].begin();
+             ii != m_3dmodel_lod_map[level].end();
+             ++ii )
+        {
+            delete ii->second;
+        }
+
+        m_3dmodel_lod_map[level].clear();
+    }
 
 
     delete m_ogl_disp_list_board;
@@ -980,116 +993,191 @@ void C3D_RENDER_OGL_LEGACY::render_solder_mask_layer( PCB_LAYER_ID aLayerID,
 void C3D_RENDER_OGL_LEGACY::render_3D_models( bool aRenderTopOrBot,
                                               bool aRenderTransparentOnly )
 {
-    // Go for all modules
-    if( m_settings.GetBoard()->m_Modules.GetCount() )
+    // The instances of each model are drawn together, with the transforms
+    // computed when the board was loaded
+    const glm::mat4& view = m_settings.CameraGet().GetViewMatrix();
+    const bool showBBox = m_settings.GetFlag( FL_RENDER_OPENGL_SHOW_MODEL_BBOX );
+    const unsigned int side = aRenderTopOrBot ? 0 : 1;
+
+    for( const MODEL_INSTANCES& instances : m_3dmodel_instances )
     {
-        for( const MODULE* module = m_settings.GetBoard()->m_Modules;
-             module;
-             module = module->Next() )
+        const C_OGL_3DMODEL* modelPtr = instances.m_Model;
+
+        if( ( aRenderTransparentOnly && !modelPtr->Have_transparent() ) ||
+            ( !aRenderTransparentOnly && !modelPtr->Have_opaque() ) )
+            continue;
+
+        for( const glm::mat4& transform : instances.m_Transforms[side] )
         {
-            if( !module->Models().empty() )
-                if( m_settings.ShouldModuleBeDisplayed( (MODULE_ATTR_T)module->GetAttributes() ) )
-                    if( ( aRenderTopOrBot && !module->IsFlipped()) ||
-                        (!aRenderTopOrBot &&  module->IsFlipped()) )
-                        render_3D_module( module, aRenderTransparentOnly );
+            glPushMatrix();
+            glMultMatrixf( glm::value_ptr( transform ) );
+
+            const C_OGL_3DMODEL* drawPtr = select_3D_model_lod( instances, view * transform );
+
+            if( aRenderTransparentOnly )
+                drawPtr->Draw_transparent();
+            else
+                drawPtr->Draw_opaque();
+
+            if( showBBox )
+            {
+                glEnable( GL_BLEND );
+                glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+
+                glLineWidth( 1 );
+                modelPtr->Draw_bboxes();
+
+                glDisable( GL_LIGHTING );
+
+                glColor4f( 0.0f, 1.0f, 0.0f, 1.0f );
+
+                glLineWidth( 4 );
+                modelPtr->Draw_bbox();
+
+                glEnable( GL_LIGHTING );
+            }
+
+            glPopMatrix();
         }
     }
 }
 
 
-void C3D_RENDER_OGL_LEGACY::render_3D_module( const MODULE* module,
-                                              bool aRenderTransparentOnly )
+void C3D_RENDER_OGL_LEGACY::build_3D_model_instances()
 {
-    if( !module->Models().empty() )
-    {
-        const double zpos = m_settings.GetModulesZcoord3DIU( module->IsFlipped() );
+    m_3dmodel_instances.clear();
 
-        glPushMatrix();
+    // index of the instances of each model in m_3dmodel_instances
+    std::map< wxString, size_t > instancesIndex;
 
-        wxPoint pos = module->GetPosition();
+    const double modelunit_to_3d_units_factor = m_settings.BiuTo3Dunits() * UNITS3D_TO_UNITSPCB;
 
-        glTranslatef(  pos.x * m_settings.BiuTo3Dunits(),
-                      -pos.y * m_settings.BiuTo3Dunits(),
-                       zpos );
+    for( const MODULE* module = m_settings.GetBoard()->m_Modules;
+         module;
+         module = module->Next() )
+    {
+        if( module->Models().empty() ||
+            !m_settings.ShouldModuleBeDisplayed( (MODULE_ATTR_T)module->GetAttributes() ) )
+            continue;
+
+        // Same transforms as the openGL calls used to place each module
+        const double zpos = m_settings.GetModulesZcoord3DIU( module->IsFlipped() );
+        const wxPoint pos = module->GetPosition();
+
+        glm::mat4 moduleTransform = glm::translate( glm::mat4( 1.0f ),
+                SFVEC3F( pos.x * m_settings.BiuTo3Dunits(),
+                        -pos.y * m_settings.BiuTo3Dunits(),
+                         zpos ) );
 
         if( module->GetOrientation() )
-            glRotated( (double) module->GetOrientation() / 10.0, 0.0, 0.0, 1.0 );
+            moduleTransform = glm::rotate( moduleTransform,
+                    glm::radians( (float)( module->GetOrientation() / 10.0 ) ),
+                    SFVEC3F( 0.0f, 0.0f, 1.0f ) );
 
         if( module->IsFlipped() )
         {
-            glRotatef( 180.0f, 0.0f, 1.0f, 0.0f );
-            glRotatef( 180.0f, 0.0f, 0.0f, 1.0f );
+            moduleTransform = glm::rotate( moduleTransform, glm::pi<float>(),
+                                           SFVEC3F( 0.0f, 1.0f, 0.0f ) );
+            moduleTransform = glm::rotate( moduleTransform, glm::pi<float>(),
+                                           SFVEC3F( 0.0f, 0.0f, 1.0f ) );
         }
 
-        double modelunit_to_3d_units_factor = m_settings.BiuTo3Dunits() * UNITS3D_TO_UNITSPCB;
+        moduleTransform = glm::scale( moduleTransform,
+                                      SFVEC3F( (float) modelunit_to_3d_units_factor ) );
 
-        glScaled( modelunit_to_3d_units_factor,
-                  modelunit_to_3d_units_factor,
-                  modelunit_to_3d_units_factor );
+        for( const MODULE_3D_SETTINGS& sM : module->Models() )
+        {
+            if( sM.m_Filename.empty() )
+                continue;
 
-        // Get the list of model files for this model
-        auto sM = module->Models().begin();
-        auto eM = module->Models().end();
+            MAP_3DMODEL::const_iterator ii = m_3dmodel_map.find( sM.m_Filename );
 
-        while( sM != eM )
-        {
-            if( !sM->m_Filename.empty() )
+            if( ii == m_3dmodel_map.end() || !ii->second )
+                continue;
+
+            std::map< wxString, size_t >::const_iterator idx = instancesIndex.find( sM.m_Filename );
+
+            if( idx == instancesIndex.end() )
             {
-                // Check if the model is present in our cache map
-                if( m_3dmodel_map.find( sM->m_Filename ) != m_3dmodel_map.end() )
+                MODEL_INSTANCES instances;
+                instances.m_Model = ii->second;
+
+                for( unsigned int level = 0; level < S3D_LOD_LEVELS - 1; ++level )
                 {
-                    // It is not present, try get it from cache
-                    const C_OGL_3DMODEL *modelPtr = m_3dmodel_map[ sM->m_Filename ];
+                    MAP_3DMODEL::const_iterator lod = m_3dmodel_lod_map[level].find( sM.m_Filename );
 
-                    if( modelPtr )
-                    {
-                        if( ( (!aRenderTransparentOnly) && modelPtr->Have_opaque() ) ||
-                            ( aRenderTransparentOnly && modelPtr->Have_transparent() ) )
-                        {
-                            glPushMatrix();
+                    instances.m_LODs[level] =
+                            ( lod != m_3dmodel_lod_map[level].end() ) ? lod->second : NULL;
+                }
 
-                            glTranslatef( sM->m_Offset.x, sM->m_Offset.y, sM->m_Offset.z );
+                idx = instancesIndex.insert( std::make_pair( sM.m_Filename,
+                                                             m_3dmodel_instances.size() ) ).first;
+                m_3dmodel_instances.push_back( instances );
+            }
 
-                            glRotatef( -sM->m_Rotation.z, 0.0f, 0.0f, 1.0f );
-                            glRotatef( -sM->m_Rotation.y, 0.0f, 1.0f, 0.0f );
-                            glRotatef( -sM->m_Rotation.x, 1.0f, 0.0f, 0.0f );
+            glm::mat4 transform = glm::translate( moduleTransform,
+                    SFVEC3F( sM.m_Offset.x, sM.m_Offset.y, sM.m_Offset.z ) );
 
-                            glScalef( sM->m_Scale.x, sM->m_Scale.y, sM->m_Scale.z );
+            transform = glm::rotate( transform, glm::radians( (float) -sM.m_Rotation.z ),
+                                     SFVEC3F( 0.0f, 0.0f, 1.0f ) );
+            transform = glm::rotate( transform, glm::radians( (float) -sM.m_Rotation.y ),
+                                     SFVEC3F( 0.0f, 1.0f, 0.0f ) );
+            transform = glm::rotate( transform, glm::radians( (float) -sM.m_Rotation.x ),
+                                     SFVEC3F( 1.0f, 0.0f, 0.0f ) );
+            transform = glm::scale( transform,
+                    SFVEC3F( sM.m_Scale.x, sM.m_Scale.y, sM.m_Scale.z ) );
 
-                            if( aRenderTransparentOnly )
-                                modelPtr->Draw_transparent();
-                            else
-                                modelPtr->Draw_opaque();
+            m_3dmodel_instances[idx->second].m_Transforms[module->IsFlipped() ? 1 : 0]
+                    .push_back( transform );
+        }
+    }
+}
 
-                            if( m_settings.GetFlag( FL_RENDER_OPENGL_SHOW_MODEL_BBOX ) )
-                            {
-                                glEnable( GL_BLEND );
-                                glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
 
-                                glLineWidth( 1 );
-                                modelPtr->Draw_bboxes();
+// Below these sizes on screen (diameter of the bounding box of the model in
+// pixels), the levels of detail 1 and 2 are rendered
+static const float lod_max_pixels[S3D_LOD_LEVELS - 1] = { 150.0f, 40.0f };
 
-                                glDisable( GL_LIGHTING );
 
-                                glColor4f( 0.0f, 1.0f, 0.0f, 1.0f );
+const C_OGL_3DMODEL* C3D_RENDER_OGL_LEGACY::select_3D_model_lod(
+        const MODEL_INSTANCES& aInstances, const glm::mat4& aModelView ) const
+{
+    const C_OGL_3DMODEL* selected = aInstances.m_Model;
 
-                                glLineWidth( 4 );
-                                modelPtr->Draw_bbox();
+    if( !aInstances.m_LODs[0] )
+        return selected;
 
-                                glEnable( GL_LIGHTING );
-                            }
+    // Place the bounding box of the model in eye coordinates
+    const CBBOX& bbox = selected->GetBBox();
+    const SFVEC4F center = aModelView * SFVEC4F( bbox.GetCenter(), 1.0f );
 
-                            glPopMatrix();
-                        }
-                    }
-                }
-            }
+    const float scale = glm::max( glm::length( SFVEC3F( aModelView[0] ) ),
+                                  glm::max( glm::length( SFVEC3F( aModelView[1] ) ),
+                                            glm::length( SFVEC3F( aModelView[2] ) ) ) );
 
-            ++sM;
-        }
+    const float diameter = glm::length( bbox.GetExtent() ) * scale;
 
-        glPopMatrix();
+    // Project it: w is the distance to the camera in perspective and 1 in
+    // orthographic projection
+    const glm::mat4& projection = m_settings.CameraGet().GetProjectionMatrix();
+    const float w = ( projection * center ).w;
+
+    if( w <= 0.0f )
+        return selected;
+
+    const float pixels = diameter * projection[1][1] / w * m_windowSize.y * 0.5f;
+
+    // A missing level (the model could not be reduced further) leaves the
+    // nearest level above it selected
+    for( unsigned int level = 0; level < S3D_LOD_LEVELS - 1; ++level )
+    {
+        if( pixels >= lod_max_pixels[level] || !aInstances.m_LODs[level] )
+            break;
+
+        selected = aInstances.m_LODs[level];
     }
+
+    return selected;
 }
 
 
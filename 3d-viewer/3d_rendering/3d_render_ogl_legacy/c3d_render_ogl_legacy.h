@@ -43,14 +43,26 @@
 #include "c_ogl_3dmodel.h"
 
 #include "3d_cache/3d_info.h"
+#include "3d_cache/3d_model_lod.h"
 
 #include <map>
+#include <vector>
 
 
 typedef std::map< PCB_LAYER_ID, CLAYERS_OGL_DISP_LISTS* > MAP_OGL_DISP_LISTS;
 typedef std::map< PCB_LAYER_ID, CLAYER_TRIANGLES * > MAP_TRIANGLES;
 typedef std::map< wxString, C_OGL_3DMODEL * > MAP_3DMODEL;
 
+/// The placements of a 3D model on the board, to draw all its instances at once
+struct MODEL_INSTANCES
+{
+    const C_OGL_3DMODEL*        m_Model;    ///< full detail model
+    const C_OGL_3DMODEL*        m_LODs[S3D_LOD_LEVELS - 1]; ///< simplified models or NULL
+
+    /// model to board transforms of the instances on the top (0) and bottom (1) sides
+    std::vector< glm::mat4 >    m_Transforms[2];
+};
+
 #define SIZE_OF_CIRCLE_TEXTURE 1024
 
 /**
@@ -106,6 +118,13 @@ private:
 
     MAP_3DMODEL m_3dmodel_map;
 
+    /// simplified models, for each level of detail above 0 (NULL if the model
+    /// has no such level)
+    MAP_3DMODEL m_3dmodel_lod_map[S3D_LOD_LEVELS - 1];
+
+    /// the displayed models and their placements, built when the board is loaded
+    std::vector< MODEL_INSTANCES > m_3dmodel_instances;
+
 private:
     void generate_through_outer_holes();
     void generate_through_inner_holes();
@@ -184,7 +203,20 @@ private:
      */
     void render_3D_models( bool aRenderTopOrBot, bool aRenderTransparentOnly );
 
-    void render_3D_module( const MODULE* module, bool aRenderTransparentOnly );
+    /**
+     * @brief build_3D_model_instances - collect the placements of the loaded
+     * models for the displayed modules, grouped by model
+     */
+    void build_3D_model_instances();
+
+    /**
+     * @brief select_3D_model_lod - return the level of detail of a model to
+     * render, from the size of its bounding box on screen.
+     * @param aInstances - the model and its simplified versions
+     * @param aModelView - the transform from the model to the eye coordinates
+     */
+    const C_OGL_3DMODEL* select_3D_model_lod( const MODEL_INSTANCES& aInstances,
+                                              const glm::mat4& aModelView ) const;
 
     void setLight_Front( bool enabled );
     void setLight_Top( bool enabled );
@@ -33,6 +33,11 @@
  *  - Code style to match KiCad
  *  - Asserts converted
  *  - Use compare functions/structures for std::partition and std::nth_element
+ *  - SAH costs of the buckets computed with two linear sweeps
+ *  - Nodes of SPLIT_* builds taken from a preallocated arena and big subtrees
+ *    built as OpenMP tasks
+ *  - Single rays traverse a 4-wide BVH collapsed from the binary one, with
+ *    the child boxes tested at once with SSE
  *
  * The original source code has the following licence:
  *
@@ -80,6 +85,18 @@
 #include <stdio.h>
 #endif
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if defined( __SSE__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 )
+#define CBVH_USE_SSE
+#include <xmmintrin.h>
+#endif
+
+/// Subtrees with more primitives than this are built as separate tasks
+#define PARALLEL_BUILD_MIN_PRIMITIVES 4096
+
 // BVHAccel Local Declarations
 struct BVHPrimitiveInfo
 {
@@ -236,6 +253,8 @@ CBVH_PBRT::CBVH_PBRT( const CGENERICCONTAINER &aObjectContainer,
     m_maxPrimsInNode( std::min( 255, aMaxPrimsInNode ) ),
     m_splitMethod( aSplitMethod )
 {
+    m_qnodes = NULL;
+
     if( aObjectContainer.GetList().empty() )
     {
         m_nodes = NULL;
@@ -269,21 +288,47 @@ CBVH_PBRT::CBVH_PBRT( const CGENERICCONTAINER &aObjectContainer,
     // Build BVH tree for primitives using _primitiveInfo_
     int totalNodes = 0;
 
-    CONST_VECTOR_OBJECT orderedPrims;
-    orderedPrims.clear();
-    orderedPrims.reserve( m_primitives.size() );
-
-    BVHBuildNode *root;
+    BVHBuildNode *root = NULL;
+    BVHBuildNode *buildNodes = NULL;
 
     if( m_splitMethod == SPLIT_HLBVH )
+    {
+        CONST_VECTOR_OBJECT orderedPrims;
+        orderedPrims.clear();
+        orderedPrims.reserve( m_primitives.size() );
+
         root = HLBVHBuild( primitiveInfo, &totalNodes, orderedPrims);
+
+        wxASSERT( m_primitives.size() == orderedPrims.size() );
+
+        m_primitives.swap( orderedPrims );
+    }
     else
-        root = recursiveBuild( primitiveInfo, 0, m_primitives.size(),
-                               &totalNodes, orderedPrims);
+    {
+        // A binary tree with at least one primitive per leaf has no more than
+        // 2n - 1 nodes
+        buildNodes = static_cast<BVHBuildNode *>( malloc( sizeof( BVHBuildNode ) *
+                                                          ( 2 * primitiveInfo.size() - 1 ) ) );
+
+        std::atomic<int> builtNodes( 0 );
+
+        #pragma omp parallel
+        {
+            #pragma omp single
+            root = recursiveBuild( primitiveInfo, 0, m_primitives.size(),
+                                   buildNodes, &builtNodes );
+        }
+
+        totalNodes = builtNodes;
+
+        // The leafs refer to ranges of the partitioned _primitiveInfo_
+        CONST_VECTOR_OBJECT orderedPrims( m_primitives.size() );
 
-    wxASSERT( m_primitives.size() == orderedPrims.size() );
+        for( size_t i = 0; i < primitiveInfo.size(); ++i )
+            orderedPrims[i] = m_primitives[ primitiveInfo[i].primitiveNumber ];
 
-    m_primitives.swap( orderedPrims );
+        m_primitives.swap( orderedPrims );
+    }
 
     // Compute representation of depth-first traversal of BVH tree
     m_nodes = static_cast<LinearBVHNode *>( malloc( sizeof( LinearBVHNode ) *
@@ -304,8 +349,25 @@ CBVH_PBRT::CBVH_PBRT( const CGENERICCONTAINER &aObjectContainer,
 
     wxASSERT( offset == (unsigned int)totalNodes );
 
+    // The build nodes are no more needed once the tree is flattened
+    free( buildNodes );
+
+    // Collapse the binary tree to the 4-wide one, each 4-wide node takes the
+    // place of at least one interior binary node
+    const int maxQNodes = std::max( 1, totalNodes / 2 );
+
+    m_qnodes = static_cast<QBVHNode *>( malloc( sizeof( QBVHNode ) * maxQNodes ) );
+    m_addresses_pointer_to_mm_free.push_back( m_qnodes );
+
+    int totalQNodes = 0;
+
+    collapseBVHTree( 0, &totalQNodes );
+
+    wxASSERT( totalQNodes <= maxQNodes );
+
 #ifdef PRINT_STATISTICS_3D_VIEWER
     uint32_t treeBytes = totalNodes * sizeof( LinearBVHNode ) + sizeof( *this ) +
+                         totalQNodes * sizeof( QBVHNode ) +
                          m_primitives.size() * sizeof( m_primitives[0] ) +
                          m_addresses_pointer_to_mm_free.size() * sizeof( void * );
 
@@ -320,8 +382,8 @@ CBVH_PBRT::CBVH_PBRT( const CGENERICCONTAINER &aObjectContainer,
     case SPLIT_HLBVH:       printf( "using SPLIT_HLBVH\n" ); break;
     }
 
-    printf( "  BVH created with %d nodes (%.2f MB)\n",
-            totalNodes, float(treeBytes) / (1024.f * 1024.f) );
+    printf( "  BVH created with %d nodes, %d 4-wide nodes (%.2f MB)\n",
+            totalNodes, totalQNodes, float(treeBytes) / (1024.f * 1024.f) );
     printf( "////////////////////////////////////////////////////////////////////////////////\n\n" );
 #endif
 }
@@ -372,36 +434,44 @@ struct CompareToMid
 };
 
 
-struct CompareToBucket
+/**
+ * Function bucketIndex
+ * returns the SAH bucket of a centroid, both the bucketing and the partition
+ * of the primitives must use it so they agree on which side a primitive goes
+ * @param aScale is nBuckets / (extent of the centroid bounds along dim)
+ */
+static inline int bucketIndex( float aCentroid, float aMin, float aScale, int aNBuckets )
 {
-    CompareToBucket( int split, int num, int d, const CBBOX &b )
-        : centroidBounds(b)
-    { splitBucket = split; nBuckets = num; dim = d; }
+    int b = (int)( ( aCentroid - aMin ) * aScale );
 
-    bool operator()(const BVHPrimitiveInfo &p) const;
+    if( b >= aNBuckets )
+        b = aNBuckets - 1;
 
-    int splitBucket, nBuckets, dim;
+    wxASSERT( b >= 0 );
 
-    const CBBOX &centroidBounds;
-};
+    return b;
+}
 
 
-bool CompareToBucket::operator()( const BVHPrimitiveInfo &p ) const
+struct CompareToBucket
 {
-    const float centroid = p.centroid[dim];
-
-    int b = nBuckets *
-            // Computes the offset (0.0 - 1.0) for one axis
-            ( ( centroid - centroidBounds.Min()[dim] ) /
-              ( centroidBounds.Max()[dim] - centroidBounds.Min()[dim] ) );
-
-    if( b == nBuckets )
-        b = nBuckets - 1;
+    CompareToBucket( int split, int num, int d, const CBBOX &b )
+    {
+        splitBucket = split;
+        nBuckets = num;
+        dim = d;
+        minCentroid = b.Min()[d];
+        scale = num / ( b.Max()[d] - b.Min()[d] );
+    }
 
-    wxASSERT( (b >= 0) && (b < nBuckets) );
+    bool operator()( const BVHPrimitiveInfo &p ) const
+    {
+        return bucketIndex( p.centroid[dim], minCentroid, scale, nBuckets ) <= splitBucket;
+    }
 
-    return b <= splitBucket;
-}
+    int splitBucket, nBuckets, dim;
+    float minCentroid, scale;
+};
 
 
 struct HLBVH_SAH_Evaluator
@@ -445,8 +515,8 @@ struct BucketInfo
 BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primitiveInfo,
                                           int start,
                                           int end,
-                                          int *totalNodes,
-                                          CONST_VECTOR_OBJECT &orderedPrims )
+                                          BVHBuildNode *buildNodes,
+                                          std::atomic<int> *totalNodes )
 {
     wxASSERT( totalNodes != NULL );
     wxASSERT( start >= 0 );
@@ -456,11 +526,7 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
     wxASSERT( start <= (int)primitiveInfo.size() );
     wxASSERT( end   <= (int)primitiveInfo.size() );
 
-    (*totalNodes)++;
-
-    // !TODO: implement an memory Arena
-    BVHBuildNode *node = static_cast<BVHBuildNode *>( malloc( sizeof( BVHBuildNode ) ) );
-    m_addresses_pointer_to_mm_free.push_back( node );
+    BVHBuildNode *node = &buildNodes[ (*totalNodes)++ ];
 
     node->bounds.Reset();
     node->firstPrimOffset = 0;
@@ -481,237 +547,214 @@ BVHBuildNode *CBVH_PBRT::recursiveBuild ( std::vector<BVHPrimitiveInfo> &primiti
     if( nPrimitives == 1 )
     {
         // Create leaf _BVHBuildNode_
-        int firstPrimOffset = orderedPrims.size();
+        node->InitLeaf( start, nPrimitives, bounds );
 
-        for( int i = start; i < end; ++i )
-        {
-            int primitiveNr = primitiveInfo[i].primitiveNumber;
-            wxASSERT( primitiveNr < (int)m_primitives.size() );
-            orderedPrims.push_back( m_primitives[ primitiveNr ] );
-        }
-
-        node->InitLeaf( firstPrimOffset, nPrimitives, bounds );
+        return node;
     }
-    else
+
+    // Compute bound of primitive centroids, choose split dimension _dim_
+    CBBOX centroidBounds;
+    centroidBounds.Reset();
+
+    for( int i = start; i < end; ++i )
+        centroidBounds.Union( primitiveInfo[i].centroid );
+
+    const int dim = centroidBounds.MaxDimension();
+
+    // Partition primitives into two sets and build children
+    int mid = (start + end) / 2;
+
+    if( fabs( centroidBounds.Max()[dim] -
+              centroidBounds.Min()[dim] ) < (FLT_EPSILON + FLT_EPSILON) )
     {
-        // Compute bound of primitive centroids, choose split dimension _dim_
-        CBBOX centroidBounds;
-        centroidBounds.Reset();
+        // Create leaf _BVHBuildNode_
+        node->InitLeaf( start, nPrimitives, bounds );
 
-        for( int i = start; i < end; ++i )
-            centroidBounds.Union( primitiveInfo[i].centroid );
+        return node;
+    }
 
-        const int dim = centroidBounds.MaxDimension();
+    // Partition primitives based on _splitMethod_
+    switch( m_splitMethod )
+    {
+    case SPLIT_MIDDLE:
+    {
+        // Partition primitives through node's midpoint
+        float pmid = centroidBounds.GetCenter( dim );
 
-        // Partition primitives into two sets and build children
-        int mid = (start + end) / 2;
+        BVHPrimitiveInfo *midPtr = std::partition( &primitiveInfo[start],
+                                                   &primitiveInfo[end - 1] + 1,
+                                                   CompareToMid( dim, pmid ) );
+        mid = midPtr - &primitiveInfo[0];
 
-        if( fabs( centroidBounds.Max()[dim] -
-                  centroidBounds.Min()[dim] ) < (FLT_EPSILON + FLT_EPSILON) )
-        {
-            // Create leaf _BVHBuildNode_
-            const int firstPrimOffset = orderedPrims.size();
+        wxASSERT( (mid >= start) &&
+                  (mid <= end) );
 
-            for( int i = start; i < end; ++i )
-            {
-                int primitiveNr = primitiveInfo[i].primitiveNumber;
+        if( (mid != start) && (mid != end) )
+            // for lots of prims with large overlapping bounding boxes, this
+            // may fail to partition; in that case don't break and fall through
+            // to SPLIT_EQUAL_COUNTS
+            break;
+    }
 
-                wxASSERT( (primitiveNr >= 0) &&
-                          (primitiveNr < (int)m_primitives.size()) );
+    case SPLIT_EQUALCOUNTS:
+    {
+        // Partition primitives into equally-sized subsets
+        mid = (start + end) / 2;
 
-                const COBJECT *obj = static_cast<const COBJECT *>( m_primitives[ primitiveNr ] );
+        std::nth_element( &primitiveInfo[start],
+                          &primitiveInfo[mid],
+                          &primitiveInfo[end - 1] + 1,
+                          ComparePoints( dim ) );
 
-                wxASSERT( obj != NULL );
+        break;
+    }
 
-                orderedPrims.push_back( obj );
-            }
+    case SPLIT_SAH:
+    default:
+    {
+        // Partition primitives using approximate SAH
+        if( nPrimitives <= 2 )
+        {
+            // Partition primitives into equally-sized subsets
+            mid = (start + end) / 2;
 
-            node->InitLeaf( firstPrimOffset, nPrimitives, bounds );
+            std::nth_element( &primitiveInfo[start],
+                              &primitiveInfo[mid],
+                              &primitiveInfo[end - 1] + 1,
+                              ComparePoints( dim ) );
         }
         else
         {
-            // Partition primitives based on _splitMethod_
-            switch( m_splitMethod )
-            {
-            case SPLIT_MIDDLE:
+            // Allocate _BucketInfo_ for SAH partition buckets
+            const int nBuckets = 12;
+
+            BucketInfo buckets[nBuckets];
+
+            for( int i = 0; i < nBuckets; ++i )
             {
-                // Partition primitives through node's midpoint
-                float pmid = centroidBounds.GetCenter( dim );
-
-                BVHPrimitiveInfo *midPtr = std::partition( &primitiveInfo[start],
-                                                           &primitiveInfo[end - 1] + 1,
-                                                           CompareToMid( dim, pmid ) );
-                mid = midPtr - &primitiveInfo[0];
-
-                wxASSERT( (mid >= start) &&
-                          (mid <= end) );
-
-                if( (mid != start) && (mid != end) )
-                    // for lots of prims with large overlapping bounding boxes, this
-                    // may fail to partition; in that case don't break and fall through
-                    // to SPLIT_EQUAL_COUNTS
-                    break;
+                buckets[i].count = 0;
+                buckets[i].bounds.Reset();
             }
 
-            case SPLIT_EQUALCOUNTS:
-            {
-                // Partition primitives into equally-sized subsets
-                mid = (start + end) / 2;
+            // Initialize _BucketInfo_ for SAH partition buckets
+            const float minCentroid = centroidBounds.Min()[dim];
+            const float scale = nBuckets / ( centroidBounds.Max()[dim] - minCentroid );
 
-                std::nth_element( &primitiveInfo[start],
-                                  &primitiveInfo[mid],
-                                  &primitiveInfo[end - 1] + 1,
-                                  ComparePoints( dim ) );
+            for( int i = start; i < end; ++i )
+            {
+                const int b = bucketIndex( primitiveInfo[i].centroid[dim],
+                                           minCentroid, scale, nBuckets );
 
-                break;
+                buckets[b].count++;
+                buckets[b].bounds.Union( primitiveInfo[i].bounds );
             }
 
-            case SPLIT_SAH:
-            default:
-            {
-                // Partition primitives using approximate SAH
-                if( nPrimitives <= 2 )
-                {
-                    // Partition primitives into equally-sized subsets
-                    mid = (start + end) / 2;
+            // Compute costs for splitting after each bucket: sweep from the
+            // right to get the area and count of the right side, then from
+            // the left while evaluating the costs
+            float rightArea[nBuckets - 1];
+            int   rightCount[nBuckets - 1];
 
-                    std::nth_element( &primitiveInfo[start],
-                                      &primitiveInfo[mid],
-                                      &primitiveInfo[end - 1] + 1,
-                                      ComparePoints( dim ) );
-                }
-                else
-                {
-                    // Allocate _BucketInfo_ for SAH partition buckets
-                    const int nBuckets = 12;
+            CBBOX b1;
+            b1.Reset();
 
-                    BucketInfo buckets[nBuckets];
+            int count1 = 0;
 
-                    for( int i = 0; i < nBuckets; ++i )
-                    {
-                        buckets[i].count = 0;
-                        buckets[i].bounds.Reset();
-                    }
+            for( int i = nBuckets - 1; i > 0; --i )
+            {
+                if( buckets[i].count )
+                {
+                    count1 += buckets[i].count;
+                    b1.Union( buckets[i].bounds );
+                }
 
-                    // Initialize _BucketInfo_ for SAH partition buckets
-                    for( int i = start; i < end; ++i )
-                    {
-                        int b = nBuckets *
-                                centroidBounds.Offset( primitiveInfo[i].centroid )[dim];
+                rightArea[i - 1]  = count1 ? b1.SurfaceArea() : 0.0f;
+                rightCount[i - 1] = count1;
+            }
 
-                        if( b == nBuckets )
-                            b = nBuckets - 1;
+            CBBOX b0;
+            b0.Reset();
 
-                        wxASSERT( b >= 0 && b < nBuckets );
+            int count0 = 0;
 
-                        buckets[b].count++;
-                        buckets[b].bounds.Union( primitiveInfo[i].bounds );
-                    }
+            float minCost = FLT_MAX;
+            int minCostSplitBucket = 0;
 
-                    // Compute costs for splitting after each bucket
-                    float cost[nBuckets - 1];
+            const float invArea = 1.0f / bounds.SurfaceArea();
 
-                    for( int i = 0; i < (nBuckets - 1); ++i )
-                    {
-                        CBBOX b0, b1;
-
-                        b0.Reset();
-                        b1.Reset();
-
-                        int count0 = 0;
-                        int count1 = 0;
-
-                        for( int j = 0; j <= i; ++j )
-                        {
-                            if( buckets[j].count )
-                            {
-                                count0 += buckets[j].count;
-                                b0.Union( buckets[j].bounds );
-                            }
-                        }
-
-                        for( int j = i + 1; j < nBuckets; ++j )
-                        {
-                            if( buckets[j].count )
-                            {
-                                count1 += buckets[j].count;
-                                b1.Union( buckets[j].bounds );
-                            }
-                        }
-
-                        cost[i] = 1.0f +
-                                  ( count0 * b0.SurfaceArea() +
-                                    count1 * b1.SurfaceArea() ) /
-                                  bounds.SurfaceArea();
-                    }
+            for( int i = 0; i < (nBuckets - 1); ++i )
+            {
+                if( buckets[i].count )
+                {
+                    count0 += buckets[i].count;
+                    b0.Union( buckets[i].bounds );
+                }
 
-                    // Find bucket to split at that minimizes SAH metric
-                    float minCost = cost[0];
-                    int minCostSplitBucket = 0;
+                const float leftArea = count0 ? b0.SurfaceArea() : 0.0f;
 
-                    for( int i = 1; i < (nBuckets - 1); ++i )
-                    {
-                        if( cost[i] < minCost )
-                        {
-                            minCost = cost[i];
-                            minCostSplitBucket = i;
-                        }
-                    }
+                const float cost = 1.0f +
+                                   ( count0 * leftArea +
+                                     rightCount[i] * rightArea[i] ) * invArea;
 
-                    // Either create leaf or split primitives at selected SAH
-                    // bucket
-                    if( (nPrimitives > m_maxPrimsInNode) ||
-                        (minCost < (float)nPrimitives) )
-                    {
-                        BVHPrimitiveInfo *pmid =
-                            std::partition( &primitiveInfo[start],
-                                            &primitiveInfo[end - 1] + 1,
-                                            CompareToBucket( minCostSplitBucket,
-                                                             nBuckets,
-                                                             dim,
-                                                             centroidBounds ) );
-                        mid = pmid - &primitiveInfo[0];
-
-                        wxASSERT( (mid >= start) &&
-                                  (mid <= end) );
-                    }
-                    else
-                    {
-                        // Create leaf _BVHBuildNode_
-                        const int firstPrimOffset = orderedPrims.size();
+                // Find bucket to split at that minimizes SAH metric
+                if( cost < minCost )
+                {
+                    minCost = cost;
+                    minCostSplitBucket = i;
+                }
+            }
 
-                        for( int i = start; i < end; ++i )
-                        {
-                            const int primitiveNr = primitiveInfo[i].primitiveNumber;
+            // Either create leaf or split primitives at selected SAH
+            // bucket
+            if( (nPrimitives > m_maxPrimsInNode) ||
+                (minCost < (float)nPrimitives) )
+            {
+                BVHPrimitiveInfo *pmid =
+                    std::partition( &primitiveInfo[start],
+                                    &primitiveInfo[end - 1] + 1,
+                                    CompareToBucket( minCostSplitBucket,
+                                                     nBuckets,
+                                                     dim,
+                                                     centroidBounds ) );
+                mid = pmid - &primitiveInfo[0];
+
+                wxASSERT( (mid > start) &&
+                          (mid < end) );
+            }
+            else
+            {
+                // Create leaf _BVHBuildNode_
+                node->InitLeaf( start, nPrimitives, bounds );
 
-                            wxASSERT( primitiveNr < (int)m_primitives.size() );
+                return node;
+            }
+        }
+        break;
+    }
+    }
 
-                            orderedPrims.push_back( m_primitives[ primitiveNr ] );
-                        }
+    BVHBuildNode *children[2];
 
-                        node->InitLeaf( firstPrimOffset, nPrimitives, bounds );
+    if( nPrimitives > PARALLEL_BUILD_MIN_PRIMITIVES )
+    {
+        // The two halves are disjoint ranges of _primitiveInfo_ and the
+        // nodes are taken from the arena with an atomic counter, so they
+        // can be built at the same time
+        #pragma omp task shared( primitiveInfo, children )
+        children[0] = recursiveBuild( primitiveInfo, start, mid, buildNodes, totalNodes );
 
-                        return node;
-                    }
-                }
-                break;
-            }
-            }
+        children[1] = recursiveBuild( primitiveInfo, mid, end, buildNodes, totalNodes );
 
-            node->InitInterior( dim,
-                                recursiveBuild( primitiveInfo,
-                                                start,
-                                                mid,
-                                                totalNodes,
-                                                orderedPrims ),
-                                recursiveBuild( primitiveInfo,
-                                                mid,
-                                                end,
-                                                totalNodes,
-                                                orderedPrims) );
-        }
+        #pragma omp taskwait
+    }
+    else
+    {
+        children[0] = recursiveBuild( primitiveInfo, start, mid, buildNodes, totalNodes );
+        children[1] = recursiveBuild( primitiveInfo, mid,   end, buildNodes, totalNodes );
     }
 
+    node->InitInterior( dim, children[0], children[1] );
+
     return node;
 }
 
@@ -1124,67 +1167,243 @@ int CBVH_PBRT::flattenBVHTree( BVHBuildNode *node, uint32_t *offset )
 }
 
 
+int CBVH_PBRT::collapseBVHTree( int aNodeNum, int *aTotalQNodes )
+{
+    // Gather up to QBVH_WIDTH descendants, always opening the interior node
+    // with the biggest surface area as it is the one most likely to be hit
+    int gathered[QBVH_WIDTH];
+    int nGathered = 1;
+
+    gathered[0] = aNodeNum;
+
+    while( nGathered < QBVH_WIDTH )
+    {
+        int   biggest = -1;
+        float biggestArea = -1.0f;
+
+        for( int i = 0; i < nGathered; ++i )
+        {
+            const LinearBVHNode *node = &m_nodes[ gathered[i] ];
+
+            if( (node->nPrimitives == 0) && (node->bounds.SurfaceArea() > biggestArea) )
+            {
+                biggestArea = node->bounds.SurfaceArea();
+                biggest = i;
+            }
+        }
+
+        if( biggest < 0 )
+            break;
+
+        const int nodeNum = gathered[biggest];
+
+        gathered[biggest] = nodeNum + 1;
+        gathered[nGathered++] = m_nodes[nodeNum].secondChildOffset;
+    }
+
+    const int myOffset = (*aTotalQNodes)++;
+
+    QBVHNode *qnode = &m_qnodes[myOffset];
+
+    qnode->nChildren = nGathered;
+
+    for( int i = 0; i < QBVH_WIDTH; ++i )
+    {
+        if( i < nGathered )
+        {
+            const LinearBVHNode *node = &m_nodes[ gathered[i] ];
+
+            for( int axis = 0; axis < 3; ++axis )
+            {
+                qnode->bmin[axis][i] = node->bounds.Min()[axis];
+                qnode->bmax[axis][i] = node->bounds.Max()[axis];
+            }
+
+            qnode->children[i] = ( node->nPrimitives > 0 ) ?
+                                 ~gathered[i] :
+                                 collapseBVHTree( gathered[i], aTotalQNodes );
+        }
+        else
+        {
+            // Empty slot, its box is never hit
+            for( int axis = 0; axis < 3; ++axis )
+            {
+                qnode->bmin[axis][i] =  FLT_MAX;
+                qnode->bmax[axis][i] = -FLT_MAX;
+            }
+
+            qnode->children[i] = ~0;
+        }
+    }
+
+    return myOffset;
+}
+
+
+/**
+ * Function intersectQBVHNode
+ * tests a ray against the (up to) four child boxes of a 4-wide node
+ * @param aNear is the index of the near planes of the boxes (0 is min, 1 is
+ * max) for each axis, as given by the sign of the ray direction
+ * @param aMaxDistance is the distance beyond which the boxes are ignored
+ * @param aOutTNear gets the entry distances of the child boxes
+ * @return the mask (bit i is child i) of the hit children
+ */
+static inline int intersectQBVHNode( const QBVHNode *aNode,
+                                     const RAY &aRay,
+                                     const unsigned int aNear[3],
+                                     float aMaxDistance,
+                                     float aOutTNear[QBVH_WIDTH] )
+{
+    const float (*planes[2])[QBVH_WIDTH] = { aNode->bmin, aNode->bmax };
+
+#ifdef CBVH_USE_SSE
+    __m128 tNear = _mm_setzero_ps();
+    __m128 tFar  = _mm_set1_ps( aMaxDistance );
+
+    for( int axis = 0; axis < 3; ++axis )
+    {
+        const __m128 origin = _mm_set1_ps( aRay.m_Origin[axis] );
+        const __m128 invDir = _mm_set1_ps( aRay.m_InvDir[axis] );
+
+        const __m128 tAxisNear = _mm_mul_ps( _mm_sub_ps( _mm_loadu_ps(
+                                    planes[aNear[axis]][axis] ), origin ), invDir );
+        const __m128 tAxisFar  = _mm_mul_ps( _mm_sub_ps( _mm_loadu_ps(
+                                    planes[1 - aNear[axis]][axis] ), origin ), invDir );
+
+        tNear = _mm_max_ps( tAxisNear, tNear );
+        tFar  = _mm_min_ps( tAxisFar,  tFar );
+    }
+
+    _mm_storeu_ps( aOutTNear, tNear );
+
+    return _mm_movemask_ps( _mm_cmple_ps( tNear, tFar ) );
+#else
+    int mask = 0;
+
+    for( int i = 0; i < QBVH_WIDTH; ++i )
+    {
+        float tNear = 0.0f;
+        float tFar  = aMaxDistance;
+
+        for( int axis = 0; axis < 3; ++axis )
+        {
+            const float tAxisNear = ( planes[aNear[axis]][axis][i] - aRay.m_Origin[axis] ) *
+                                    aRay.m_InvDir[axis];
+            const float tAxisFar  = ( planes[1 - aNear[axis]][axis][i] - aRay.m_Origin[axis] ) *
+                                    aRay.m_InvDir[axis];
+
+            tNear = tAxisNear > tNear ? tAxisNear : tNear;
+            tFar  = tAxisFar  < tFar  ? tAxisFar  : tFar;
+        }
+
+        aOutTNear[i] = tNear;
+
+        if( tNear <= tFar )
+            mask |= 1 << i;
+    }
+
+    return mask;
+#endif
+}
+
+
 #define MAX_TODOS 64
 
+/// A 4-wide node pushes up to 3 more nodes than it pops
+#define MAX_QBVH_TODOS ( 3 * MAX_TODOS )
+
+struct QBVHStackNode
+{
+    int   child;    ///< as QBVHNode::children
+    float tNear;    ///< entry distance of its box
+};
+
+
+/**
+ * Function pushQBVHChildren
+ * pushes the hit children of a 4-wide node so the nearest is on top
+ */
+static inline void pushQBVHChildren( const QBVHNode *aNode,
+                                     int aMask,
+                                     const float aTNear[QBVH_WIDTH],
+                                     QBVHStackNode *aTodo,
+                                     int &aTodoOffset )
+{
+    const int first = aTodoOffset;
+
+    for( int i = 0; i < aNode->nChildren; ++i )
+    {
+        if( !( aMask & (1 << i) ) )
+            continue;
+
+        // Insertion sort by decreasing distance
+        int j = aTodoOffset++;
+
+        while( (j > first) && (aTodo[j - 1].tNear < aTNear[i]) )
+        {
+            aTodo[j] = aTodo[j - 1];
+            --j;
+        }
+
+        aTodo[j].child = aNode->children[i];
+        aTodo[j].tNear = aTNear[i];
+    }
+}
+
 bool CBVH_PBRT::Intersect( const RAY &aRay, HITINFO &aHitInfo ) const
 {
-    if( !m_nodes )
+    if( !m_qnodes )
         return false;
 
     bool hit = false;
 
-    // Follow ray through BVH nodes to find primitive intersections
-    int todoOffset = 0, nodeNum = 0;
-    int todo[MAX_TODOS];
+    // Follow ray through the 4-wide BVH nodes to find primitive intersections
+    int todoOffset = 0;
+    QBVHStackNode todo[MAX_QBVH_TODOS];
 
-    while( true )
-    {
-        const LinearBVHNode *node = &m_nodes[nodeNum];
+    todo[todoOffset].child = 0;
+    todo[todoOffset++].tNear = 0.0f;
 
-        wxASSERT( todoOffset < MAX_TODOS );
+    float tNear[QBVH_WIDTH];
 
-        // Check ray against BVH node
-        float hitBox = 0.0f;
+    while( todoOffset > 0 )
+    {
+        const QBVHStackNode &current = todo[--todoOffset];
 
-        const bool hitted = node->bounds.Intersect( aRay, &hitBox );
+        // Skip the boxes behind the nearest hit found after they were pushed
+        if( current.tNear >= aHitInfo.m_tHit )
+            continue;
 
-        if( hitted && (hitBox < aHitInfo.m_tHit) )
+        const int child = current.child;
+
+        if( child < 0 )
         {
-            if( node->nPrimitives > 0 )
+            // Intersect ray with primitives in leaf BVH node
+            const int nodeNum = ~child;
+            const LinearBVHNode *node = &m_nodes[nodeNum];
+
+            for( int i = 0; i < node->nPrimitives; ++i )
             {
-                // Intersect ray with primitives in leaf BVH node
-                for( int i = 0; i < node->nPrimitives; ++i )
+                if( m_primitives[node->primitivesOffset + i]->Intersect( aRay,
+                                                                         aHitInfo ) )
                 {
-                    if( m_primitives[node->primitivesOffset + i]->Intersect( aRay,
-                                                                             aHitInfo ) )
-                    {
-                        aHitInfo.m_acc_node_info = nodeNum;
-                        hit = true;
-                    }
+                    aHitInfo.m_acc_node_info = nodeNum;
+                    hit = true;
                 }
             }
-            else
-            {
-                // Put far BVH node on _todo_ stack, advance to near node
-                if( aRay.m_dirIsNeg[node->axis] )
-                {
-                    todo[todoOffset++] = nodeNum + 1;
-                    nodeNum = node->secondChildOffset;
-                }
-                else
-                {
-                    todo[todoOffset++] = node->secondChildOffset;
-                    nodeNum = nodeNum + 1;
-                }
 
-                continue;
-            }
+            continue;
         }
 
-        if( todoOffset == 0 )
-            break;
+        const QBVHNode *node = &m_qnodes[child];
 
-        nodeNum = todo[--todoOffset];
+        const int mask = intersectQBVHNode( node, aRay, aRay.m_dirIsNeg,
+                                            aHitInfo.m_tHit, tNear );
+
+        wxASSERT( (todoOffset + QBVH_WIDTH) <= MAX_QBVH_TODOS );
+
+        pushQBVHChildren( node, mask, tNear, todo, todoOffset );
     }
 
     return hit;
@@ -1260,60 +1479,50 @@ bool CBVH_PBRT::Intersect( const RAY &aRay,
 
 bool CBVH_PBRT::IntersectP( const RAY &aRay, float aMaxDistance ) const
 {
-    if( !m_nodes )
+    if( !m_qnodes )
         return false;
 
-    // Follow ray through BVH nodes to find primitive intersections
-    int todoOffset = 0, nodeNum = 0;
-    int todo[MAX_TODOS];
-
-    while( true )
-    {
-        const LinearBVHNode *node = &m_nodes[nodeNum];
+    // Follow ray through the 4-wide BVH nodes to find primitive intersections
+    int todoOffset = 0;
+    QBVHStackNode todo[MAX_QBVH_TODOS];
 
-        wxASSERT( todoOffset < MAX_TODOS );
+    todo[todoOffset].child = 0;
+    todo[todoOffset++].tNear = 0.0f;
 
-        // Check ray against BVH node
-        float hitBox = 0.0f;
+    float tNear[QBVH_WIDTH];
 
-        const bool hitted = node->bounds.Intersect( aRay, &hitBox );
+    while( todoOffset > 0 )
+    {
+        const int child = todo[--todoOffset].child;
 
-        if( hitted && (hitBox < aMaxDistance) )
+        if( child < 0 )
         {
-            if( node->nPrimitives > 0 )
-            {
-                // Intersect ray with primitives in leaf BVH node
-                for( int i = 0; i < node->nPrimitives; ++i )
-                {
-                    const COBJECT *obj = m_primitives[node->primitivesOffset + i];
+            // Intersect ray with primitives in leaf BVH node
+            const LinearBVHNode *node = &m_nodes[~child];
 
-                    if( obj->GetMaterial()->GetCastShadows() )
-                        if( obj->IntersectP( aRay, aMaxDistance ) )
-                            return true;
-                }
-            }
-            else
+            for( int i = 0; i < node->nPrimitives; ++i )
             {
-                // Put far BVH node on _todo_ stack, advance to near node
-                if( aRay.m_dirIsNeg[node->axis] )
-                {
-                    todo[todoOffset++] = nodeNum + 1;
-                    nodeNum = node->secondChildOffset;
-                }
-                else
-                {
-                    todo[todoOffset++] = node->secondChildOffset;
-                    nodeNum = nodeNum + 1;
-                }
+                const COBJECT *obj = m_primitives[node->primitivesOffset + i];
 
-                continue;
+                if( obj->GetMaterial()->GetCastShadows() )
+                    if( obj->IntersectP( aRay, aMaxDistance ) )
+                        return true;
             }
+
+            continue;
         }
 
-        if( todoOffset == 0 )
-            break;
+        const QBVHNode *node = &m_qnodes[child];
 
-        nodeNum = todo[--todoOffset];
+        const int mask = intersectQBVHNode( node, aRay, aRay.m_dirIsNeg,
+                                            aMaxDistance, tNear );
+
+        wxASSERT( (todoOffset + QBVH_WIDTH) <= MAX_QBVH_TODOS );
+
+        // Any hit ends the search, so the order does not matter
+        for( int i = 0; i < node->nChildren; ++i )
+            if( mask & (1 << i) )
+                todo[todoOffset++].child = node->children[i];
     }
 
     return false;
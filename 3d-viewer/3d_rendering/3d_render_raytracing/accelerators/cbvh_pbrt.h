@@ -71,6 +71,7 @@
 #define _CBVH_PBRT_H_
 
 #include "caccelerator.h"
+#include <atomic>
 #include <list>
 #include <stdint.h>
 
@@ -98,6 +99,30 @@ struct LinearBVHNode
 };
 
 
+/// Number of children of the nodes of the 4-wide BVH
+#define QBVH_WIDTH 4
+
+/**
+ * The 4-wide BVH is collapsed from the binary one: each node holds the bounds
+ * of its (up to) four children in structure of arrays layout, so a ray is
+ * tested against all of them at once.
+ */
+struct QBVHNode
+{
+    // 96 bytes
+    float bmin[3][QBVH_WIDTH];  ///< [axis][child], empty slots have min > max
+    float bmax[3][QBVH_WIDTH];
+
+    // 16 bytes
+    int   children[QBVH_WIDTH]; ///< >= 0 interior: index of the QBVHNode
+                                ///< < 0 leaf: ~index of the leaf LinearBVHNode
+
+    // 16 bytes
+    int   nChildren;
+    int   pad[3];               ///< ensure 128 byte total size
+};
+
+
 enum SPLITMETHOD
 {
     SPLIT_MIDDLE,
@@ -125,11 +150,19 @@ public:
 
 private:
 
+    /**
+     * Function recursiveBuild
+     * builds the tree of the primitives [start, end) of primitiveInfo.  The
+     * primitives are partitioned in place, so the leafs refer to ranges of
+     * primitiveInfo.  The nodes are taken from buildNodes, which must have
+     * room for 2 * primitiveInfo.size() - 1 nodes, and the big subtrees are
+     * built as parallel tasks.
+     */
     BVHBuildNode *recursiveBuild( std::vector<BVHPrimitiveInfo> &primitiveInfo,
                                   int start,
                                   int end,
-                                  int *totalNodes,
-                                  CONST_VECTOR_OBJECT &orderedPrims );
+                                  BVHBuildNode *buildNodes,
+                                  std::atomic<int> *totalNodes );
 
     BVHBuildNode *HLBVHBuild( const std::vector<BVHPrimitiveInfo> &primitiveInfo,
                               int *totalNodes,
@@ -153,11 +186,20 @@ private:
     int flattenBVHTree( BVHBuildNode *node,
                         uint32_t *offset );
 
+    /**
+     * Function collapseBVHTree
+     * creates the 4-wide node of the binary subtree aNodeNum of m_nodes, by
+     * pulling up the children of its biggest interior descendants
+     * @return the index of the created node in m_qnodes
+     */
+    int collapseBVHTree( int aNodeNum, int *aTotalQNodes );
+
     // BVH Private Data
     const int           m_maxPrimsInNode;
     SPLITMETHOD         m_splitMethod;
     CONST_VECTOR_OBJECT m_primitives;
     LinearBVHNode       *m_nodes;
+    QBVHNode            *m_qnodes;
 
     std::list<void *> m_addresses_pointer_to_mm_free;
 
@@ -58,6 +58,22 @@ public:
         }
     }
 
+    /**
+     * Function Splice
+     * moves all the objects of aContainer to the end of this one, without
+     * copying them. It allows to fill separate containers concurrently and
+     * gather them afterwards.
+     */
+    void Splice( CGENERICCONTAINER &aContainer )
+    {
+        if( !aContainer.m_objects.empty() )
+        {
+            m_objects.splice( m_objects.end(), aContainer.m_objects );
+            m_bbox.Union( aContainer.m_bbox );
+            aContainer.m_bbox.Reset();
+        }
+    }
+
     void Clear();
 
     const LIST_OBJECT &GetList() const { return m_objects; }
@@ -57,6 +57,21 @@ public:
         }
     }
 
+    /**
+     * Function Splice
+     * moves all the objects of aContainer to the end of this one, without
+     * copying them
+     */
+    void Splice( CGENERICCONTAINER2D &aContainer )
+    {
+        if( !aContainer.m_objects.empty() )
+        {
+            m_objects.splice( m_objects.end(), aContainer.m_objects );
+            m_bbox.Union( aContainer.m_bbox );
+            aContainer.m_bbox.Reset();
+        }
+    }
+
     void Clear();
 
     const LIST_OBJECT2D &GetList() const { return m_objects; }
@@ -47,6 +47,7 @@
 
 #include <base_units.h>
 #include <profile.h>        // To use GetRunningMicroSecs or an other profiling utility
+#include <set>
 
 /**
   * Scale convertion from 3d model units to pcb units
@@ -431,342 +432,67 @@ void C3D_RENDER_RAYTRACING::reload( REPORTER *aStatusTextReporter )
     }
 
 
-    // Add layers maps (except B_Mask and F_Mask)
+    // Add layers maps and the solder mask layers
+    // Each layer is converted by a separate task into its own containers,
+    // which are then moved to the scene in the layer order
     // /////////////////////////////////////////////////////////////////////////
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
     printf("Add layers maps...\n");
 #endif
 
+    std::vector< MAP_CONTAINER_2D::const_iterator > layers;
+
     for( MAP_CONTAINER_2D::const_iterator ii = m_settings.GetMapLayers().begin();
          ii != m_settings.GetMapLayers().end();
          ++ii )
     {
         PCB_LAYER_ID layer_id = static_cast<PCB_LAYER_ID>(ii->first);
 
-        // Mask kayers are not processed here because they are a special case
-        if( (layer_id == B_Mask) || (layer_id == F_Mask) )
-            continue;
-
-        CMATERIAL *materialLayer = &m_materials.m_SilkS;
-        SFVEC3F layerColor = SFVEC3F( 0.0f, 0.0f, 0.0f );
-
-        switch( layer_id )
-        {
-            case B_Adhes:
-            case F_Adhes:
-            break;
-
-            case B_Paste:
-            case F_Paste:
-                materialLayer = &m_materials.m_Paste;
-
-                if( m_settings.GetFlag( FL_USE_REALISTIC_MODE ) )
-                    layerColor = m_settings.m_SolderPasteColor;
-                else
-                    layerColor = m_settings.GetLayerColor( layer_id );
-            break;
-
-            case B_SilkS:
-            case F_SilkS:
-                materialLayer = &m_materials.m_SilkS;
-
-                if( m_settings.GetFlag( FL_USE_REALISTIC_MODE ) )
-                    layerColor = m_settings.m_SilkScreenColor;
-                else
-                    layerColor = m_settings.GetLayerColor( layer_id );
-            break;
-
-            case Dwgs_User:
-            case Cmts_User:
-            case Eco1_User:
-            case Eco2_User:
-            case Edge_Cuts:
-            case Margin:
-            break;
-
-            case B_CrtYd:
-            case F_CrtYd:
-            break;
-
-            case B_Fab:
-            case F_Fab:
-            break;
-
-            default:
-                materialLayer = &m_materials.m_Copper;
-
-                if( m_settings.GetFlag( FL_USE_REALISTIC_MODE ) )
-                    layerColor = m_settings.m_CopperColor;
-                else
-                    layerColor = m_settings.GetLayerColor( layer_id );
-            break;
-        }
-
-        const CBVHCONTAINER2D *container2d = static_cast<const CBVHCONTAINER2D *>(ii->second);
-        const LIST_OBJECT2D &listObject2d = container2d->GetList();
-
-        for( LIST_OBJECT2D::const_iterator itemOnLayer = listObject2d.begin();
-             itemOnLayer != listObject2d.end();
-             ++itemOnLayer )
-        {
-            const COBJECT2D *object2d_A = static_cast<const COBJECT2D *>(*itemOnLayer);
-
-            // not yet used / implemented (can be used in future to clip the objects in the board borders
-            COBJECT2D *object2d_C = CSGITEM_FULL;
-
-            std::vector<const COBJECT2D *> *object2d_B = CSGITEM_EMPTY;
-
-            if( true )  // previously, was a option, now holes are always drawn in zones
-            {
-                object2d_B = new std::vector<const COBJECT2D *>();
-
-                // Check if there are any layerhole that intersects this object
-                // Eg: a segment is cutted by a via hole or THT hole.
-                // /////////////////////////////////////////////////////////////
-                const MAP_CONTAINER_2D &layerHolesMap = m_settings.GetMapLayersHoles();
-
-                if( layerHolesMap.find(layer_id) != layerHolesMap.end() )
-                {
-                    MAP_CONTAINER_2D::const_iterator ii_hole = layerHolesMap.find(layer_id);
-
-                    const CBVHCONTAINER2D *containerLayerHoles2d =
-                            static_cast<const CBVHCONTAINER2D *>(ii_hole->second);
-
-
-                    CONST_LIST_OBJECT2D intersectionList;
-                    containerLayerHoles2d->GetListObjectsIntersects( object2d_A->GetBBox(),
-                                                                     intersectionList );
-
-                    if( !intersectionList.empty() )
-                    {
-                        for( CONST_LIST_OBJECT2D::const_iterator holeOnLayer =
-                             intersectionList.begin();
-                             holeOnLayer != intersectionList.end();
-                             ++holeOnLayer )
-                        {
-                            const COBJECT2D *hole2d = static_cast<const COBJECT2D *>(*holeOnLayer);
-
-                            //if( object2d_A->Intersects( hole2d->GetBBox() ) )
-                                //if( object2d_A->GetBBox().Intersects( hole2d->GetBBox() ) )
-                                    object2d_B->push_back( hole2d );
-                        }
-                    }
-                }
-
-                // Check if there are any THT that intersects this object
-                // /////////////////////////////////////////////////////////////
-                if( !m_settings.GetThroughHole_Outer().GetList().empty() )
-                {
-                    CONST_LIST_OBJECT2D intersectionList;
-
-                    m_settings.GetThroughHole_Outer().GetListObjectsIntersects(
-                                object2d_A->GetBBox(),
-                                intersectionList );
-
-                    if( !intersectionList.empty() )
-                    {
-                        for( CONST_LIST_OBJECT2D::const_iterator hole = intersectionList.begin();
-                             hole != intersectionList.end();
-                             ++hole )
-                        {
-                            const COBJECT2D *hole2d = static_cast<const COBJECT2D *>(*hole);
-
-                            //if( object2d_A->Intersects( hole2d->GetBBox() ) )
-                                //if( object2d_A->GetBBox().Intersects( hole2d->GetBBox() ) )
-                                    object2d_B->push_back( hole2d );
-                        }
-                    }
-                }
-
-                if( object2d_B->empty() )
-                {
-                    delete object2d_B;
-                    object2d_B = CSGITEM_EMPTY;
-                }
-            }
-
-            if( (object2d_B == CSGITEM_EMPTY) &&
-                (object2d_C == CSGITEM_FULL) )
-            {
-#if 0
-               create_3d_object_from( m_object_container,
-                                      object2d_A,
-                                      m_settings.GetLayerBottomZpos3DU( layer_id ),
-                                      m_settings.GetLayerTopZpos3DU( layer_id ),
-                                      materialLayer,
-                                      layerColor );
-#else
-                CLAYERITEM *objPtr = new CLAYERITEM( object2d_A,
-                                                     m_settings.GetLayerBottomZpos3DU( layer_id ),
-                                                     m_settings.GetLayerTopZpos3DU( layer_id ) );
-                objPtr->SetMaterial( materialLayer );
-                objPtr->SetColor( ConvertSRGBToLinear( layerColor ) );
-                m_object_container.Add( objPtr );
-#endif
-            }
-            else
-            {
-#if 1
-                CITEMLAYERCSG2D *itemCSG2d = new CITEMLAYERCSG2D( object2d_A,
-                                                                  object2d_B,
-                                                                  object2d_C,
-                                                                  object2d_A->GetBoardItem() );
-                m_containerWithObjectsToDelete.Add( itemCSG2d );
-
-                CLAYERITEM *objPtr = new CLAYERITEM( itemCSG2d,
-                                                     m_settings.GetLayerBottomZpos3DU( layer_id ),
-                                                     m_settings.GetLayerTopZpos3DU( layer_id ) );
-
-                objPtr->SetMaterial( materialLayer );
-                objPtr->SetColor( ConvertSRGBToLinear( layerColor ) );
-
-                m_object_container.Add( objPtr );
-#endif
-            }
-        }
-    }// for each layer on map
-
-
+        // Mask kayers are added after because they are a special case
+        if( (layer_id != B_Mask) && (layer_id != F_Mask) )
+            layers.push_back( ii );
+    }
 
-    // Add Mask layer
     // Solder mask layers are "negative" layers so the elements that we have
     // (in the container) should remove the board outline.
-    // We will check for all objects in the outline if it intersects any object
-    // in the layer container and also any hole.
-    // /////////////////////////////////////////////////////////////////////////
     if( m_settings.GetFlag( FL_SOLDERMASK ) &&
         (m_outlineBoard2dObjects->GetList().size() >= 1) )
     {
-        CMATERIAL *materialLayer = &m_materials.m_SolderMask;
-
         for( MAP_CONTAINER_2D::const_iterator ii = m_settings.GetMapLayers().begin();
              ii != m_settings.GetMapLayers().end();
              ++ii )
         {
             PCB_LAYER_ID layer_id = static_cast<PCB_LAYER_ID>(ii->first);
 
-            const CBVHCONTAINER2D *containerLayer2d =
-                    static_cast<const CBVHCONTAINER2D *>(ii->second);
-
-            // Only get the Solder mask layers
-            if( !((layer_id == B_Mask) || (layer_id == F_Mask)) )
-                continue;
-
-            SFVEC3F layerColor;
-            if( m_settings.GetFlag( FL_USE_REALISTIC_MODE ) )
-                layerColor = m_settings.m_SolderMaskColor;
-            else
-                layerColor = m_settings.GetLayerColor( layer_id );
-
-            const float zLayerMin = m_settings.GetLayerBottomZpos3DU( layer_id );
-            const float zLayerMax = m_settings.GetLayerTopZpos3DU( layer_id );
-
-            // Get the outline board objects
-            const LIST_OBJECT2D &listObjects = m_outlineBoard2dObjects->GetList();
-
-            for( LIST_OBJECT2D::const_iterator object2d_iterator = listObjects.begin();
-                 object2d_iterator != listObjects.end();
-                 ++object2d_iterator )
-            {
-                const COBJECT2D *object2d_A = static_cast<const COBJECT2D *>(*object2d_iterator);
-
-                std::vector<const COBJECT2D *> *object2d_B = new std::vector<const COBJECT2D *>();
-
-                // Check if there are any THT that intersects this outline object part
-                if( !m_settings.GetThroughHole_Outer().GetList().empty() )
-                {
-
-                    CONST_LIST_OBJECT2D intersectionList;
-
-                    m_settings.GetThroughHole_Outer().GetListObjectsIntersects(
-                                object2d_A->GetBBox(),
-                                intersectionList );
-
-                    if( !intersectionList.empty() )
-                    {
-                        for( CONST_LIST_OBJECT2D::const_iterator hole = intersectionList.begin();
-                             hole != intersectionList.end();
-                             ++hole )
-                        {
-                            const COBJECT2D *hole2d = static_cast<const COBJECT2D *>(*hole);
-
-                            if( object2d_A->Intersects( hole2d->GetBBox() ) )
-                            //if( object2d_A->GetBBox().Intersects( hole2d->GetBBox() ) )
-                                object2d_B->push_back( hole2d );
-                        }
-                    }
-                }
-
-                // Check if there are any objects in the layer to subtract with the
-                // corrent object
-                if( !containerLayer2d->GetList().empty() )
-                {
-                    CONST_LIST_OBJECT2D intersectionList;
-
-                    containerLayer2d->GetListObjectsIntersects( object2d_A->GetBBox(),
-                                                                intersectionList );
-
-                    if( !intersectionList.empty() )
-                    {
-                        for( CONST_LIST_OBJECT2D::const_iterator obj = intersectionList.begin();
-                             obj != intersectionList.end();
-                             ++obj )
-                        {
-                            const COBJECT2D *obj2d = static_cast<const COBJECT2D *>(*obj);
-
-                            //if( object2d_A->Intersects( obj2d->GetBBox() ) )
-                            //if( object2d_A->GetBBox().Intersects( obj2d->GetBBox() ) )
-                                object2d_B->push_back( obj2d );
-                        }
-                    }
-                }
-
-                if( object2d_B->empty() )
-                {
-                    delete object2d_B;
-                    object2d_B = CSGITEM_EMPTY;
-                }
-
-                if( object2d_B == CSGITEM_EMPTY )
-                {
-        #if 0
-                   create_3d_object_from( m_object_container,
-                                          object2d_A,
-                                          zLayerMin,
-                                          zLayerMax,
-                                          materialLayer,
-                                          layerColor );
-        #else
-                    CLAYERITEM *objPtr =  new CLAYERITEM( object2d_A,
-                                                          zLayerMin,
-                                                          zLayerMax );
+            if( (layer_id == B_Mask) || (layer_id == F_Mask) )
+                layers.push_back( ii );
+        }
+    }
 
-                    objPtr->SetMaterial( materialLayer );
-                    objPtr->SetColor( ConvertSRGBToLinear( layerColor ) );
+    std::vector< CCONTAINER > layersObjects( layers.size() );
+    std::vector< CCONTAINER2D > layersObjectsToDelete( layers.size() );
 
-                    m_object_container.Add( objPtr );
-        #endif
-                }
-                else
-                {
-                    CITEMLAYERCSG2D *itemCSG2d = new CITEMLAYERCSG2D( object2d_A,
-                                                                      object2d_B,
-                                                                      CSGITEM_FULL,
-                                                                      object2d_A->GetBoardItem() );
+    #pragma omp parallel for schedule(dynamic)
+    for( signed int iLayer = 0; iLayer < (int)layers.size(); iLayer++ )
+    {
+        const PCB_LAYER_ID layer_id = static_cast<PCB_LAYER_ID>(layers[iLayer]->first);
 
-                    m_containerWithObjectsToDelete.Add( itemCSG2d );
+        const CBVHCONTAINER2D *container2d =
+                static_cast<const CBVHCONTAINER2D *>(layers[iLayer]->second);
 
-                    CLAYERITEM *objPtr =  new CLAYERITEM( itemCSG2d,
-                                                          zLayerMin,
-                                                          zLayerMax );
-                    objPtr->SetMaterial( materialLayer );
-                    objPtr->SetColor( ConvertSRGBToLinear( layerColor ) );
+        if( (layer_id == B_Mask) || (layer_id == F_Mask) )
+            add_3D_solder_mask( layer_id, container2d,
+                                layersObjects[iLayer], layersObjectsToDelete[iLayer] );
+        else
+            add_3D_layer( layer_id, container2d,
+                          layersObjects[iLayer], layersObjectsToDelete[iLayer] );
+    }
 
-                    m_object_container.Add( objPtr );
-                }
-            }
-        }
+    for( unsigned int iLayer = 0; iLayer < layers.size(); iLayer++ )
+    {
+        m_object_container.Splice( layersObjects[iLayer] );
+        m_containerWithObjectsToDelete.Splice( layersObjectsToDelete[iLayer] );
     }
 
     add_3D_vias_and_pads_to_container();
@@ -908,9 +634,7 @@ void C3D_RENDER_RAYTRACING::reload( REPORTER *aStatusTextReporter )
     // Create an accelerator
     // /////////////////////////////////////////////////////////////////////////
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
     unsigned stats_startAcceleratorTime = GetRunningMicroSecs();
-#endif
 
     if( m_accelerator )
     {
@@ -921,9 +645,10 @@ void C3D_RENDER_RAYTRACING::reload( REPORTER *aStatusTextReporter )
     //m_accelerator = new CGRID( m_object_container );
     m_accelerator = new CBVH_PBRT( m_object_container );
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
     unsigned stats_endAcceleratorTime = GetRunningMicroSecs();
-#endif
+
+    m_stats_scene_build_time = stats_startAcceleratorTime - stats_startReloadTime;
+    m_stats_accelerator_time = stats_endAcceleratorTime - stats_startAcceleratorTime;
 
     setupMaterials();
 
@@ -967,6 +692,315 @@ void C3D_RENDER_RAYTRACING::reload( REPORTER *aStatusTextReporter )
 
 
 
+void C3D_RENDER_RAYTRACING::add_3D_layer( PCB_LAYER_ID aLayerId,
+                                          const CBVHCONTAINER2D *aLayerContainer2d,
+                                          CCONTAINER &aDstContainer,
+                                          CCONTAINER2D &aDstObjectsToDelete )
+{
+    CMATERIAL *materialLayer = &m_materials.m_SilkS;
+    SFVEC3F layerColor = SFVEC3F( 0.0f, 0.0f, 0.0f );
+
+    switch( aLayerId )
+    {
+        case B_Adhes:
+        case F_Adhes:
+        break;
+
+        case B_Paste:
+        case F_Paste:
+            materialLayer = &m_materials.m_Paste;
+
+            if( m_settings.GetFlag( FL_USE_REALISTIC_MODE ) )
+                layerColor = m_settings.m_SolderPasteColor;
+            else
+                layerColor = m_settings.GetLayerColor( aLayerId );
+        break;
+
+        case B_SilkS:
+        case F_SilkS:
+            materialLayer = &m_materials.m_SilkS;
+
+            if( m_settings.GetFlag( FL_USE_REALISTIC_MODE ) )
+                layerColor = m_settings.m_SilkScreenColor;
+            else
+                layerColor = m_settings.GetLayerColor( aLayerId );
+        break;
+
+        case Dwgs_User:
+        case Cmts_User:
+        case Eco1_User:
+        case Eco2_User:
+        case Edge_Cuts:
+        case Margin:
+        break;
+
+        case B_CrtYd:
+        case F_CrtYd:
+        break;
+
+        case B_Fab:
+        case F_Fab:
+        break;
+
+        default:
+            materialLayer = &m_materials.m_Copper;
+
+            if( m_settings.GetFlag( FL_USE_REALISTIC_MODE ) )
+                layerColor = m_settings.m_CopperColor;
+            else
+                layerColor = m_settings.GetLayerColor( aLayerId );
+        break;
+    }
+
+    const LIST_OBJECT2D &listObject2d = aLayerContainer2d->GetList();
+
+    for( LIST_OBJECT2D::const_iterator itemOnLayer = listObject2d.begin();
+         itemOnLayer != listObject2d.end();
+         ++itemOnLayer )
+    {
+        const COBJECT2D *object2d_A = static_cast<const COBJECT2D *>(*itemOnLayer);
+
+        // not yet used / implemented (can be used in future to clip the objects in the board borders
+        COBJECT2D *object2d_C = CSGITEM_FULL;
+
+        std::vector<const COBJECT2D *> *object2d_B = CSGITEM_EMPTY;
+
+        if( true )  // previously, was a option, now holes are always drawn in zones
+        {
+            object2d_B = new std::vector<const COBJECT2D *>();
+
+            // Check if there are any layerhole that intersects this object
+            // Eg: a segment is cutted by a via hole or THT hole.
+            // /////////////////////////////////////////////////////////////
+            const MAP_CONTAINER_2D &layerHolesMap = m_settings.GetMapLayersHoles();
+
+            if( layerHolesMap.find(aLayerId) != layerHolesMap.end() )
+            {
+                MAP_CONTAINER_2D::const_iterator ii_hole = layerHolesMap.find(aLayerId);
+
+                const CBVHCONTAINER2D *containerLayerHoles2d =
+                        static_cast<const CBVHCONTAINER2D *>(ii_hole->second);
+
+
+                CONST_LIST_OBJECT2D intersectionList;
+                containerLayerHoles2d->GetListObjectsIntersects( object2d_A->GetBBox(),
+                                                                 intersectionList );
+
+                if( !intersectionList.empty() )
+                {
+                    for( CONST_LIST_OBJECT2D::const_iterator holeOnLayer =
+                         intersectionList.begin();
+                         holeOnLayer != intersectionList.end();
+                         ++holeOnLayer )
+                    {
+                        const COBJECT2D *hole2d = static_cast<const COBJECT2D *>(*holeOnLayer);
+
+                        //if( object2d_A->Intersects( hole2d->GetBBox() ) )
+                            //if( object2d_A->GetBBox().Intersects( hole2d->GetBBox() ) )
+                                object2d_B->push_back( hole2d );
+                    }
+                }
+            }
+
+            // Check if there are any THT that intersects this object
+            // /////////////////////////////////////////////////////////////
+            if( !m_settings.GetThroughHole_Outer().GetList().empty() )
+            {
+                CONST_LIST_OBJECT2D intersectionList;
+
+                m_settings.GetThroughHole_Outer().GetListObjectsIntersects(
+                            object2d_A->GetBBox(),
+                            intersectionList );
+
+                if( !intersectionList.empty() )
+                {
+                    for( CONST_LIST_OBJECT2D::const_iterator hole = intersectionList.begin();
+                         hole != intersectionList.end();
+                         ++hole )
+                    {
+                        const COBJECT2D *hole2d = static_cast<const COBJECT2D *>(*hole);
+
+                        //if( object2d_A->Intersects( hole2d->GetBBox() ) )
+                            //if( object2d_A->GetBBox().Intersects( hole2d->GetBBox() ) )
+                                object2d_B->push_back( hole2d );
+                    }
+                }
+            }
+
+            if( object2d_B->empty() )
+            {
+                delete object2d_B;
+                object2d_B = CSGITEM_EMPTY;
+            }
+        }
+
+        if( (object2d_B == CSGITEM_EMPTY) &&
+            (object2d_C == CSGITEM_FULL) )
+        {
+#if 0
+           create_3d_object_from( aDstContainer,
+                                  object2d_A,
+                                  m_settings.GetLayerBottomZpos3DU( aLayerId ),
+                                  m_settings.GetLayerTopZpos3DU( aLayerId ),
+                                  materialLayer,
+                                  layerColor );
+#else
+            CLAYERITEM *objPtr = new CLAYERITEM( object2d_A,
+                                                 m_settings.GetLayerBottomZpos3DU( aLayerId ),
+                                                 m_settings.GetLayerTopZpos3DU( aLayerId ) );
+            objPtr->SetMaterial( materialLayer );
+            objPtr->SetColor( ConvertSRGBToLinear( layerColor ) );
+            aDstContainer.Add( objPtr );
+#endif
+        }
+        else
+        {
+#if 1
+            CITEMLAYERCSG2D *itemCSG2d = new CITEMLAYERCSG2D( object2d_A,
+                                                              object2d_B,
+                                                              object2d_C,
+                                                              object2d_A->GetBoardItem() );
+            aDstObjectsToDelete.Add( itemCSG2d );
+
+            CLAYERITEM *objPtr = new CLAYERITEM( itemCSG2d,
+                                                 m_settings.GetLayerBottomZpos3DU( aLayerId ),
+                                                 m_settings.GetLayerTopZpos3DU( aLayerId ) );
+
+            objPtr->SetMaterial( materialLayer );
+            objPtr->SetColor( ConvertSRGBToLinear( layerColor ) );
+
+            aDstContainer.Add( objPtr );
+#endif
+        }
+    }
+}
+
+
+void C3D_RENDER_RAYTRACING::add_3D_solder_mask( PCB_LAYER_ID aLayerId,
+                                                const CBVHCONTAINER2D *aLayerContainer2d,
+                                                CCONTAINER &aDstContainer,
+                                                CCONTAINER2D &aDstObjectsToDelete )
+{
+    // We will check for all objects in the outline if it intersects any object
+    // in the layer container and also any hole.
+    CMATERIAL *materialLayer = &m_materials.m_SolderMask;
+
+    SFVEC3F layerColor;
+    if( m_settings.GetFlag( FL_USE_REALISTIC_MODE ) )
+        layerColor = m_settings.m_SolderMaskColor;
+    else
+        layerColor = m_settings.GetLayerColor( aLayerId );
+
+    const float zLayerMin = m_settings.GetLayerBottomZpos3DU( aLayerId );
+    const float zLayerMax = m_settings.GetLayerTopZpos3DU( aLayerId );
+
+    // Get the outline board objects
+    const LIST_OBJECT2D &listObjects = m_outlineBoard2dObjects->GetList();
+
+    for( LIST_OBJECT2D::const_iterator object2d_iterator = listObjects.begin();
+         object2d_iterator != listObjects.end();
+         ++object2d_iterator )
+    {
+        const COBJECT2D *object2d_A = static_cast<const COBJECT2D *>(*object2d_iterator);
+
+        std::vector<const COBJECT2D *> *object2d_B = new std::vector<const COBJECT2D *>();
+
+        // Check if there are any THT that intersects this outline object part
+        if( !m_settings.GetThroughHole_Outer().GetList().empty() )
+        {
+
+            CONST_LIST_OBJECT2D intersectionList;
+
+            m_settings.GetThroughHole_Outer().GetListObjectsIntersects(
+                        object2d_A->GetBBox(),
+                        intersectionList );
+
+            if( !intersectionList.empty() )
+            {
+                for( CONST_LIST_OBJECT2D::const_iterator hole = intersectionList.begin();
+                     hole != intersectionList.end();
+                     ++hole )
+                {
+                    const COBJECT2D *hole2d = static_cast<const COBJECT2D *>(*hole);
+
+                    if( object2d_A->Intersects( hole2d->GetBBox() ) )
+                    //if( object2d_A->GetBBox().Intersects( hole2d->GetBBox() ) )
+                        object2d_B->push_back( hole2d );
+                }
+            }
+        }
+
+        // Check if there are any objects in the layer to subtract with the
+        // corrent object
+        if( !aLayerContainer2d->GetList().empty() )
+        {
+            CONST_LIST_OBJECT2D intersectionList;
+
+            aLayerContainer2d->GetListObjectsIntersects( object2d_A->GetBBox(),
+                                                        intersectionList );
+
+            if( !intersectionList.empty() )
+            {
+                for( CONST_LIST_OBJECT2D::const_iterator obj = intersectionList.begin();
+                     obj != intersectionList.end();
+                     ++obj )
+                {
+                    const COBJECT2D *obj2d = static_cast<const COBJECT2D *>(*obj);
+
+                    //if( object2d_A->Intersects( obj2d->GetBBox() ) )
+                    //if( object2d_A->GetBBox().Intersects( obj2d->GetBBox() ) )
+                        object2d_B->push_back( obj2d );
+                }
+            }
+        }
+
+        if( object2d_B->empty() )
+        {
+            delete object2d_B;
+            object2d_B = CSGITEM_EMPTY;
+        }
+
+        if( object2d_B == CSGITEM_EMPTY )
+        {
+#if 0
+           create_3d_object_from( aDstContainer,
+                                  object2d_A,
+                                  zLayerMin,
+                                  zLayerMax,
+                                  materialLayer,
+                                  layerColor );
+#else
+            CLAYERITEM *objPtr =  new CLAYERITEM( object2d_A,
+                                                  zLayerMin,
+                                                  zLayerMax );
+
+            objPtr->SetMaterial( materialLayer );
+            objPtr->SetColor( ConvertSRGBToLinear( layerColor ) );
+
+            aDstContainer.Add( objPtr );
+#endif
+        }
+        else
+        {
+            CITEMLAYERCSG2D *itemCSG2d = new CITEMLAYERCSG2D( object2d_A,
+                                                              object2d_B,
+                                                              CSGITEM_FULL,
+                                                              object2d_A->GetBoardItem() );
+
+            aDstObjectsToDelete.Add( itemCSG2d );
+
+            CLAYERITEM *objPtr =  new CLAYERITEM( itemCSG2d,
+                                                  zLayerMin,
+                                                  zLayerMax );
+            objPtr->SetMaterial( materialLayer );
+            objPtr->SetColor( ConvertSRGBToLinear( layerColor ) );
+
+            aDstContainer.Add( objPtr );
+        }
+    }
+}
+
+
 // Based on draw3DViaHole from
 // 3d_draw_helper_functions.cpp
 void C3D_RENDER_RAYTRACING::insert3DViaHole( const VIA* aVia )
@@ -1199,6 +1233,47 @@ void C3D_RENDER_RAYTRACING::add_3D_vias_and_pads_to_container()
 
 void C3D_RENDER_RAYTRACING::load_3D_models()
 {
+    // Without a cache manager (offscreen render of a board without project),
+    // there are no models to load
+    if( !m_settings.Get3DCacheManager() )
+        return;
+
+    // Load the models of the displayed modules concurrently, before they are
+    // got from the cache one by one
+    std::vector< wxString > modelFiles;
+    std::set< wxString > modelNames;
+
+    for( const MODULE* module = m_settings.GetBoard()->m_Modules;
+         module;
+         module = module->Next() )
+    {
+        if( !m_settings.ShouldModuleBeDisplayed( (MODULE_ATTR_T)module->GetAttributes() ) )
+            continue;
+
+        for( const MODULE_3D_SETTINGS& model : module->Models() )
+        {
+            if( !model.m_Filename.empty() && modelNames.insert( model.m_Filename ).second )
+                modelFiles.push_back( model.m_Filename );
+        }
+    }
+
+    m_settings.Get3DCacheManager()->LoadModels( modelFiles );
+
+    // The materials of the models are created while going through the
+    // modules, as the materials map is not safe to be changed concurrently
+    struct MODEL_TO_ADD
+    {
+        MODEL_TO_ADD( const S3DMODEL *aModel, const MODEL_MATERIALS *aMaterials,
+                      const glm::mat4 &aModelMatrix ) :
+            m_Model( aModel ), m_Materials( aMaterials ), m_ModelMatrix( aModelMatrix ) {}
+
+        const S3DMODEL        *m_Model;
+        const MODEL_MATERIALS *m_Materials;
+        glm::mat4             m_ModelMatrix;
+    };
+
+    std::vector< MODEL_TO_ADD > models;
+
     // Go for all modules
     for( const MODULE* module = m_settings.GetBoard()->m_Modules;
          module;
@@ -1287,163 +1362,190 @@ void C3D_RENDER_RAYTRACING::load_3D_models()
                                                        sM->m_Scale.y,
                                                        sM->m_Scale.z ) );
 
-                    add_3D_models( modelPtr, modelMatrix );
+                    const MODEL_MATERIALS *materials = get_3D_model_materials( modelPtr );
+
+                    if( materials )
+                        models.push_back( MODEL_TO_ADD( modelPtr, materials, modelMatrix ) );
                 }
 
                 ++sM;
             }
         }
     }
+
+    // Convert the models to triangles concurrently, each one to its own
+    // container, and move them to the scene in the modules order
+    std::vector< CCONTAINER > modelsObjects( models.size() );
+
+    #pragma omp parallel for schedule(dynamic)
+    for( signed int iModel = 0; iModel < (int)models.size(); iModel++ )
+    {
+        add_3D_models( models[iModel].m_Model, models[iModel].m_ModelMatrix,
+                       *models[iModel].m_Materials, modelsObjects[iModel] );
+    }
+
+    for( unsigned int iModel = 0; iModel < models.size(); iModel++ )
+        m_object_container.Splice( modelsObjects[iModel] );
 }
 
 
-void C3D_RENDER_RAYTRACING::add_3D_models( const S3DMODEL *a3DModel,
-                                           const glm::mat4 &aModelMatrix )
+const MODEL_MATERIALS *C3D_RENDER_RAYTRACING::get_3D_model_materials( const S3DMODEL *a3DModel )
 {
-
     // Validate a3DModel pointers
     wxASSERT( a3DModel != NULL );
 
-    if( a3DModel == NULL )
-        return;
+    if( (a3DModel == NULL) ||
+        (a3DModel->m_Materials == NULL) || (a3DModel->m_MaterialsSize == 0) )
+        return NULL;
 
-    wxASSERT( a3DModel->m_Materials != NULL );
-    wxASSERT( a3DModel->m_Meshes != NULL );
-    wxASSERT( a3DModel->m_MaterialsSize > 0 );
-    wxASSERT( a3DModel->m_MeshesSize > 0 );
+    // Try find if the materials already exists in the map list
+    MAP_MODEL_MATERIALS::iterator materials = m_model_materials.find( a3DModel );
 
-    if( (a3DModel->m_Materials != NULL) && (a3DModel->m_Meshes != NULL) &&
-        (a3DModel->m_MaterialsSize > 0) && (a3DModel->m_MeshesSize > 0) )
+    if( materials != m_model_materials.end() )
     {
+        // Found it, so get the pointer
+        return &materials->second;
+    }
 
-        MODEL_MATERIALS *materialVector;
+    // Materials was not found in the map, so it will create a new for
+    // this model.
+    MODEL_MATERIALS *materialVector = &m_model_materials[a3DModel];
 
-        // Try find if the materials already exists in the map list
-        if( m_model_materials.find( a3DModel ) != m_model_materials.end() )
-        {
-            // Found it, so get the pointer
-            materialVector = &m_model_materials[a3DModel];
-        }
-        else
+    materialVector->resize( a3DModel->m_MaterialsSize );
+
+    for( unsigned int imat = 0;
+         imat < a3DModel->m_MaterialsSize;
+         ++imat )
+    {
+        if( m_settings.MaterialModeGet() == MATERIAL_MODE_NORMAL )
         {
-            // Materials was not found in the map, so it will create a new for
-            // this model.
+            const SMATERIAL &material = a3DModel->m_Materials[imat];
 
-            m_model_materials[a3DModel] = MODEL_MATERIALS();
-            materialVector = &m_model_materials[a3DModel];
+            // http://www.fooplot.com/#W3sidHlwZSI6MCwiZXEiOiJtaW4oc3FydCh4LTAuMzUpKjAuNDAtMC4wNSwxLjApIiwiY29sb3IiOiIjMDAwMDAwIn0seyJ0eXBlIjoxMDAwLCJ3aW5kb3ciOlsiMC4wNzA3NzM2NzMyMzY1OTAxMiIsIjEuNTY5NTcxNjI5MjI1NDY5OCIsIi0wLjI3NDYzNTMyMTc1OTkyOTMiLCIwLjY0NzcwMTg4MTkyNTUzNjIiXSwic2l6ZSI6WzY0NCwzOTRdfV0-
 
-            materialVector->resize( a3DModel->m_MaterialsSize );
+            float reflectionFactor = 0.0f;
 
-            for( unsigned int imat = 0;
-                 imat < a3DModel->m_MaterialsSize;
-                 ++imat )
+            if( (material.m_Shininess - 0.35f) > FLT_EPSILON )
             {
-                if( m_settings.MaterialModeGet() == MATERIAL_MODE_NORMAL )
-                {
-                    const SMATERIAL &material = a3DModel->m_Materials[imat];
+                reflectionFactor = glm::clamp( glm::sqrt( (material.m_Shininess - 0.35f) ) *
+                                               0.40f - 0.05f,
+                                               0.0f,
+                                               0.5f );
+            }
 
-                    // http://www.fooplot.com/#W3sidHlwZSI6MCwiZXEiOiJtaW4oc3FydCh4LTAuMzUpKjAuNDAtMC4wNSwxLjApIiwiY29sb3IiOiIjMDAwMDAwIn0seyJ0eXBlIjoxMDAwLCJ3aW5kb3ciOlsiMC4wNzA3NzM2NzMyMzY1OTAxMiIsIjEuNTY5NTcxNjI5MjI1NDY5OCIsIi0wLjI3NDYzNTMyMTc1OTkyOTMiLCIwLjY0NzcwMTg4MTkyNTUzNjIiXSwic2l6ZSI6WzY0NCwzOTRdfV0-
+            CBLINN_PHONG_MATERIAL &blinnMaterial = (*materialVector)[imat];
 
-                    float reflectionFactor = 0.0f;
+            SFVEC3F ambient;
 
-                    if( (material.m_Shininess - 0.35f) > FLT_EPSILON )
-                    {
-                        reflectionFactor = glm::clamp( glm::sqrt( (material.m_Shininess - 0.35f) ) *
-                                                       0.40f - 0.05f,
-                                                       0.0f,
-                                                       0.5f );
-                    }
+            if( m_settings.GetFlag( FL_RENDER_RAYTRACING_POST_PROCESSING ) )
+            {
+                // apply a gain to the (dark) ambient colors
 
-                    CBLINN_PHONG_MATERIAL &blinnMaterial = (*materialVector)[imat];
+                // http://www.fooplot.com/#W3sidHlwZSI6MCwiZXEiOiIoKHgrMC4yMCleKDEvMi4wMCkpLTAuMzUiLCJjb2xvciI6IiMwMDAwMDAifSx7InR5cGUiOjAsImVxIjoieCIsImNvbG9yIjoiIzAwMDAwMCJ9LHsidHlwZSI6MTAwMCwid2luZG93IjpbIi0xLjI0OTUwNTMzOTIyMzYyIiwiMS42Nzc4MzQ0MTg1NjcxODQzIiwiLTAuNDM1NTA0NjQyODEwOTMwMjYiLCIxLjM2NTkzNTIwODEzNzI1OCJdLCJzaXplIjpbNjQ5LDM5OV19XQ--
+                // ambient = glm::max( (glm::pow((material.m_Ambient + 0.20f), SFVEC3F(1.0f / 2.00f)) - SFVEC3F(0.35f)), material.m_Ambient );
 
-                    SFVEC3F ambient;
+                // http://www.fooplot.com/#W3sidHlwZSI6MCwiZXEiOiIoKHgrMC4yMCleKDEvMS41OCkpLTAuMzUiLCJjb2xvciI6IiMwMDAwMDAifSx7InR5cGUiOjAsImVxIjoieCIsImNvbG9yIjoiIzAwMDAwMCJ9LHsidHlwZSI6MTAwMCwid2luZG93IjpbIi0xLjI0OTUwNTMzOTIyMzYyIiwiMS42Nzc4MzQ0MTg1NjcxODQzIiwiLTAuNDM1NTA0NjQyODEwOTMwMjYiLCIxLjM2NTkzNTIwODEzNzI1OCJdLCJzaXplIjpbNjQ5LDM5OV19XQ--
+                //ambient = glm::max( (glm::pow((material.m_Ambient + 0.20f), SFVEC3F(1.0f / 1.58f)) - SFVEC3F(0.35f)), material.m_Ambient );
 
-                    if( m_settings.GetFlag( FL_RENDER_RAYTRACING_POST_PROCESSING ) )
-                    {
-                        // apply a gain to the (dark) ambient colors
+                // http://www.fooplot.com/#W3sidHlwZSI6MCwiZXEiOiIoKHgrMC4yMCleKDEvMS41NCkpLTAuMzQiLCJjb2xvciI6IiMwMDAwMDAifSx7InR5cGUiOjAsImVxIjoieCIsImNvbG9yIjoiIzAwMDAwMCJ9LHsidHlwZSI6MTAwMCwid2luZG93IjpbIi0yLjcyMTA5NTg0MjA1MDYwNSIsIjEuODUyODcyNTI5NDk3NTIyMyIsIi0xLjQyMTM3NjAxOTkyOTA4MDYiLCIxLjM5MzM3Mzc0NzE3NzQ2MTIiXSwic2l6ZSI6WzY0OSwzOTldfV0-
+                ambient = ConvertSRGBToLinear(
+                        glm::pow((material.m_Ambient + 0.30f), SFVEC3F(1.0f / 1.54f)) - SFVEC3F(0.34f) );
+            }
+            else
+            {
+                ambient = ConvertSRGBToLinear( material.m_Ambient );
+            }
 
-                        // http://www.fooplot.com/#W3sidHlwZSI6MCwiZXEiOiIoKHgrMC4yMCleKDEvMi4wMCkpLTAuMzUiLCJjb2xvciI6IiMwMDAwMDAifSx7InR5cGUiOjAsImVxIjoieCIsImNvbG9yIjoiIzAwMDAwMCJ9LHsidHlwZSI6MTAwMCwid2luZG93IjpbIi0xLjI0OTUwNTMzOTIyMzYyIiwiMS42Nzc4MzQ0MTg1NjcxODQzIiwiLTAuNDM1NTA0NjQyODEwOTMwMjYiLCIxLjM2NTkzNTIwODEzNzI1OCJdLCJzaXplIjpbNjQ5LDM5OV19XQ--
-                        // ambient = glm::max( (glm::pow((material.m_Ambient + 0.20f), SFVEC3F(1.0f / 2.00f)) - SFVEC3F(0.35f)), material.m_Ambient );
 
-                        // http://www.fooplot.com/#W3sidHlwZSI6MCwiZXEiOiIoKHgrMC4yMCleKDEvMS41OCkpLTAuMzUiLCJjb2xvciI6IiMwMDAwMDAifSx7InR5cGUiOjAsImVxIjoieCIsImNvbG9yIjoiIzAwMDAwMCJ9LHsidHlwZSI6MTAwMCwid2luZG93IjpbIi0xLjI0OTUwNTMzOTIyMzYyIiwiMS42Nzc4MzQ0MTg1NjcxODQzIiwiLTAuNDM1NTA0NjQyODEwOTMwMjYiLCIxLjM2NTkzNTIwODEzNzI1OCJdLCJzaXplIjpbNjQ5LDM5OV19XQ--
-                        //ambient = glm::max( (glm::pow((material.m_Ambient + 0.20f), SFVEC3F(1.0f / 1.58f)) - SFVEC3F(0.35f)), material.m_Ambient );
+            blinnMaterial = CBLINN_PHONG_MATERIAL(
+                                      ambient,
+                                      ConvertSRGBToLinear( material.m_Emissive ),
+                                      ConvertSRGBToLinear( material.m_Specular ),
+                                      material.m_Shininess * 180.0f,
+                                      material.m_Transparency,
+                                      reflectionFactor );
 
-                        // http://www.fooplot.com/#W3sidHlwZSI6MCwiZXEiOiIoKHgrMC4yMCleKDEvMS41NCkpLTAuMzQiLCJjb2xvciI6IiMwMDAwMDAifSx7InR5cGUiOjAsImVxIjoieCIsImNvbG9yIjoiIzAwMDAwMCJ9LHsidHlwZSI6MTAwMCwid2luZG93IjpbIi0yLjcyMTA5NTg0MjA1MDYwNSIsIjEuODUyODcyNTI5NDk3NTIyMyIsIi0xLjQyMTM3NjAxOTkyOTA4MDYiLCIxLjM5MzM3Mzc0NzE3NzQ2MTIiXSwic2l6ZSI6WzY0OSwzOTldfV0-
-                        ambient = ConvertSRGBToLinear(
-                                glm::pow((material.m_Ambient + 0.30f), SFVEC3F(1.0f / 1.54f)) - SFVEC3F(0.34f) );
-                    }
+            if( m_settings.GetFlag( FL_RENDER_RAYTRACING_PROCEDURAL_TEXTURES ) )
+            {
+                // Guess material type and apply a normal perturbator
+
+                if( ( RGBtoGray(material.m_Diffuse) < 0.3f ) &&
+                    ( material.m_Shininess < 0.36f ) &&
+                    ( material.m_Transparency == 0.0f ) &&
+                    ( (glm::abs( material.m_Diffuse.r - material.m_Diffuse.g ) < 0.15f) &&
+                      (glm::abs( material.m_Diffuse.b - material.m_Diffuse.g ) < 0.15f) &&
+                      (glm::abs( material.m_Diffuse.r - material.m_Diffuse.b ) < 0.15f) ) )
+                {
+                    // This may be a black plastic..
+
+                    if( material.m_Shininess < 0.26f )
+                        blinnMaterial.SetNormalPerturbator( &m_plastic_normal_perturbator );
                     else
+                        blinnMaterial.SetNormalPerturbator( &m_plastic_shine_normal_perturbator );
+                }
+                else
+                {
+                    if( ( RGBtoGray(material.m_Diffuse) > 0.3f ) &&
+                        ( material.m_Shininess < 0.30f ) &&
+                        ( material.m_Transparency == 0.0f ) &&
+                        ( (glm::abs( material.m_Diffuse.r - material.m_Diffuse.g ) > 0.25f) ||
+                          (glm::abs( material.m_Diffuse.b - material.m_Diffuse.g ) > 0.25f) ||
+                          (glm::abs( material.m_Diffuse.r - material.m_Diffuse.b ) > 0.25f) ) )
                     {
-                        ambient = ConvertSRGBToLinear( material.m_Ambient );
+                        // This may be a color plastic ...
+                        blinnMaterial.SetNormalPerturbator( &m_plastic_shine_normal_perturbator );
                     }
-
-
-                    blinnMaterial = CBLINN_PHONG_MATERIAL(
-                                              ambient,
-                                              ConvertSRGBToLinear( material.m_Emissive ),
-                                              ConvertSRGBToLinear( material.m_Specular ),
-                                              material.m_Shininess * 180.0f,
-                                              material.m_Transparency,
-                                              reflectionFactor );
-
-                    if( m_settings.GetFlag( FL_RENDER_RAYTRACING_PROCEDURAL_TEXTURES ) )
+                    else
                     {
-                        // Guess material type and apply a normal perturbator
-
-                        if( ( RGBtoGray(material.m_Diffuse) < 0.3f ) &&
-                            ( material.m_Shininess < 0.36f ) &&
+                        if( ( RGBtoGray(material.m_Diffuse) > 0.6f ) &&
+                            ( material.m_Shininess > 0.35f ) &&
                             ( material.m_Transparency == 0.0f ) &&
-                            ( (glm::abs( material.m_Diffuse.r - material.m_Diffuse.g ) < 0.15f) &&
-                              (glm::abs( material.m_Diffuse.b - material.m_Diffuse.g ) < 0.15f) &&
-                              (glm::abs( material.m_Diffuse.r - material.m_Diffuse.b ) < 0.15f) ) )
+                            ( (glm::abs( material.m_Diffuse.r - material.m_Diffuse.g ) < 0.40f) &&
+                              (glm::abs( material.m_Diffuse.b - material.m_Diffuse.g ) < 0.40f) &&
+                              (glm::abs( material.m_Diffuse.r - material.m_Diffuse.b ) < 0.40f) ) )
                         {
-                            // This may be a black plastic..
-
-                            if( material.m_Shininess < 0.26f )
-                                blinnMaterial.SetNormalPerturbator( &m_plastic_normal_perturbator );
-                            else
-                                blinnMaterial.SetNormalPerturbator( &m_plastic_shine_normal_perturbator );
-                        }
-                        else
-                        {
-                            if( ( RGBtoGray(material.m_Diffuse) > 0.3f ) &&
-                                ( material.m_Shininess < 0.30f ) &&
-                                ( material.m_Transparency == 0.0f ) &&
-                                ( (glm::abs( material.m_Diffuse.r - material.m_Diffuse.g ) > 0.25f) ||
-                                  (glm::abs( material.m_Diffuse.b - material.m_Diffuse.g ) > 0.25f) ||
-                                  (glm::abs( material.m_Diffuse.r - material.m_Diffuse.b ) > 0.25f) ) )
-                            {
-                                // This may be a color plastic ...
-                                blinnMaterial.SetNormalPerturbator( &m_plastic_shine_normal_perturbator );
-                            }
-                            else
-                            {
-                                if( ( RGBtoGray(material.m_Diffuse) > 0.6f ) &&
-                                    ( material.m_Shininess > 0.35f ) &&
-                                    ( material.m_Transparency == 0.0f ) &&
-                                    ( (glm::abs( material.m_Diffuse.r - material.m_Diffuse.g ) < 0.40f) &&
-                                      (glm::abs( material.m_Diffuse.b - material.m_Diffuse.g ) < 0.40f) &&
-                                      (glm::abs( material.m_Diffuse.r - material.m_Diffuse.b ) < 0.40f) ) )
-                                {
-                                    // This may be a brushed metal
-                                    blinnMaterial.SetNormalPerturbator( &m_brushed_metal_normal_perturbator );
-                                }
-                            }
+                            // This may be a brushed metal
+                            blinnMaterial.SetNormalPerturbator( &m_brushed_metal_normal_perturbator );
                         }
                     }
                 }
-                else
-                {
-                    (*materialVector)[imat] = CBLINN_PHONG_MATERIAL( SFVEC3F( 0.2f ),
-                                                                     SFVEC3F( 0.0f ),
-                                                                     SFVEC3F( 0.0f ),
-                                                                     0.0f,
-                                                                     0.0f,
-                                                                     0.0f );
-                }
             }
         }
+        else
+        {
+            (*materialVector)[imat] = CBLINN_PHONG_MATERIAL( SFVEC3F( 0.2f ),
+                                                             SFVEC3F( 0.0f ),
+                                                             SFVEC3F( 0.0f ),
+                                                             0.0f,
+                                                             0.0f,
+                                                             0.0f );
+        }
+    }
+
+    return materialVector;
+}
+
+
+void C3D_RENDER_RAYTRACING::add_3D_models( const S3DMODEL *a3DModel,
+                                           const glm::mat4 &aModelMatrix,
+                                           const MODEL_MATERIALS &aMaterials,
+                                           CCONTAINER &aDstContainer )
+{
+
+    // Validate a3DModel pointers
+    wxASSERT( a3DModel != NULL );
 
+    if( a3DModel == NULL )
+        return;
+
+    wxASSERT( a3DModel->m_Materials != NULL );
+    wxASSERT( a3DModel->m_Meshes != NULL );
+    wxASSERT( a3DModel->m_MaterialsSize > 0 );
+    wxASSERT( a3DModel->m_MeshesSize > 0 );
+
+    if( (a3DModel->m_Materials != NULL) && (a3DModel->m_Meshes != NULL) &&
+        (a3DModel->m_MaterialsSize > 0) && (a3DModel->m_MeshesSize > 0) )
+    {
         const glm::mat3 normalMatrix = glm::transpose( glm::inverse( glm::mat3( aModelMatrix ) ) );
 
         for( unsigned int mesh_i = 0;
@@ -1468,7 +1570,7 @@ void C3D_RENDER_RAYTRACING::add_3D_models( const S3DMODEL *a3DModel,
                 ((mesh.m_FaceIdxSize % 3) == 0) &&
                 (mesh.m_MaterialIdx < a3DModel->m_MaterialsSize) )
             {
-                const CBLINN_PHONG_MATERIAL &blinn_material = (*materialVector)[mesh.m_MaterialIdx];
+                const CBLINN_PHONG_MATERIAL &blinn_material = aMaterials[mesh.m_MaterialIdx];
 
                 // Add all face triangles
                 for( unsigned int faceIdx = 0;
@@ -1509,7 +1611,7 @@ void C3D_RENDER_RAYTRACING::add_3D_models( const S3DMODEL *a3DModel,
 
 
 
-                        m_object_container.Add( newTriangle );
+                        aDstContainer.Add( newTriangle );
                         newTriangle->SetMaterial( (const CMATERIAL *)&blinn_material );
 
                         if( mesh.m_Color == NULL )
@@ -37,6 +37,7 @@
 #include "3d_math.h"
 #include "../common_ogl/ogl_utils.h"
 #include <profile.h>        // To use GetRunningMicroSecs or an other profiling utility
+#include <wx/image.h>
 
 // This should be used in future for the function
 // convertLinearToSRGB
@@ -71,6 +72,8 @@ C3D_RENDER_RAYTRACING::C3D_RENDER_RAYTRACING( CINFO3D_VISU &aSettings ) :
     m_isPreview = false;
     m_rt_render_state = RT_RENDER_STATE_MAX; // Set to an initial invalid state
     m_stats_start_rendering_time = 0;
+    m_stats_scene_build_time = 0;
+    m_stats_accelerator_time = 0;
     m_nrBlocksRenderProgress = 0;
 }
 
@@ -165,6 +168,7 @@ bool C3D_RENDER_RAYTRACING::Redraw( bool aIsMoving, REPORTER *aStatusTextReporte
         // revert to preview mode the first time the Redraw is called
         m_oldWindowsSize = m_windowSize;
         initialize_block_positions();
+        opengl_init_pbo();
     }
 
     wxBusyCursor dummy;
@@ -191,6 +195,7 @@ bool C3D_RENDER_RAYTRACING::Redraw( bool aIsMoving, REPORTER *aStatusTextReporte
         requestRedraw = true;
 
         initialize_block_positions();
+        opengl_init_pbo();
     }
 
 
@@ -298,6 +303,132 @@ bool C3D_RENDER_RAYTRACING::Redraw( bool aIsMoving, REPORTER *aStatusTextReporte
 }
 
 
+bool C3D_RENDER_RAYTRACING::RenderToFile( const wxSize &aSize,
+                                          const wxString &aFileName,
+                                          RT_RENDER_TIMINGS *aTimings,
+                                          REPORTER *aStatusTextReporter )
+{
+    // The image must have room for at least one block of the fast preview mode
+    if( (aSize.x < (int)(RAYPACKET_DIM * 8)) || (aSize.y < (int)(RAYPACKET_DIM * 8)) )
+        return false;
+
+    RT_RENDER_TIMINGS timings;
+
+    timings.m_sceneBuild  = 0;
+    timings.m_accelerator = 0;
+    timings.m_tracing     = 0;
+    timings.m_postShading = 0;
+
+    if( m_reloadRequested || (m_accelerator == NULL) )
+    {
+        if( aStatusTextReporter )
+            aStatusTextReporter->Report( _( "Loading..." ) );
+
+        reload( aStatusTextReporter );
+
+        timings.m_sceneBuild  = m_stats_scene_build_time;
+        timings.m_accelerator = m_stats_accelerator_time;
+    }
+
+    // Render at the requested size, the canvas size is restored at the end
+    const wxSize oldWindowSize = m_windowSize;
+
+    m_windowSize = aSize;
+    m_settings.CameraGet().SetCurWindowSize( aSize );
+    initialize_block_positions();
+
+    // Render buffer, with the same RGBA layout of the PBO
+    GLubyte *renderBuffer = new GLubyte[m_realBufferSize.x * m_realBufferSize.y * 4];
+
+    m_rt_render_state = RT_RENDER_STATE_MAX;   // Start a new render
+
+    do
+    {
+        const bool isTracing = (m_rt_render_state == RT_RENDER_STATE_TRACING) ||
+                               (m_rt_render_state >= RT_RENDER_STATE_MAX);
+
+        const unsigned long int startTime = GetRunningMicroSecs();
+
+        render( renderBuffer, aStatusTextReporter );
+
+        const unsigned long int phaseTime = GetRunningMicroSecs() - startTime;
+
+        if( isTracing )
+            timings.m_tracing += phaseTime;
+        else
+            timings.m_postShading += phaseTime;
+    }
+    while( m_rt_render_state != RT_RENDER_STATE_FINISH );
+
+    // Copy the render to the image. The render buffer starts from the bottom
+    // of the window and it is centered on it, the border around it gets the
+    // background color.
+    // /////////////////////////////////////////////////////////////////////////
+    wxImage image( aSize.x, aSize.y );
+    unsigned char *imageData = image.GetData();
+
+    for( int y = 0; y < aSize.y; ++y )
+    {
+        const float posYfactor = (float)y / (float)aSize.y;
+
+        GLubyte bgPixel[4];
+
+        rt_final_color( bgPixel,
+                        m_BgColorTop_LinearRGB * SFVEC3F(posYfactor) +
+                        m_BgColorBot_LinearRGB * ( SFVEC3F(1.0f) - SFVEC3F(posYfactor) ),
+                        true );
+
+        const int yBuffer = y - (int)m_yoffset;
+        const bool isRowInBuffer = (yBuffer >= 0) && (yBuffer < (int)m_realBufferSize.y);
+
+        unsigned char *ptrImage = &imageData[ (aSize.y - 1 - y) * aSize.x * 3 ];
+
+        for( int x = 0; x < aSize.x; ++x )
+        {
+            const int xBuffer = x - (int)m_xoffset;
+
+            const GLubyte *ptrPixel = bgPixel;
+
+            if( isRowInBuffer && (xBuffer >= 0) && (xBuffer < (int)m_realBufferSize.x) )
+                ptrPixel = &renderBuffer[ (yBuffer * m_realBufferSize.x + xBuffer) * 4 ];
+
+            ptrImage[0] = ptrPixel[0];
+            ptrImage[1] = ptrPixel[1];
+            ptrImage[2] = ptrPixel[2];
+            ptrImage += 3;
+        }
+    }
+
+    delete[] renderBuffer;
+
+    const bool isSaved = image.SaveFile( aFileName, wxBITMAP_TYPE_PNG );
+
+    // Restore the canvas size and make it render again
+    m_windowSize = oldWindowSize;
+
+    if( (oldWindowSize.x > 0) && (oldWindowSize.y > 0) )
+    {
+        m_settings.CameraGet().SetCurWindowSize( oldWindowSize );
+        initialize_block_positions();
+    }
+
+    m_rt_render_state = RT_RENDER_STATE_MAX;
+
+    if( aStatusTextReporter )
+        aStatusTextReporter->Report(
+            wxString::Format( _( "Scene %.3f s, BVH %.3f s, tracing %.3f s, post-shading %.3f s" ),
+                              (double)timings.m_sceneBuild / 1e6,
+                              (double)timings.m_accelerator / 1e6,
+                              (double)timings.m_tracing / 1e6,
+                              (double)timings.m_postShading / 1e6 ) );
+
+    if( aTimings )
+        *aTimings = timings;
+
+    return isSaved;
+}
+
+
 void C3D_RENDER_RAYTRACING::render( GLubyte *ptrPBO , REPORTER *aStatusTextReporter )
 {
     if( (m_rt_render_state == RT_RENDER_STATE_FINISH) ||
@@ -753,7 +884,12 @@ void C3D_RENDER_RAYTRACING::rt_render_trace_block( GLubyte *ptrPBO ,
                       m_settings.GetFlag( FL_RENDER_RAYTRACING_SHADOWS ),
                       hitColor_X0Y0 );
 
-    if( m_settings.GetFlag( FL_RENDER_RAYTRACING_ANTI_ALIASING ) )
+    if( m_settings.GetFlag( FL_RENDER_RAYTRACING_ANTI_ALIASING ) &&
+        ( m_settings.SamplingModeGet() != SAMPLING_MODE_FIXED ) )
+    {
+        rt_trace_adaptive_packet( bgColor, blockPosI, hitColor_X0Y0 );
+    }
+    else if( m_settings.GetFlag( FL_RENDER_RAYTRACING_ANTI_ALIASING ) )
     {
         SFVEC3F hitColor_AA_X1Y1[RAYPACKET_RAYS_PER_PACKET];
 
@@ -915,6 +1051,154 @@ void C3D_RENDER_RAYTRACING::rt_render_trace_block( GLubyte *ptrPBO ,
 }
 
 
+/**
+ * Sampling parameters of the adaptive anti-aliasing modes, indexed by
+ * SAMPLING_MODE.  The error is the relative standard error of the mean of the
+ * samples of a pixel, measured on the square root of its luminance (close to
+ * the display levels) so the noise of the dark areas is not ignored.
+ */
+struct ADAPTIVE_SAMPLING_PARAMETERS
+{
+    unsigned int m_minSamples;  ///< samples traced before testing the error
+    unsigned int m_maxSamples;  ///< samples after which a tile is not refined anymore
+    float        m_maxError;    ///< error under which a tile has converged
+};
+
+static const ADAPTIVE_SAMPLING_PARAMETERS s_adaptiveSamplingParameters[] =
+{
+    {  5,  5, 0.0f   },     // SAMPLING_MODE_FIXED (not adaptive)
+    {  2,  6, 0.04f  },     // SAMPLING_MODE_ADAPTIVE_DRAFT
+    {  4, 16, 0.02f  },     // SAMPLING_MODE_ADAPTIVE_NORMAL
+    {  6, 32, 0.01f  }      // SAMPLING_MODE_ADAPTIVE_HIGH
+};
+
+
+/**
+ * @brief adaptiveSampleOffset - Sub pixel position of the sample aSample of a
+ * pixel.  It follows the R2 low discrepancy sequence so that whatever is the
+ * number of samples traced, they are evenly spread in the pixel.
+ * The small random displacement of each ray is kept inside the pixel.
+ */
+static SFVEC2F adaptiveSampleOffset( unsigned int aSample )
+{
+    const float a1 = 0.7548776662f;
+    const float a2 = 0.5698402910f;
+
+    const SFVEC2F r2 = glm::fract( SFVEC2F( 0.5f + a1 * (float)aSample,
+                                            0.5f + a2 * (float)aSample ) );
+
+    return SFVEC2F( DISP_FACTOR ) + r2 * ( 1.0f - 2.0f * DISP_FACTOR );
+}
+
+
+void C3D_RENDER_RAYTRACING::rt_trace_adaptive_packet( const SFVEC3F *aBgColorY,
+                                                      const SFVEC2I &aBlockPos,
+                                                      SFVEC3F *aInOutHitColor )
+{
+    const ADAPTIVE_SAMPLING_PARAMETERS &parameters =
+            s_adaptiveSamplingParameters[m_settings.SamplingModeGet()];
+
+    const bool is_testShadow = m_settings.GetFlag( FL_RENDER_RAYTRACING_SHADOWS );
+
+    // Time budget of the render, in microseconds (0 = no limit)
+    const float timeBudgetSeconds = m_settings.SamplingTimeBudgetGet();
+    const unsigned long int timeBudget = ( timeBudgetSeconds > 0.0f ) ?
+            (unsigned long int)( timeBudgetSeconds * 1e6f ) : 0;
+
+    // Statistics of the samples of each pixel, starting with the one already
+    // traced on aInOutHitColor
+    SFVEC3F sumColor[RAYPACKET_RAYS_PER_PACKET];
+    float   sumLevel[RAYPACKET_RAYS_PER_PACKET];
+    float   sumLevelSq[RAYPACKET_RAYS_PER_PACKET];
+
+    for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
+    {
+        const float level = sqrtf( glm::max( RGBtoGray( aInOutHitColor[i] ), 0.0f ) );
+
+        sumColor[i]   = aInOutHitColor[i];
+        sumLevel[i]   = level;
+        sumLevelSq[i] = level * level;
+    }
+
+    HITINFO_PACKET hitPacket[RAYPACKET_RAYS_PER_PACKET];
+    SFVEC3F sampleColor[RAYPACKET_RAYS_PER_PACKET];
+
+    unsigned int nSamples = 1;
+
+    while( nSamples < parameters.m_maxSamples )
+    {
+        RAYPACKET samplePacket( m_settings.CameraGet(),
+                                (SFVEC2F)aBlockPos + adaptiveSampleOffset( nSamples ),
+                                SFVEC2F(DISP_FACTOR, DISP_FACTOR) // Displacement random factor
+                                );
+
+        HITINFO_PACKET_init( hitPacket );
+
+        if( m_accelerator->Intersect( samplePacket, hitPacket ) )
+        {
+            rt_shades_packet( aBgColorY,
+                              samplePacket.m_ray,
+                              hitPacket,
+                              is_testShadow,
+                              sampleColor );
+        }
+        else
+        {
+            // Missed all the package
+            for( unsigned int y = 0, i = 0; y < RAYPACKET_DIM; ++y )
+                for( unsigned int x = 0; x < RAYPACKET_DIM; ++x, ++i )
+                    sampleColor[i] = aBgColorY[y];
+        }
+
+        for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
+        {
+            const float level = sqrtf( glm::max( RGBtoGray( sampleColor[i] ), 0.0f ) );
+
+            sumColor[i]   += sampleColor[i];
+            sumLevel[i]   += level;
+            sumLevelSq[i] += level * level;
+        }
+
+        nSamples++;
+
+        if( nSamples < parameters.m_minSamples )
+            continue;
+
+        // Stop refining once the time budget of the render is over, the tiles
+        // still to trace will only get their minimum samples
+        if( timeBudget &&
+            ( ( GetRunningMicroSecs() - m_stats_start_rendering_time ) > timeBudget ) )
+            break;
+
+        // The tile has converged when all its pixels have
+        const float invN = 1.0f / (float)nSamples;
+        const float invNm1 = 1.0f / (float)( nSamples - 1 );
+
+        float maxError = 0.0f;
+
+        for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
+        {
+            const float mean = sumLevel[i] * invN;
+            const float variance = glm::max( ( sumLevelSq[i] - sumLevel[i] * mean ) * invNm1,
+                                             0.0f );
+
+            // Relative standard error of the mean, with a floor for black pixels
+            const float error = sqrtf( variance * invN ) / ( mean + 0.05f );
+
+            maxError = glm::max( maxError, error );
+        }
+
+        if( maxError <= parameters.m_maxError )
+            break;
+    }
+
+    const float invN = 1.0f / (float)nSamples;
+
+    for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
+        aInOutHitColor[i] = sumColor[i] * invN;
+}
+
+
 void C3D_RENDER_RAYTRACING::rt_render_post_process_shade( GLubyte *ptrPBO,
                                                           REPORTER *aStatusTextReporter )
 {
@@ -2106,6 +2390,4 @@ void C3D_RENDER_RAYTRACING::initialize_block_positions()
     // Create m_shader buffer
     delete[] m_shaderBuffer;
     m_shaderBuffer = new SFVEC3F[m_realBufferSize.x * m_realBufferSize.y];
-
-    opengl_init_pbo();
 }
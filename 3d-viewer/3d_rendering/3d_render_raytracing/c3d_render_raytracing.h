@@ -56,6 +56,15 @@ typedef enum
     RT_RENDER_STATE_MAX
 }RT_RENDER_STATE;
 
+/// Time spent in each phase of a render, in microseconds
+struct RT_RENDER_TIMINGS
+{
+    unsigned long int m_sceneBuild;     ///< board and 3D models conversion to 3D objects
+    unsigned long int m_accelerator;    ///< BVH construction
+    unsigned long int m_tracing;        ///< ray tracing of all the blocks
+    unsigned long int m_postShading;    ///< post processing shader and blur
+};
+
 class C3D_RENDER_RAYTRACING : public C3D_RENDER_BASE
 {
 public:
@@ -69,6 +78,24 @@ public:
 
     int GetWaitForEditingTimeOut() override;
 
+    /**
+     * @brief RenderToFile - Renders the board of the settings, seen from the
+     * camera of the settings, without using OpenGL and saves it as a PNG
+     * image. The render runs on all the processor cores until it is finished,
+     * so it can be used in batch mode on machines without a graphic card.
+     * The PNG image handler must be registered (wxInitAllImageHandlers).
+     * @param aSize - size in pixels of the image, the camera is set to it
+     * @param aFileName - name of the PNG file to write
+     * @param aTimings - if not NULL, gets the time spent in each render phase
+     * @param aStatusTextReporter - if not NULL, reports the progress and the
+     * time spent in each render phase
+     * @return true if the image was saved
+     */
+    bool RenderToFile( const wxSize &aSize,
+                       const wxString &aFileName,
+                       RT_RENDER_TIMINGS *aTimings = NULL,
+                       REPORTER *aStatusTextReporter = NULL );
+
 private:
     bool initializeOpenGL();
     void initializeNewWindowSize();
@@ -95,6 +122,21 @@ private:
                              const RAY *aRayPck,
                              SFVEC3F *aOutHitColor );
 
+    /**
+     * @brief rt_trace_adaptive_packet - Anti-aliases a block by tracing more
+     * sample packets at different sub pixel positions until the error of all
+     * the pixels of the block is under the threshold of the current sampling
+     * mode, the maximum number of samples is reached or the render time budget
+     * is over.
+     * @param aBgColorY - background color of each row of the block
+     * @param aBlockPos - window position of the block
+     * @param aInOutHitColor - in: first sample of each pixel, out: the average
+     * of all the samples traced
+     */
+    void rt_trace_adaptive_packet( const SFVEC3F *aBgColorY,
+                                   const SFVEC2I &aBlockPos,
+                                   SFVEC3F *aInOutHitColor );
+
     // Materials
     void setupMaterials();
 
@@ -130,6 +172,12 @@ private:
     /// Time that the render starts
     unsigned long int m_stats_start_rendering_time;
 
+    /// Time spent in the last reload converting the board and the models, in microseconds
+    unsigned long int m_stats_scene_build_time;
+
+    /// Time spent in the last reload building the accelerator, in microseconds
+    unsigned long int m_stats_accelerator_time;
+
     /// Save the number of blocks progress of the render
     long m_nrBlocksRenderProgress;
 
@@ -191,12 +239,45 @@ private:
                                 const CMATERIAL *aMaterial,
                                 const SFVEC3F &aObjColor );
 
+    /**
+     * Functions add_3D_layer and add_3D_solder_mask
+     * convert the 2D objects of a layer to 3D objects. They only read the
+     * shared data, so the layers can be converted concurrently, each one to
+     * its own containers.
+     * @param aDstContainer gets the 3D objects
+     * @param aDstObjectsToDelete gets the 2D objects created for the 3D ones
+     */
+    void add_3D_layer( PCB_LAYER_ID aLayerId,
+                       const CBVHCONTAINER2D *aLayerContainer2d,
+                       CCONTAINER &aDstContainer,
+                       CCONTAINER2D &aDstObjectsToDelete );
+
+    void add_3D_solder_mask( PCB_LAYER_ID aLayerId,
+                             const CBVHCONTAINER2D *aLayerContainer2d,
+                             CCONTAINER &aDstContainer,
+                             CCONTAINER2D &aDstObjectsToDelete );
+
     void add_3D_vias_and_pads_to_container();
     void insert3DViaHole( const VIA* aVia );
     void insert3DPadHole( const D_PAD* aPad );
     void load_3D_models();
+
+    /**
+     * Function get_3D_model_materials
+     * returns the materials of a model, creating them on the first call
+     * @return the materials, or NULL if the model has none
+     */
+    const MODEL_MATERIALS *get_3D_model_materials( const S3DMODEL *a3DModel );
+
+    /**
+     * Function add_3D_models
+     * adds the triangles of a model to aDstContainer. It can be called
+     * concurrently for different containers.
+     */
     void add_3D_models( const S3DMODEL *a3DModel,
-                        const glm::mat4 &aModelMatrix );
+                        const glm::mat4 &aModelMatrix,
+                        const MODEL_MATERIALS &aMaterials,
+                        CCONTAINER &aDstContainer );
 
     /// Stores materials of the 3D models
     MAP_MODEL_MATERIALS m_model_materials;
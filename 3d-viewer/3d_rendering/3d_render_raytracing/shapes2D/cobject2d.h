@@ -139,7 +139,12 @@ public:
         return m_counter[aObjType];
     }
 
-    void AddOne( OBJECT2D_TYPE aObjType ) { m_counter[aObjType]++; }
+    void AddOne( OBJECT2D_TYPE aObjType )
+    {
+        // Objects are created concurrently while the scene is built
+        #pragma omp atomic
+        m_counter[aObjType]++;
+    }
 
     void PrintStats();
 
@@ -109,7 +109,12 @@ public:
 
     unsigned int GetCountOf( OBJECT3D_TYPE aObjType ) const { return m_counter[aObjType]; }
 
-    void AddOne( OBJECT3D_TYPE aObjType ) { m_counter[aObjType]++; }
+    void AddOne( OBJECT3D_TYPE aObjType )
+    {
+        // Objects are created concurrently while the scene is built
+        #pragma omp atomic
+        m_counter[aObjType]++;
+    }
 
     void PrintStats();
 
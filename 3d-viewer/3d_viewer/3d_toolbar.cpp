@@ -232,6 +232,11 @@ void EDA_3D_VIEWER::CreateMenuBar()
                 _( "Show Model Bounding Boxes" ),
                 KiBitmap( ortho_xpm ), wxITEM_CHECK );
 
+    AddMenuItem( renderOptionsMenu_OPENGL, ID_MENU3D_FL_OPENGL_RENDER_MODELS_LOD,
+                _( "Simplify Distant Models" ),
+                _( "Renders simplified 3D models when they are small on screen (faster rendering)" ),
+                KiBitmap( module_xpm ), wxITEM_CHECK );
+
 
     // Add specific preferences for Raytracing
     // /////////////////////////////////////////////////////////////////////////
@@ -268,6 +273,47 @@ void EDA_3D_VIEWER::CreateMenuBar()
                  _( "Render with improved quality on final render (slow)"),
                  KiBitmap( green_xpm ), wxITEM_CHECK );
 
+    wxMenu * samplingList = new wxMenu;
+    AddMenuItem( renderOptionsMenu_RAYTRACING, samplingList, ID_MENU3D_FL_RAYTRACING_SAMPLING,
+                 _( "Anti-aliasing Sampling" ), KiBitmap( tools_xpm ) );
+
+    samplingList->AppendRadioItem( ID_MENU3D_FL_RAYTRACING_SAMPLING_FIXED,
+                                   _( "Fixed" ),
+                                   _( "Trace the same number of samples in all the pixels" ) );
+
+    samplingList->AppendRadioItem( ID_MENU3D_FL_RAYTRACING_SAMPLING_ADAPTIVE_DRAFT,
+                                   _( "Adaptive Draft" ),
+                                   _( "Trace extra samples only in the noisy areas, stop early (fast)" ) );
+
+    samplingList->AppendRadioItem( ID_MENU3D_FL_RAYTRACING_SAMPLING_ADAPTIVE_NORMAL,
+                                   _( "Adaptive Normal" ),
+                                   _( "Trace extra samples only in the noisy areas" ) );
+
+    samplingList->AppendRadioItem( ID_MENU3D_FL_RAYTRACING_SAMPLING_ADAPTIVE_HIGH,
+                                   _( "Adaptive High Quality" ),
+                                   _( "Trace extra samples only in the noisy areas, until they are smooth (slow)" ) );
+
+    wxMenu * samplingTimeList = new wxMenu;
+    AddMenuItem( renderOptionsMenu_RAYTRACING, samplingTimeList,
+                 ID_MENU3D_FL_RAYTRACING_SAMPLING_TIME,
+                 _( "Adaptive Sampling Time Limit" ), KiBitmap( tools_xpm ) );
+
+    samplingTimeList->AppendRadioItem( ID_MENU3D_FL_RAYTRACING_SAMPLING_TIME_NO_LIMIT,
+                                       _( "No Limit" ),
+                                       _( "Refine the noisy areas until the quality is reached" ) );
+
+    samplingTimeList->AppendRadioItem( ID_MENU3D_FL_RAYTRACING_SAMPLING_TIME_10S,
+                                       _( "10 Seconds" ),
+                                       _( "Stop refining the noisy areas after 10 seconds of render" ) );
+
+    samplingTimeList->AppendRadioItem( ID_MENU3D_FL_RAYTRACING_SAMPLING_TIME_30S,
+                                       _( "30 Seconds" ),
+                                       _( "Stop refining the noisy areas after 30 seconds of render" ) );
+
+    samplingTimeList->AppendRadioItem( ID_MENU3D_FL_RAYTRACING_SAMPLING_TIME_60S,
+                                       _( "60 Seconds" ),
+                                       _( "Stop refining the noisy areas after 60 seconds of render" ) );
+
     AddMenuItem( renderOptionsMenu_RAYTRACING, ID_MENU3D_FL_RAYTRACING_POST_PROCESSING,
                  _( "Post-processing" ),
                  _( "Apply Screen Space Ambient Occlusion and Global Illumination reflections on final render (slow)"),
@@ -460,6 +506,9 @@ void EDA_3D_VIEWER::SetMenuBarOptionsState()
     item = menuBar->FindItem( ID_MENU3D_FL_OPENGL_RENDER_SHOW_MODEL_BBOX );
     item->Check( m_settings.GetFlag( FL_RENDER_OPENGL_SHOW_MODEL_BBOX ) );
 
+    item = menuBar->FindItem( ID_MENU3D_FL_OPENGL_RENDER_MODELS_LOD );
+    item->Check( m_settings.GetFlag( FL_RENDER_OPENGL_MODELS_LOD ) );
+
     // Raytracing
     item = menuBar->FindItem( ID_MENU3D_FL_RAYTRACING_RENDER_SHADOWS );
     item->Check( m_settings.GetFlag( FL_RENDER_RAYTRACING_SHADOWS ) );
@@ -479,6 +528,37 @@ void EDA_3D_VIEWER::SetMenuBarOptionsState()
     item = menuBar->FindItem( ID_MENU3D_FL_RAYTRACING_ANTI_ALIASING );
     item->Check( m_settings.GetFlag( FL_RENDER_RAYTRACING_ANTI_ALIASING ) );
 
+    item = menuBar->FindItem( ID_MENU3D_FL_RAYTRACING_SAMPLING );
+    item->Enable( m_settings.GetFlag( FL_RENDER_RAYTRACING_ANTI_ALIASING ) );
+
+    item = menuBar->FindItem( ID_MENU3D_FL_RAYTRACING_SAMPLING_FIXED );
+    item->Check( m_settings.SamplingModeGet() == SAMPLING_MODE_FIXED );
+
+    item = menuBar->FindItem( ID_MENU3D_FL_RAYTRACING_SAMPLING_ADAPTIVE_DRAFT );
+    item->Check( m_settings.SamplingModeGet() == SAMPLING_MODE_ADAPTIVE_DRAFT );
+
+    item = menuBar->FindItem( ID_MENU3D_FL_RAYTRACING_SAMPLING_ADAPTIVE_NORMAL );
+    item->Check( m_settings.SamplingModeGet() == SAMPLING_MODE_ADAPTIVE_NORMAL );
+
+    item = menuBar->FindItem( ID_MENU3D_FL_RAYTRACING_SAMPLING_ADAPTIVE_HIGH );
+    item->Check( m_settings.SamplingModeGet() == SAMPLING_MODE_ADAPTIVE_HIGH );
+
+    item = menuBar->FindItem( ID_MENU3D_FL_RAYTRACING_SAMPLING_TIME );
+    item->Enable( m_settings.GetFlag( FL_RENDER_RAYTRACING_ANTI_ALIASING ) &&
+                  ( m_settings.SamplingModeGet() != SAMPLING_MODE_FIXED ) );
+
+    item = menuBar->FindItem( ID_MENU3D_FL_RAYTRACING_SAMPLING_TIME_NO_LIMIT );
+    item->Check( m_settings.SamplingTimeBudgetGet() <= 0.0f );
+
+    item = menuBar->FindItem( ID_MENU3D_FL_RAYTRACING_SAMPLING_TIME_10S );
+    item->Check( m_settings.SamplingTimeBudgetGet() == 10.0f );
+
+    item = menuBar->FindItem( ID_MENU3D_FL_RAYTRACING_SAMPLING_TIME_30S );
+    item->Check( m_settings.SamplingTimeBudgetGet() == 30.0f );
+
+    item = menuBar->FindItem( ID_MENU3D_FL_RAYTRACING_SAMPLING_TIME_60S );
+    item->Check( m_settings.SamplingTimeBudgetGet() == 60.0f );
+
     item = menuBar->FindItem( ID_MENU3D_FL_RAYTRACING_PROCEDURAL_TEXTURES );
     item->Check( m_settings.GetFlag( FL_RENDER_RAYTRACING_PROCEDURAL_TEXTURES ) );
 
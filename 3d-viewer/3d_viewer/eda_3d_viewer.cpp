@@ -87,6 +87,7 @@ static const wxChar keyRenderMaterial[]         = wxT( "Render_Material" );
 
 static const wxChar keyRenderOGL_ShowCopperTck[]= wxT( "Render_OGL_ShowCopperThickness" );
 static const wxChar keyRenderOGL_ShowModelBBox[]= wxT( "Render_OGL_ShowModelBoudingBoxes" );
+static const wxChar keyRenderOGL_ModelsLOD[]    = wxT( "Render_OGL_ModelsLevelOfDetail" );
 
 static const wxChar keyRenderRAY_Shadows[]      = wxT( "Render_RAY_Shadows" );
 static const wxChar keyRenderRAY_Backfloor[]    = wxT( "Render_RAY_Backfloor" );
@@ -95,6 +96,8 @@ static const wxChar keyRenderRAY_Reflections[]  = wxT( "Render_RAY_Reflections"
 static const wxChar keyRenderRAY_PostProcess[]  = wxT( "Render_RAY_PostProcess" );
 static const wxChar keyRenderRAY_AAliasing[]    = wxT( "Render_RAY_AntiAliasing" );
 static const wxChar keyRenderRAY_ProceduralT[]  = wxT( "Render_RAY_ProceduralTextures" );
+static const wxChar keyRenderRAY_Sampling[]     = wxT( "Render_RAY_Sampling" );
+static const wxChar keyRenderRAY_SamplingTime[] = wxT( "Render_RAY_SamplingTimeBudget" );
 
 static const wxChar keyShowAxis[]               = wxT( "ShowAxis" );
 static const wxChar keyShowGrid[]               = wxT( "ShowGrid3D" );
@@ -420,6 +423,11 @@ void EDA_3D_VIEWER::Process_Special_Functions( wxCommandEvent &event )
         m_canvas->Request_refresh();
         return;
 
+    case ID_MENU3D_FL_OPENGL_RENDER_MODELS_LOD:
+        m_settings.SetFlag( FL_RENDER_OPENGL_MODELS_LOD, isChecked );
+        ReloadRequest();
+        return;
+
     case ID_MENU3D_FL_RAYTRACING_RENDER_SHADOWS:
         m_settings.SetFlag( FL_RENDER_RAYTRACING_SHADOWS, isChecked );
         m_canvas->Request_refresh();
@@ -452,6 +460,51 @@ void EDA_3D_VIEWER::Process_Special_Functions( wxCommandEvent &event )
 
     case ID_MENU3D_FL_RAYTRACING_ANTI_ALIASING:
         m_settings.SetFlag( FL_RENDER_RAYTRACING_ANTI_ALIASING, isChecked );
+        SetMenuBarOptionsState();
+        m_canvas->Request_refresh();
+        return;
+
+    case ID_MENU3D_FL_RAYTRACING_SAMPLING_FIXED:
+        m_settings.SamplingModeSet( SAMPLING_MODE_FIXED );
+        SetMenuBarOptionsState();
+        m_canvas->Request_refresh();
+        return;
+
+    case ID_MENU3D_FL_RAYTRACING_SAMPLING_ADAPTIVE_DRAFT:
+        m_settings.SamplingModeSet( SAMPLING_MODE_ADAPTIVE_DRAFT );
+        SetMenuBarOptionsState();
+        m_canvas->Request_refresh();
+        return;
+
+    case ID_MENU3D_FL_RAYTRACING_SAMPLING_ADAPTIVE_NORMAL:
+        m_settings.SamplingModeSet( SAMPLING_MODE_ADAPTIVE_NORMAL );
+        SetMenuBarOptionsState();
+        m_canvas->Request_refresh();
+        return;
+
+    case ID_MENU3D_FL_RAYTRACING_SAMPLING_ADAPTIVE_HIGH:
+        m_settings.SamplingModeSet( SAMPLING_MODE_ADAPTIVE_HIGH );
+        SetMenuBarOptionsState();
+        m_canvas->Request_refresh();
+        return;
+
+    case ID_MENU3D_FL_RAYTRACING_SAMPLING_TIME_NO_LIMIT:
+        m_settings.SamplingTimeBudgetSet( 0.0f );
+        m_canvas->Request_refresh();
+        return;
+
+    case ID_MENU3D_FL_RAYTRACING_SAMPLING_TIME_10S:
+        m_settings.SamplingTimeBudgetSet( 10.0f );
+        m_canvas->Request_refresh();
+        return;
+
+    case ID_MENU3D_FL_RAYTRACING_SAMPLING_TIME_30S:
+        m_settings.SamplingTimeBudgetSet( 30.0f );
+        m_canvas->Request_refresh();
+        return;
+
+    case ID_MENU3D_FL_RAYTRACING_SAMPLING_TIME_60S:
+        m_settings.SamplingTimeBudgetSet( 60.0f );
         m_canvas->Request_refresh();
         return;
 
@@ -748,6 +801,9 @@ void EDA_3D_VIEWER::LoadSettings( wxConfigBase *aCfg )
     aCfg->Read( keyRenderOGL_ShowModelBBox, &tmp, false );
     m_settings.SetFlag( FL_RENDER_OPENGL_SHOW_MODEL_BBOX, tmp );
 
+    aCfg->Read( keyRenderOGL_ModelsLOD, &tmp, false );
+    m_settings.SetFlag( FL_RENDER_OPENGL_MODELS_LOD, tmp );
+
     // Raytracing options
     aCfg->Read( keyRenderRAY_Shadows, &tmp, true );
     m_settings.SetFlag( FL_RENDER_RAYTRACING_SHADOWS, tmp );
@@ -815,6 +871,21 @@ void EDA_3D_VIEWER::LoadSettings( wxConfigBase *aCfg )
 
     aCfg->Read( keyRenderMaterial, &tmpi, (int)MATERIAL_MODE_NORMAL );
     m_settings.MaterialModeSet( (MATERIAL_MODE)tmpi );
+
+    aCfg->Read( keyRenderRAY_Sampling, &tmpi, (int)SAMPLING_MODE_FIXED );
+
+    if( ( tmpi < SAMPLING_MODE_FIXED ) || ( tmpi > SAMPLING_MODE_ADAPTIVE_HIGH ) )
+        tmpi = SAMPLING_MODE_FIXED;
+
+    m_settings.SamplingModeSet( (SAMPLING_MODE)tmpi );
+
+    double tmpd;
+    aCfg->Read( keyRenderRAY_SamplingTime, &tmpd, 0.0 );
+
+    if( !( tmpd > 0.0 ) )   // also rejects NaN
+        tmpd = 0.0;
+
+    m_settings.SamplingTimeBudgetSet( (float)tmpd );
 }
 
 
@@ -863,6 +934,7 @@ void EDA_3D_VIEWER::SaveSettings( wxConfigBase *aCfg )
     // OpenGL options
     aCfg->Write( keyRenderOGL_ShowCopperTck,m_settings.GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS ) );
     aCfg->Write( keyRenderOGL_ShowModelBBox,m_settings.GetFlag( FL_RENDER_OPENGL_SHOW_MODEL_BBOX ) );
+    aCfg->Write( keyRenderOGL_ModelsLOD,    m_settings.GetFlag( FL_RENDER_OPENGL_MODELS_LOD ) );
 
     // Raytracing options
     aCfg->Write( keyRenderRAY_Shadows,      m_settings.GetFlag( FL_RENDER_RAYTRACING_SHADOWS ) );
@@ -872,6 +944,8 @@ void EDA_3D_VIEWER::SaveSettings( wxConfigBase *aCfg )
     aCfg->Write( keyRenderRAY_PostProcess,  m_settings.GetFlag( FL_RENDER_RAYTRACING_POST_PROCESSING ) );
     aCfg->Write( keyRenderRAY_AAliasing,    m_settings.GetFlag( FL_RENDER_RAYTRACING_ANTI_ALIASING ) );
     aCfg->Write( keyRenderRAY_ProceduralT,  m_settings.GetFlag( FL_RENDER_RAYTRACING_PROCEDURAL_TEXTURES ) );
+    aCfg->Write( keyRenderRAY_Sampling,     (int)m_settings.SamplingModeGet() );
+    aCfg->Write( keyRenderRAY_SamplingTime, (double)m_settings.SamplingTimeBudgetGet() );
 
     aCfg->Write( keyShowAxis,               m_settings.GetFlag( FL_AXIS ) );
     aCfg->Write( keyShowGrid,               (int)m_settings.GridGet() );
@@ -69,6 +69,7 @@ enum id_3dview_frm
     ID_MENU3D_FL_OPENGL,
     ID_MENU3D_FL_OPENGL_RENDER_COPPER_THICKNESS,
     ID_MENU3D_FL_OPENGL_RENDER_SHOW_MODEL_BBOX,
+    ID_MENU3D_FL_OPENGL_RENDER_MODELS_LOD,
 
     ID_MENU3D_FL_RAYTRACING,
     ID_MENU3D_FL_RAYTRACING_RENDER_SHADOWS,
@@ -77,6 +78,16 @@ enum id_3dview_frm
     ID_MENU3D_FL_RAYTRACING_REFLECTIONS,
     ID_MENU3D_FL_RAYTRACING_POST_PROCESSING,
     ID_MENU3D_FL_RAYTRACING_ANTI_ALIASING,
+    ID_MENU3D_FL_RAYTRACING_SAMPLING,
+    ID_MENU3D_FL_RAYTRACING_SAMPLING_FIXED,
+    ID_MENU3D_FL_RAYTRACING_SAMPLING_ADAPTIVE_DRAFT,
+    ID_MENU3D_FL_RAYTRACING_SAMPLING_ADAPTIVE_NORMAL,
+    ID_MENU3D_FL_RAYTRACING_SAMPLING_ADAPTIVE_HIGH,
+    ID_MENU3D_FL_RAYTRACING_SAMPLING_TIME,
+    ID_MENU3D_FL_RAYTRACING_SAMPLING_TIME_NO_LIMIT,
+    ID_MENU3D_FL_RAYTRACING_SAMPLING_TIME_10S,
+    ID_MENU3D_FL_RAYTRACING_SAMPLING_TIME_30S,
+    ID_MENU3D_FL_RAYTRACING_SAMPLING_TIME_60S,
     ID_MENU3D_FL_RAYTRACING_PROCEDURAL_TEXTURES,
 
     ID_RENDER_CURRENT_VIEW,
@@ -34,6 +34,7 @@
 #include <macros.h>
 #include <base_units.h>
 #include <reporter.h>
+#include <ki_mutex.h>
 
 #include <wx/process.h>
 #include <wx/config.h>
@@ -166,9 +167,14 @@ int ProcessExecute( const wxString& aCommandLine, int aFlags, wxProcess *callbac
 
 timestamp_t GetNewTimeStamp()
 {
+    // Items can be created by several threads, e.g. when the sheets of a schematic are
+    // loaded or when the layers of a board are plotted.
+    static MUTEX    timestamp_mutex;
     static timestamp_t oldTimeStamp;
     timestamp_t newTimeStamp;
 
+    MUTLOCK lock( timestamp_mutex );
+
     newTimeStamp = time( NULL );
 
     if( newTimeStamp <= oldTimeStamp )
@@ -251,7 +257,6 @@ wxString GetKicadConfigPath()
 }
 
 
-#include <ki_mutex.h>
 const wxString ExpandEnvVarSubstitutions( const wxString& aString )
 {
     // wxGetenv( wchar_t* ) is not re-entrant on linux.
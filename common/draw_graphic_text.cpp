@@ -87,6 +87,8 @@ int Clamp_Text_PenSize( int aPenSize, wxSize aSize, bool aBold )
 
 int GraphicTextWidth( const wxString& aText, const wxSize& aSize, bool aItalic, bool aBold )
 {
+    std::lock_guard<std::recursive_mutex> lock( basic_gal_mutex );
+
     basic_gal.SetFontItalic( aItalic );
     basic_gal.SetFontBold( aBold );
     basic_gal.SetGlyphSize( VECTOR2D( aSize ) );
@@ -145,6 +147,8 @@ void DrawGraphicText( EDA_RECT* aClipBox,
         fill_mode = false;
     }
 
+    std::lock_guard<std::recursive_mutex> lock( basic_gal_mutex );
+
     basic_gal.SetIsFill( fill_mode );
     basic_gal.SetLineWidth( aWidth );
 
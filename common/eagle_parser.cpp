@@ -27,9 +27,11 @@
 #include <eagle_parser.h>
 
 #include <functional>
+#include <memory>
 #include <sstream>
 #include <iomanip>
 #include <cstdio>
+#include <cstring>
 
 constexpr auto DEFAULT_ALIGNMENT = ETEXT::BOTTOM_LEFT;
 
@@ -258,6 +260,472 @@ NODE_MAP MapChildren( wxXmlNode* aCurrentNode )
 }
 
 
+EAGLE_XML_READER::EAGLE_XML_READER( const wxString& aFileName ) :
+    m_fileName( aFileName ),
+    m_bufferLen( 0 ),
+    m_bufferPos( 0 ),
+    m_lineNumber( 1 ),
+    m_stop( false )
+{
+    m_fp = wxFopen( aFileName, wxT( "rb" ) );
+
+    if( !m_fp )
+        THROW_IO_ERROR( wxString::Format( _( "Unable to read file \"%s\"" ), aFileName ) );
+}
+
+
+EAGLE_XML_READER::~EAGLE_XML_READER()
+{
+    fclose( m_fp );
+}
+
+
+void EAGLE_XML_READER::error( const wxString& aMessage )
+{
+    throw XML_PARSER_ERROR( wxString::Format( "%s in file \"%s\", line %d",
+                                              aMessage, m_fileName, m_lineNumber ) );
+}
+
+
+int EAGLE_XML_READER::peekChar()
+{
+    if( m_bufferPos == m_bufferLen )
+    {
+        m_bufferLen = fread( m_buffer, 1, sizeof( m_buffer ), m_fp );
+        m_bufferPos = 0;
+
+        if( m_bufferLen == 0 )
+            return EOF;
+    }
+
+    return (unsigned char) m_buffer[m_bufferPos];
+}
+
+
+int EAGLE_XML_READER::getChar()
+{
+    int c = peekChar();
+
+    if( c != EOF )
+    {
+        m_bufferPos++;
+
+        if( c == '\n' )
+            m_lineNumber++;
+    }
+
+    return c;
+}
+
+
+void EAGLE_XML_READER::expect( const char* aText )
+{
+    for( const char* text = aText; *text; text++ )
+    {
+        if( getChar() != (unsigned char) *text )
+            error( wxString::Format( "'%s' expected", aText ) );
+    }
+}
+
+
+void EAGLE_XML_READER::skipPast( const char* aText )
+{
+    size_t len = strlen( aText );
+    size_t matched = 0;
+
+    while( matched < len )
+    {
+        int c = getChar();
+
+        if( c == EOF )
+            error( wxString::Format( "'%s' not found", aText ) );
+
+        if( c == (unsigned char) aText[matched] )
+            matched++;
+        else
+            matched = ( c == (unsigned char) aText[0] ) ? 1 : 0;
+    }
+}
+
+
+void EAGLE_XML_READER::skipSpaces()
+{
+    while( isspace( peekChar() ) )
+        getChar();
+}
+
+
+bool EAGLE_XML_READER::skipMarkup( std::string* aCData )
+{
+    // The '<' was already read.
+    int c = peekChar();
+
+    if( c == '?' )                  // Processing instruction, e.g. the <?xml ...?> header.
+    {
+        skipPast( "?>" );
+        return true;
+    }
+
+    if( c != '!' )                  // Element start or end tag.
+        return false;
+
+    getChar();
+
+    if( peekChar() == '-' )         // Comment.
+    {
+        expect( "--" );
+        skipPast( "-->" );
+    }
+    else if( peekChar() == '[' )    // CDATA section.
+    {
+        expect( "[CDATA[" );
+
+        std::string cdata;
+
+        while( cdata.size() < 3 || cdata.compare( cdata.size() - 3, 3, "]]>" ) != 0 )
+        {
+            c = getChar();
+
+            if( c == EOF )
+                error( "unterminated CDATA section" );
+
+            cdata += (char) c;
+        }
+
+        cdata.resize( cdata.size() - 3 );
+
+        if( aCData )
+            *aCData = cdata;
+    }
+    else                            // Declaration, e.g. <!DOCTYPE ...> with its internal subset.
+    {
+        int depth = 0;
+
+        for( c = getChar(); !( c == '>' && depth <= 0 ); c = getChar() )
+        {
+            if( c == EOF )
+                error( "unterminated declaration" );
+            else if( c == '[' )
+                depth++;
+            else if( c == ']' )
+                depth--;
+        }
+    }
+
+    return true;
+}
+
+
+std::string EAGLE_XML_READER::readName()
+{
+    std::string name;
+
+    for( int c = peekChar(); c != EOF && !isspace( c ) && !strchr( "/>=", c ); c = peekChar() )
+        name += (char) getChar();
+
+    if( name.empty() )
+        error( "name expected" );
+
+    return name;
+}
+
+
+void EAGLE_XML_READER::readText( std::string& aText, char aDelimiter )
+{
+    // Reads up to aDelimiter, which is not consumed, and decodes the entity references.
+    for( int c = peekChar(); c != EOF && c != (unsigned char) aDelimiter; c = peekChar() )
+    {
+        getChar();
+
+        if( c != '&' )
+        {
+            // Attribute values are normalized like any XML parser does.
+            if( aDelimiter != '<' && ( c == '\n' || c == '\r' || c == '\t' ) )
+                c = ' ';
+
+            aText += (char) c;
+            continue;
+        }
+
+        std::string entity;
+
+        for( c = getChar(); c != ';'; c = getChar() )
+        {
+            if( c == EOF || entity.size() > 10 )
+                error( "invalid entity reference" );
+
+            entity += (char) c;
+        }
+
+        if( entity == "lt" )
+            aText += '<';
+        else if( entity == "gt" )
+            aText += '>';
+        else if( entity == "amp" )
+            aText += '&';
+        else if( entity == "quot" )
+            aText += '"';
+        else if( entity == "apos" )
+            aText += '\'';
+        else if( entity.size() > 1 && entity[0] == '#' )
+        {
+            unsigned long code = ( entity[1] == 'x' ) ? strtoul( entity.c_str() + 2, NULL, 16 )
+                                                      : strtoul( entity.c_str() + 1, NULL, 10 );
+
+            aText += TO_UTF8( wxString( wxUniChar( code ) ) );
+        }
+        else
+        {
+            error( wxString::Format( "unknown entity '&%s;'", entity ) );
+        }
+    }
+}
+
+
+wxXmlNode* EAGLE_XML_READER::readStartTag( bool& aEmptyElement )
+{
+    // The '<' was already read.
+    std::unique_ptr<wxXmlNode> node( new wxXmlNode( wxXML_ELEMENT_NODE,
+                                                    FROM_UTF8( readName().c_str() ) ) );
+
+    aEmptyElement = false;
+
+    while( true )
+    {
+        skipSpaces();
+
+        int c = getChar();
+
+        if( c == '>' )
+            break;
+
+        if( c == '/' )
+        {
+            if( getChar() != '>' )
+                error( "'>' expected" );
+
+            aEmptyElement = true;
+            break;
+        }
+
+        if( c == EOF )
+            error( "unexpected end of file" );
+
+        m_bufferPos--;      // Put back the first character of the attribute name.
+
+        std::string attrName = readName();
+        std::string attrValue;
+
+        skipSpaces();
+
+        if( getChar() != '=' )
+            error( "'=' expected" );
+
+        skipSpaces();
+
+        int quote = getChar();
+
+        if( quote != '"' && quote != '\'' )
+            error( "quoted attribute value expected" );
+
+        readText( attrValue, (char) quote );
+
+        if( getChar() != quote )
+            error( "unterminated attribute value" );
+
+        node->AddAttribute( FROM_UTF8( attrName.c_str() ), FROM_UTF8( attrValue.c_str() ) );
+    }
+
+    return node.release();
+}
+
+
+void EAGLE_XML_READER::readEndTag( const wxString& aName )
+{
+    // The "</" was already read.
+    std::string name = readName();
+
+    skipSpaces();
+
+    if( getChar() != '>' )
+        error( "'>' expected" );
+
+    if( FROM_UTF8( name.c_str() ) != aName )
+        error( wxString::Format( "'</%s>' expected", aName ) );
+}
+
+
+void EAGLE_XML_READER::readChildren( wxXmlNode* aNode )
+{
+    // Children are linked to the last one instead of using AddChild(), which walks the whole
+    // list of children each time.
+    wxXmlNode* last = NULL;
+
+    auto append = [&]( wxXmlNode* aChild )
+    {
+        aChild->SetParent( aNode );
+
+        if( last )
+            last->SetNext( aChild );
+        else
+            aNode->SetChildren( aChild );
+
+        last = aChild;
+    };
+
+    while( true )
+    {
+        std::string text;
+
+        readText( text, '<' );
+
+        if( text.find_first_not_of( " \t\r\n" ) != std::string::npos )
+            append( new wxXmlNode( wxXML_TEXT_NODE, wxEmptyString, FROM_UTF8( text.c_str() ) ) );
+
+        if( getChar() == EOF )
+            error( wxString::Format( "'</%s>' not found", aNode->GetName() ) );
+
+        std::string cdata;
+
+        if( skipMarkup( &cdata ) )
+        {
+            if( !cdata.empty() )
+                append( new wxXmlNode( wxXML_CDATA_SECTION_NODE, wxEmptyString,
+                                       FROM_UTF8( cdata.c_str() ) ) );
+        }
+        else if( peekChar() == '/' )
+        {
+            getChar();
+            readEndTag( aNode->GetName() );
+            return;
+        }
+        else
+        {
+            bool       emptyElement;
+            wxXmlNode* child = readStartTag( emptyElement );
+
+            append( child );
+
+            if( !emptyElement )
+                readChildren( child );
+        }
+    }
+}
+
+
+bool EAGLE_XML_READER::nextTag()
+{
+    // Text outside of the built elements is not needed.
+    while( true )
+    {
+        int c = getChar();
+
+        while( c != EOF && c != '<' )
+            c = getChar();
+
+        if( c == EOF )
+            return false;
+
+        if( !skipMarkup( NULL ) )
+            return true;
+    }
+}
+
+
+void EAGLE_XML_READER::Read( const FILTER& aFilter, const HANDLER& aHandler )
+{
+    std::vector<wxString> path;      // The elements being descended.
+    std::vector<wxString> pathNames; // Their dot separated path.
+
+    rewind( m_fp );
+    m_bufferLen = 0;
+    m_bufferPos = 0;
+    m_lineNumber = 1;
+    m_stop = false;
+
+    while( !m_stop && nextTag() )
+    {
+        if( peekChar() == '/' )
+        {
+            getChar();
+
+            if( path.empty() )
+                error( "unexpected end tag" );
+
+            readEndTag( path.back() );
+            path.pop_back();
+            pathNames.pop_back();
+            continue;
+        }
+
+        bool                        emptyElement;
+        std::unique_ptr<wxXmlNode>  node( readStartTag( emptyElement ) );
+        wxString                    nodePath = pathNames.empty() ? node->GetName()
+                                               : pathNames.back() + "." + node->GetName();
+
+        switch( aFilter( nodePath ) )
+        {
+        case DESCEND:
+            if( !emptyElement )
+            {
+                path.push_back( node->GetName() );
+                pathNames.push_back( nodePath );
+            }
+
+            break;
+
+        case WHOLE:
+            if( !emptyElement )
+                readChildren( node.get() );
+
+            if( aHandler( nodePath, node.get() ) )
+                node.release();
+
+            break;
+
+        case CHILDREN:
+            // The children are read one by one, each one being the only child of node while
+            // the handler runs.
+            while( !emptyElement && !m_stop )
+            {
+                if( !nextTag() )
+                    error( wxString::Format( "'</%s>' not found", node->GetName() ) );
+
+                if( peekChar() == '/' )
+                {
+                    getChar();
+                    readEndTag( node->GetName() );
+                    break;
+                }
+
+                bool                        childEmpty;
+                std::unique_ptr<wxXmlNode>  child( readStartTag( childEmpty ) );
+
+                if( !childEmpty )
+                    readChildren( child.get() );
+
+                child->SetParent( node.get() );
+                node->SetChildren( child.get() );
+
+                try
+                {
+                    aHandler( nodePath, node.get() );
+                }
+                catch( ... )
+                {
+                    node->SetChildren( NULL );
+                    throw;
+                }
+
+                node->SetChildren( NULL );
+            }
+
+            break;
+        }
+    }
+}
+
+
 timestamp_t EagleTimeStamp( wxXmlNode* aTree )
 {
     // in this case from a unique tree memory location
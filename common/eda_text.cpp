@@ -66,6 +66,8 @@ void EDA_TEXT::SwapEffects( EDA_TEXT& aTradingPartner )
 
 int EDA_TEXT::LenSize( const wxString& aLine ) const
 {
+    std::lock_guard<std::recursive_mutex> lock( basic_gal_mutex );
+
     basic_gal.SetFontItalic( IsItalic() );
     basic_gal.SetFontBold( IsBold() );
     basic_gal.SetGlyphSize( VECTOR2D( GetTextSize() ) );
@@ -281,28 +281,21 @@ void GERBER_PLOTTER::SetCurrentLineWidth( int width, void* aData )
 std::vector<APERTURE>::iterator GERBER_PLOTTER::getAperture( const wxSize& aSize,
                         APERTURE::APERTURE_TYPE aType, int aApertureAttribute )
 {
-    int last_D_code = 9;
-
     // Search an existing aperture
-    std::vector<APERTURE>::iterator tool = apertures.begin();
-
-    while( tool != apertures.end() )
-    {
-        last_D_code = tool->m_DCode;
+    APERTURE_KEY key = { aType, aSize, aApertureAttribute };
+    auto         index = m_apertureIndex.find( key );
 
-        if( (tool->m_Type == aType) && (tool->m_Size == aSize) && (tool->m_ApertureAttribute == aApertureAttribute) )
-            return tool;
-
-        ++tool;
-    }
+    if( index != m_apertureIndex.end() )
+        return apertures.begin() + index->second;
 
-    // Allocate a new aperture
+    // Allocate a new aperture.  D codes are given in creation order.
     APERTURE new_tool;
     new_tool.m_Size  = aSize;
     new_tool.m_Type  = aType;
-    new_tool.m_DCode = last_D_code + 1;
+    new_tool.m_DCode = apertures.empty() ? FIRST_DCODE_VALUE : apertures.back().m_DCode + 1;
     new_tool.m_ApertureAttribute = aApertureAttribute;
 
+    m_apertureIndex[key] = apertures.size();
     apertures.push_back( new_tool );
 
     return apertures.end() - 1;
@@ -37,7 +37,41 @@
 #include <macros.h>
 #include <kicad_string.h>
 #include <wx/zstream.h>
-#include <wx/mstream.h>
+#include <wx/stream.h>
+
+#include <cstdarg>
+
+
+/**
+ * A wxOutputStream writing to a stdio FILE, which is left open when done (unlike
+ * wxFFileOutputStream, which owns the FILE it is given).
+ */
+class FILE_OUTPUT_STREAM : public wxOutputStream
+{
+public:
+    FILE_OUTPUT_STREAM( FILE* aFile ) : m_file( aFile )
+    {
+    }
+
+protected:
+    size_t OnSysWrite( const void* aBuffer, size_t aSize ) override
+    {
+        size_t written = fwrite( aBuffer, 1, aSize, m_file );
+
+        if( written != aSize )
+            m_lasterror = wxSTREAM_WRITE_ERROR;
+
+        return written;
+    }
+
+    wxFileOffset OnSysTell() const override
+    {
+        return ftell( m_file );
+    }
+
+private:
+    FILE* m_file;
+};
 
 
 /*
@@ -94,7 +128,7 @@ void PDF_PLOTTER::SetViewport( const wxPoint& aOffset, double aIusPerDecimil,
  */
 void PDF_PLOTTER::SetCurrentLineWidth( int width, void* aData )
 {
-    wxASSERT( workFile );
+    wxASSERT( streamCompressor );
     int pen_width;
 
     if( width > 0 )
@@ -105,7 +139,7 @@ void PDF_PLOTTER::SetCurrentLineWidth( int width, void* aData )
         pen_width = defaultPenWidth;
 
     if( pen_width != currentPenWidth )
-        fprintf( workFile, "%g w\n",
+        streamPrintf( "%g w\n",
                  userToDeviceSize( pen_width ) );
 
     currentPenWidth = pen_width;
@@ -123,8 +157,8 @@ void PDF_PLOTTER::SetCurrentLineWidth( int width, void* aData )
  */
 void PDF_PLOTTER::emitSetRGBColor( double r, double g, double b )
 {
-    wxASSERT( workFile );
-    fprintf( workFile, "%g %g %g rg %g %g %g RG\n",
+    wxASSERT( streamCompressor );
+    streamPrintf( "%g %g %g rg %g %g %g RG\n",
              r, g, b, r, g, b );
 }
 
@@ -133,24 +167,24 @@ void PDF_PLOTTER::emitSetRGBColor( double r, double g, double b )
  */
 void PDF_PLOTTER::SetDash( int dashed )
 {
-    wxASSERT( workFile );
+    wxASSERT( streamCompressor );
     switch( dashed )
     {
     case PLOTDASHTYPE_DASH:
-        fprintf( workFile, "[%d %d] 0 d\n",
+        streamPrintf( "[%d %d] 0 d\n",
                 (int) GetDashMarkLenIU(), (int) GetDashGapLenIU() );
         break;
     case PLOTDASHTYPE_DOT:
-        fprintf( workFile, "[%d %d] 0 d\n",
+        streamPrintf( "[%d %d] 0 d\n",
                 (int) GetDotMarkLenIU(), (int) GetDashGapLenIU() );
         break;
     case PLOTDASHTYPE_DASHDOT:
-        fprintf( workFile, "[%d %d %d %d] 0 d\n",
+        streamPrintf( "[%d %d %d %d] 0 d\n",
                 (int) GetDashMarkLenIU(), (int) GetDashGapLenIU(),
                 (int) GetDotMarkLenIU(), (int) GetDashGapLenIU() );
         break;
     default:
-        fputs( "[] 0 d\n", workFile );
+        streamPuts( "[] 0 d\n" );
     }
 }
 
@@ -160,12 +194,12 @@ void PDF_PLOTTER::SetDash( int dashed )
  */
 void PDF_PLOTTER::Rect( const wxPoint& p1, const wxPoint& p2, FILL_T fill, int width )
 {
-    wxASSERT( workFile );
+    wxASSERT( streamCompressor );
     DPOINT p1_dev = userToDeviceCoordinates( p1 );
     DPOINT p2_dev = userToDeviceCoordinates( p2 );
 
     SetCurrentLineWidth( width );
-    fprintf( workFile, "%g %g %g %g re %c\n", p1_dev.x, p1_dev.y,
+    streamPrintf( "%g %g %g %g re %c\n", p1_dev.x, p1_dev.y,
              p2_dev.x - p1_dev.x, p2_dev.y - p1_dev.y,
              fill == NO_FILL ? 'S' : 'B' );
 }
@@ -176,7 +210,7 @@ void PDF_PLOTTER::Rect( const wxPoint& p1, const wxPoint& p2, FILL_T fill, int w
  */
 void PDF_PLOTTER::Circle( const wxPoint& pos, int diametre, FILL_T aFill, int width )
 {
-    wxASSERT( workFile );
+    wxASSERT( streamCompressor );
     DPOINT pos_dev = userToDeviceCoordinates( pos );
     double radius = userToDeviceSize( diametre / 2.0 );
 
@@ -200,11 +234,11 @@ void PDF_PLOTTER::Circle( const wxPoint& pos, int diametre, FILL_T aFill, int wi
     double magic = radius * 0.551784; // You don't want to know where this come from
 
     // This is the convex hull for the bezier approximated circle
-    fprintf( workFile, "%g %g m "
-                       "%g %g %g %g %g %g c "
-                       "%g %g %g %g %g %g c "
-                       "%g %g %g %g %g %g c "
-                       "%g %g %g %g %g %g c %c\n",
+    streamPrintf( "%g %g m "
+                  "%g %g %g %g %g %g c "
+                  "%g %g %g %g %g %g c "
+                  "%g %g %g %g %g %g c "
+                  "%g %g %g %g %g %g c %c\n",
              pos_dev.x - radius, pos_dev.y,
 
              pos_dev.x - radius, pos_dev.y + magic,
@@ -234,7 +268,7 @@ void PDF_PLOTTER::Circle( const wxPoint& pos, int diametre, FILL_T aFill, int wi
 void PDF_PLOTTER::Arc( const wxPoint& centre, double StAngle, double EndAngle, int radius,
                       FILL_T fill, int width )
 {
-    wxASSERT( workFile );
+    wxASSERT( streamCompressor );
     if( radius <= 0 )
     {
         Circle( centre, width, FILLED_SHAPE, 0 );
@@ -255,30 +289,30 @@ void PDF_PLOTTER::Arc( const wxPoint& centre, double StAngle, double EndAngle, i
     start.x = centre.x + KiROUND( cosdecideg( radius, -StAngle ) );
     start.y = centre.y + KiROUND( sindecideg( radius, -StAngle ) );
     DPOINT pos_dev = userToDeviceCoordinates( start );
-    fprintf( workFile, "%g %g m ", pos_dev.x, pos_dev.y );
+    streamPrintf( "%g %g m ", pos_dev.x, pos_dev.y );
     for( int ii = StAngle + delta; ii < EndAngle; ii += delta )
     {
         end.x = centre.x + KiROUND( cosdecideg( radius, -ii ) );
         end.y = centre.y + KiROUND( sindecideg( radius, -ii ) );
         pos_dev = userToDeviceCoordinates( end );
-        fprintf( workFile, "%g %g l ", pos_dev.x, pos_dev.y );
+        streamPrintf( "%g %g l ", pos_dev.x, pos_dev.y );
     }
 
     end.x = centre.x + KiROUND( cosdecideg( radius, -EndAngle ) );
     end.y = centre.y + KiROUND( sindecideg( radius, -EndAngle ) );
     pos_dev = userToDeviceCoordinates( end );
-    fprintf( workFile, "%g %g l ", pos_dev.x, pos_dev.y );
+    streamPrintf( "%g %g l ", pos_dev.x, pos_dev.y );
 
     // The arc is drawn... if not filled we stroke it, otherwise we finish
     // closing the pie at the center
     if( fill == NO_FILL )
     {
-        fputs( "S\n", workFile );
+        streamPuts( "S\n" );
     }
     else
     {
         pos_dev = userToDeviceCoordinates( centre );
-        fprintf( workFile, "%g %g l b\n", pos_dev.x, pos_dev.y );
+        streamPrintf( "%g %g l b\n", pos_dev.x, pos_dev.y );
     }
 }
 
@@ -289,34 +323,34 @@ void PDF_PLOTTER::Arc( const wxPoint& centre, double StAngle, double EndAngle, i
 void PDF_PLOTTER::PlotPoly( const std::vector< wxPoint >& aCornerList,
                            FILL_T aFill, int aWidth, void * aData )
 {
-    wxASSERT( workFile );
+    wxASSERT( streamCompressor );
     if( aCornerList.size() <= 1 )
         return;
 
     SetCurrentLineWidth( aWidth );
 
     DPOINT pos = userToDeviceCoordinates( aCornerList[0] );
-    fprintf( workFile, "%g %g m\n", pos.x, pos.y );
+    streamPrintf( "%g %g m\n", pos.x, pos.y );
 
     for( unsigned ii = 1; ii < aCornerList.size(); ii++ )
     {
         pos = userToDeviceCoordinates( aCornerList[ii] );
-        fprintf( workFile, "%g %g l\n", pos.x, pos.y );
+        streamPrintf( "%g %g l\n", pos.x, pos.y );
     }
 
     // Close path and stroke(/fill)
-    fprintf( workFile, "%c\n", aFill == NO_FILL ? 'S' : 'b' );
+    streamPrintf( "%c\n", aFill == NO_FILL ? 'S' : 'b' );
 }
 
 
 void PDF_PLOTTER::PenTo( const wxPoint& pos, char plume )
 {
-    wxASSERT( workFile );
+    wxASSERT( streamCompressor );
     if( plume == 'Z' )
     {
         if( penState != 'Z' )
         {
-            fputs( "S\n", workFile );
+            streamPuts( "S\n" );
             penState     = 'Z';
             penLastpos.x = -1;
             penLastpos.y = -1;
@@ -327,7 +361,7 @@ void PDF_PLOTTER::PenTo( const wxPoint& pos, char plume )
     if( penState != plume || pos != penLastpos )
     {
         DPOINT pos_dev = userToDeviceCoordinates( pos );
-        fprintf( workFile, "%g %g %c\n",
+        streamPrintf( "%g %g %c\n",
                  pos_dev.x, pos_dev.y,
                  ( plume=='D' ) ? 'l' : 'm' );
     }
@@ -341,7 +375,7 @@ void PDF_PLOTTER::PenTo( const wxPoint& pos, char plume )
 void PDF_PLOTTER::PlotImage( const wxImage & aImage, const wxPoint& aPos,
                             double aScaleFactor )
 {
-    wxASSERT( workFile );
+    wxASSERT( streamCompressor );
     wxSize pix_size( aImage.GetWidth(), aImage.GetHeight() );
 
     // Requested size (in IUs)
@@ -364,7 +398,7 @@ void PDF_PLOTTER::PlotImage( const wxImage & aImage, const wxPoint& aPos,
        3) restore the CTM
        4) profit
      */
-    fprintf( workFile, "q %g 0 0 %g %g %g cm\n", // Step 1
+    streamPrintf( "q %g 0 0 %g %g %g cm\n", // Step 1
             userToDeviceSize( drawsize.x ),
             userToDeviceSize( drawsize.y ),
             dev_start.x, dev_start.y );
@@ -373,7 +407,7 @@ void PDF_PLOTTER::PlotImage( const wxImage & aImage, const wxPoint& aPos,
        A real ugly construct (compared with the elegance of the PDF
        format). Also it accepts some 'abbreviations', which is stupid
        since the content stream is usually compressed anyway... */
-    fprintf( workFile,
+    streamPrintf(
              "BI\n"
              "  /BPC 8\n"
              "  /CS %s\n"
@@ -393,19 +427,19 @@ void PDF_PLOTTER::PlotImage( const wxImage & aImage, const wxPoint& aPos,
             // As usual these days, stdio buffering has to suffeeeeerrrr
             if( colorMode )
             {
-            putc( r, workFile );
-            putc( g, workFile );
-            putc( b, workFile );
+            streamPutc( r );
+            streamPutc( g );
+            streamPutc( b );
             }
             else
             {
                 // Grayscale conversion
-                putc( (r + g + b) / 3, workFile );
+                streamPutc( (r + g + b) / 3 );
             }
         }
     }
 
-    fputs( "EI Q\n", workFile ); // Finish step 2 and do step 3
+    streamPuts( "EI Q\n" ); // Finish step 2 and do step 3
 }
 
 
@@ -428,7 +462,7 @@ int PDF_PLOTTER::allocPdfObject()
 int PDF_PLOTTER::startPdfObject(int handle)
 {
     wxASSERT( outputFile );
-    wxASSERT( !workFile );
+    wxASSERT( !streamCompressor );
 
     if( handle < 0)
         handle = allocPdfObject();
@@ -445,7 +479,7 @@ int PDF_PLOTTER::startPdfObject(int handle)
 void PDF_PLOTTER::closePdfObject()
 {
     wxASSERT( outputFile );
-    wxASSERT( !workFile );
+    wxASSERT( !streamCompressor );
     fputs( "endobj\n", outputFile );
 }
 
@@ -459,7 +493,7 @@ void PDF_PLOTTER::closePdfObject()
 int PDF_PLOTTER::startPdfStream(int handle)
 {
     wxASSERT( outputFile );
-    wxASSERT( !workFile );
+    wxASSERT( !streamCompressor );
     handle = startPdfObject( handle );
 
     // This is guaranteed to be handle+1 but needs to be allocated since
@@ -469,10 +503,18 @@ int PDF_PLOTTER::startPdfStream(int handle)
              "<< /Length %d 0 R /Filter /FlateDecode >>\n" // Length is deferred
              "stream\n", handle + 1 );
 
-    // Open a temporary file to accumulate the stream
-    workFilename = filename + wxT(".tmp");
-    workFile = wxFopen( workFilename, wxT( "w+b" ));
-    wxASSERT( workFile );
+    // The stream is compressed on the fly, directly to the output file
+    streamStart      = ftell( outputFile );
+    streamOutput     = new FILE_OUTPUT_STREAM( outputFile );
+
+    /* Somewhat standard parameters to compress in DEFLATE. The PDF spec is
+     * misleading, it says it wants a DEFLATE stream but it really want a ZLIB
+     * stream! (a DEFLATE stream would be generated with -15 instead of 15)
+     * rc = deflateInit2( &zstrm, Z_BEST_COMPRESSION, Z_DEFLATED, 15,
+     *                    8, Z_DEFAULT_STRATEGY );
+     */
+    streamCompressor = new wxZlibOutputStream( *streamOutput, wxZ_BEST_COMPRESSION,
+                                               wxZLIB_ZLIB );
     return handle;
 }
 
@@ -482,61 +524,68 @@ int PDF_PLOTTER::startPdfStream(int handle)
  */
 void PDF_PLOTTER::closePdfStream()
 {
-    wxASSERT( workFile );
+    wxASSERT( streamCompressor );
 
-    long stream_len = ftell( workFile );
+    // Flush the zip stream using its destructor
+    delete streamCompressor;
+    streamCompressor = NULL;
+    delete streamOutput;
+    streamOutput = NULL;
 
-    if( stream_len < 0 )
-    {
-        wxASSERT( false );
-        return;
-    }
+    long out_count = ftell( outputFile ) - streamStart;
 
-    // Rewind the file, read in the page stream and DEFLATE it
-    fseek( workFile, 0, SEEK_SET );
-    unsigned char *inbuf = new unsigned char[stream_len];
+    fputs( "endstream\n", outputFile );
+    closePdfObject();
 
-    int rc = fread( inbuf, 1, stream_len, workFile );
-    wxASSERT( rc == stream_len );
-    (void) rc;
+    // Writing the deferred length as an indirect object
+    startPdfObject( streamLengthHandle );
+    fprintf( outputFile, "%ld\n", out_count );
+    closePdfObject();
+}
 
-    // We are done with the temporary file, junk it
-    fclose( workFile );
-    workFile = 0;
-    ::wxRemoveFile( workFilename );
 
-    // NULL means memos owns the memory, but provide a hint on optimum size needed.
-    wxMemoryOutputStream    memos( NULL, std::max( 2000l, stream_len ) ) ;
+void PDF_PLOTTER::streamPrintf( const char* aFormat, ... )
+{
+    wxASSERT( streamCompressor );
 
-    {
-        /* Somewhat standard parameters to compress in DEFLATE. The PDF spec is
-         * misleading, it says it wants a DEFLATE stream but it really want a ZLIB
-         * stream! (a DEFLATE stream would be generated with -15 instead of 15)
-         * rc = deflateInit2( &zstrm, Z_BEST_COMPRESSION, Z_DEFLATED, 15,
-         *                    8, Z_DEFAULT_STRATEGY );
-         */
+    char    buffer[256];
+    va_list args;
 
-        wxZlibOutputStream      zos( memos, wxZ_BEST_COMPRESSION, wxZLIB_ZLIB );
+    va_start( args, aFormat );
+    int len = vsnprintf( buffer, sizeof( buffer ), aFormat, args );
+    va_end( args );
 
-        zos.Write( inbuf, stream_len );
+    if( len < 0 )
+        return;
+
+    if( len < (int) sizeof( buffer ) )
+    {
+        streamCompressor->Write( buffer, len );
+        return;
+    }
 
-        delete[] inbuf;
+    // Not enough room for the whole text: format it again in a big enough buffer
+    std::vector<char> bigBuffer( len + 1 );
 
-    }   // flush the zip stream using zos destructor
+    va_start( args, aFormat );
+    vsnprintf( bigBuffer.data(), bigBuffer.size(), aFormat, args );
+    va_end( args );
 
-    wxStreamBuffer* sb = memos.GetOutputStreamBuffer();
+    streamCompressor->Write( bigBuffer.data(), len );
+}
 
-    unsigned out_count = sb->Tell();
 
-    fwrite( sb->GetBufferStart(), 1, out_count, outputFile );
+void PDF_PLOTTER::streamPuts( const char* aText )
+{
+    wxASSERT( streamCompressor );
+    streamCompressor->Write( aText, strlen( aText ) );
+}
 
-    fputs( "endstream\n", outputFile );
-    closePdfObject();
 
-    // Writing the deferred length as an indirect object
-    startPdfObject( streamLengthHandle );
-    fprintf( outputFile, "%u\n", out_count );
-    closePdfObject();
+void PDF_PLOTTER::streamPutc( int aChar )
+{
+    wxASSERT( streamCompressor );
+    streamCompressor->PutC( (char) aChar );
 }
 
 /**
@@ -545,7 +594,7 @@ void PDF_PLOTTER::closePdfStream()
 void PDF_PLOTTER::StartPage()
 {
     wxASSERT( outputFile );
-    wxASSERT( !workFile );
+    wxASSERT( !streamCompressor );
 
     // Compute the paper size in IUs
     paperSize = pageInfo.GetSizeMils();
@@ -555,11 +604,11 @@ void PDF_PLOTTER::StartPage()
     // Open the content stream; the page object will go later
     pageStreamHandle = startPdfStream();
 
-    /* Now, until ClosePage *everything* must be wrote in workFile, to be
-       compressed later in closePdfStream */
+    /* Now, until ClosePage *everything* must be written in the page stream, through
+       streamPrintf() and co */
 
     // Default graphic settings (coordinate system, default color and line style)
-    fprintf( workFile,
+    streamPrintf(
              "%g 0 0 %g 0 0 cm 1 J 1 j 0 0 0 rg 0 0 0 RG %g w\n",
              0.0072 * plotScaleAdjX, 0.0072 * plotScaleAdjY,
              userToDeviceSize( defaultPenWidth ) );
@@ -570,7 +619,7 @@ void PDF_PLOTTER::StartPage()
  */
 void PDF_PLOTTER::ClosePage()
 {
-    wxASSERT( workFile );
+    wxASSERT( streamCompressor );
 
     // Close the page stream (and compress it)
     closePdfStream();
@@ -829,14 +878,14 @@ void PDF_PLOTTER::Text( const wxPoint&              aPos,
        for the trig part of the matrix to avoid %g going in exponential
        format (which is not supported)
        render_mode 0 shows the text, render_mode 3 is invisible */
-    fprintf( workFile, "q %f %f %f %f %g %g cm BT %s %g Tf %d Tr %g Tz ",
+    streamPrintf( "q %f %f %f %f %g %g cm BT %s %g Tf %d Tr %g Tz ",
             ctm_a, ctm_b, ctm_c, ctm_d, ctm_e, ctm_f,
             fontname, heightFactor, render_mode,
             wideningFactor * 100 );
 
     // The text must be escaped correctly
-    fputsPostscriptString( workFile, aText );
-    fputs( " Tj ET\n", workFile );
+    streamPuts( postscriptString( aText ).c_str() );
+    streamPuts( " Tj ET\n" );
 
     // We are in text coordinates, plot the overbars, if we're not doing phantom text
     if( use_native_font )
@@ -852,13 +901,13 @@ void PDF_PLOTTER::Text( const wxPoint&              aPos,
                is the right function to use here... */
             DPOINT dev_from = userToDeviceSize( wxSize( pos_pairs[i], overbar_y ) );
             DPOINT dev_to = userToDeviceSize( wxSize( pos_pairs[i + 1], overbar_y ) );
-            fprintf( workFile, "%g %g m %g %g l ",
+            streamPrintf( "%g %g m %g %g l ",
                     dev_from.x, dev_from.y, dev_to.x, dev_to.y );
         }
     }
 
     // Stroke and restore the CTM
-    fputs( "S Q\n", workFile );
+    streamPuts( "S Q\n" );
 
     // Plot the stroked text (if requested)
     if( !use_native_font )
@@ -136,9 +136,8 @@ void PSLIKE_PLOTTER::FlashPadCircle( const wxPoint& aPadPos, int aDiameter,
 void PSLIKE_PLOTTER::FlashPadRect( const wxPoint& aPadPos, const wxSize& aSize,
                                    double aPadOrient, EDA_DRAW_MODE_T aTraceMode, void* aData )
 {
-    static std::vector< wxPoint > cornerList;
+    std::vector< wxPoint > cornerList;
     wxSize size( aSize );
-    cornerList.clear();
 
     if( aTraceMode == FILLED )
         SetCurrentLineWidth( 0 );
@@ -256,8 +255,7 @@ void PSLIKE_PLOTTER::FlashPadCustom( const wxPoint& aPadPos, const wxSize& aSize
 void PSLIKE_PLOTTER::FlashPadTrapez( const wxPoint& aPadPos, const wxPoint *aCorners,
                                      double aPadOrient, EDA_DRAW_MODE_T aTraceMode, void* aData )
 {
-    static std::vector< wxPoint > cornerList;
-    cornerList.clear();
+    std::vector< wxPoint > cornerList;
 
     for( int ii = 0; ii < 4; ii++ )
         cornerList.push_back( aCorners[ii] );
@@ -304,10 +302,18 @@ void PSLIKE_PLOTTER::FlashPadTrapez( const wxPoint& aPadPos, const wxPoint *aCor
  */
 void PSLIKE_PLOTTER::fputsPostscriptString(FILE *fout, const wxString& txt)
 {
-    putc( '(', fout );
+    std::string str = postscriptString( txt );
+
+    fwrite( str.data(), 1, str.size(), fout );
+}
+
+
+std::string PSLIKE_PLOTTER::postscriptString( const wxString& txt )
+{
+    std::string str( 1, '(' );
+
     for( unsigned i = 0; i < txt.length(); i++ )
     {
-        // Lazyness made me use stdio buffering yet another time...
         wchar_t ch = txt[i];
 
         if( ch < 256 )
@@ -321,17 +327,19 @@ void PSLIKE_PLOTTER::fputsPostscriptString(FILE *fout, const wxString& txt)
             case '(':
             case ')':
             case '\\':
-                putc( '\\', fout );
+                str += '\\';
 
                 // FALLTHRU
             default:
-                putc( ch, fout );
+                str += (char) ch;
                 break;
             }
         }
     }
 
-    putc( ')', fout );
+    str += ')';
+
+    return str;
 }
 
 
@@ -100,6 +100,14 @@
 #include <macros.h>
 #include <kicad_string.h>
 
+#include <wx/filename.h>
+#include <wx/wfstream.h>
+#include <wx/zstream.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdarg>
+
 
 
 /**
@@ -167,6 +175,89 @@ SVG_PLOTTER::SVG_PLOTTER()
     m_pen_rgb_color = 0;                // current color value (black)
     m_brush_rgb_color = 0;              // current color value (black)
     m_dashed = false;
+    m_compactOutput = false;
+    m_precision = 1;
+    m_gzipFile = NULL;
+    m_gzipStream = NULL;
+}
+
+
+SVG_PLOTTER::~SVG_PLOTTER()
+{
+    // Emergency cleanup, the compressed file is usually closed by EndPlot()
+    delete m_gzipStream;
+    delete m_gzipFile;
+}
+
+
+bool SVG_PLOTTER::OpenFile( const wxString& aFullFilename )
+{
+    wxASSERT( !m_gzipStream );
+
+    if( !wxFileName( aFullFilename ).GetExt().IsSameAs( GetCompressedFileExtension(), false ) )
+        return PLOTTER::OpenFile( aFullFilename );
+
+    // The svg text is compressed on the fly to the file: outputFile is not used
+    filename = aFullFilename;
+    m_gzipFile = new wxFFileOutputStream( aFullFilename, wxT( "wb" ) );
+
+    if( !m_gzipFile->IsOk() )
+    {
+        delete m_gzipFile;
+        m_gzipFile = NULL;
+        return false;
+    }
+
+    m_gzipStream = new wxZlibOutputStream( *m_gzipFile, wxZ_BEST_COMPRESSION, wxZLIB_GZIP );
+
+    return true;
+}
+
+
+void SVG_PLOTTER::svgPrintf( const char* aFormat, ... )
+{
+    va_list args;
+
+    if( !m_gzipStream )
+    {
+        va_start( args, aFormat );
+        vfprintf( outputFile, aFormat, args );
+        va_end( args );
+        return;
+    }
+
+    char buffer[256];
+
+    va_start( args, aFormat );
+    int len = vsnprintf( buffer, sizeof( buffer ), aFormat, args );
+    va_end( args );
+
+    if( len < 0 )
+        return;
+
+    if( len < (int) sizeof( buffer ) )
+    {
+        m_gzipStream->Write( buffer, len );
+        return;
+    }
+
+    // Not enough room for the whole text: format it again in a big enough buffer
+    std::vector<char> bigBuffer( len + 1 );
+
+    va_start( args, aFormat );
+    vsnprintf( bigBuffer.data(), bigBuffer.size(), aFormat, args );
+    va_end( args );
+
+    m_gzipStream->Write( bigBuffer.data(), len );
+}
+
+
+void SVG_PLOTTER::svgPuts( const char* aText )
+{
+    if( m_gzipStream )
+        m_gzipStream->Write( aText, strlen( aText ) );
+    else
+        fputs( aText, outputFile );
 }
 
 
@@ -208,48 +299,51 @@ void SVG_PLOTTER::setFillMode( FILL_T fill )
 
 void SVG_PLOTTER::setSVGPlotStyle()
 {
-    fputs( "</g>\n<g style=\"", outputFile );
-    fputs( "fill:#", outputFile );
+    // The shapes drawn with the previous style
+    flushPath();
+
+    svgPuts( "</g>\n<g style=\"" );
+    svgPuts( "fill:#" );
     // output the background fill color
-    fprintf( outputFile, "%6.6lX; ", m_brush_rgb_color );
+    svgPrintf( "%6.6lX; ", m_brush_rgb_color );
 
     switch( m_fillMode )
     {
     case NO_FILL:
-        fputs( "fill-opacity:0.0; ", outputFile );
+        svgPuts( "fill-opacity:0.0; " );
         break;
 
     case FILLED_SHAPE:
-        fputs( "fill-opacity:1.0; ", outputFile );
+        svgPuts( "fill-opacity:1.0; " );
         break;
 
     case FILLED_WITH_BG_BODYCOLOR:
-        fputs( "fill-opacity:0.6; ", outputFile );
+        svgPuts( "fill-opacity:0.6; " );
         break;
     }
 
     double pen_w = userToDeviceSize( GetCurrentLineWidth() );
-    fprintf( outputFile, "\nstroke:#%6.6lX; stroke-width:%g; stroke-opacity:1; \n",
-             m_pen_rgb_color, pen_w  );
-    fputs( "stroke-linecap:round; stroke-linejoin:round;", outputFile );
+    svgPrintf( "\nstroke:#%6.6lX; stroke-width:%g; stroke-opacity:1; \n",
+               m_pen_rgb_color, pen_w  );
+    svgPuts( "stroke-linecap:round; stroke-linejoin:round;" );
 
     switch( m_dashed )
     {
     case PLOTDASHTYPE_DASH:
-        fprintf( outputFile, "stroke-dasharray:%g,%g;",
-                 GetDashMarkLenIU(), GetDashGapLenIU() );
+        svgPrintf( "stroke-dasharray:%g,%g;",
+                   GetDashMarkLenIU(), GetDashGapLenIU() );
         break;
     case PLOTDASHTYPE_DOT:
-        fprintf( outputFile, "stroke-dasharray:%g,%g;",
-                 GetDotMarkLenIU(), GetDashGapLenIU() );
+        svgPrintf( "stroke-dasharray:%g,%g;",
+                   GetDotMarkLenIU(), GetDashGapLenIU() );
         break;
     case PLOTDASHTYPE_DASHDOT:
-        fprintf( outputFile, "stroke-dasharray:%g,%g,%g,%g;",
-                GetDashMarkLenIU(), GetDashGapLenIU(), GetDotMarkLenIU(), GetDashGapLenIU() );
+        svgPrintf( "stroke-dasharray:%g,%g,%g,%g;",
+                  GetDashMarkLenIU(), GetDashGapLenIU(), GetDotMarkLenIU(), GetDashGapLenIU() );
         break;
     }
 
-    fputs( "\">\n", outputFile );
+    svgPuts( "\">\n" );
 
     m_graphics_changed = false;
 }
@@ -330,22 +424,44 @@ void SVG_PLOTTER::Rect( const wxPoint& p1, const wxPoint& p2, FILL_T fill, int w
     setFillMode( fill );
     SetCurrentLineWidth( width );
 
+    if( m_compactOutput )
+    {
+        DPOINT org = rect_dev.GetPosition();
+        DPOINT end = rect_dev.GetEnd();
+
+        pathTo( org, 'm' );
+
+        if( rect_dev.GetSize().x == 0.0 || rect_dev.GetSize().y == 0.0 )
+        {
+            pathTo( end, 'l' );
+        }
+        else
+        {
+            pathTo( DPOINT( end.x, org.y ), 'l' );
+            pathTo( end, 'l' );
+            pathTo( DPOINT( org.x, end.y ), 'l' );
+            closePath();
+        }
+
+        return;
+    }
+
     // Rectangles having a 0 size value for height or width are just not drawn on Inscape,
     // so use a line when happens.
     if( rect_dev.GetSize().x == 0.0 || rect_dev.GetSize().y == 0.0 )    // Draw a line
-        fprintf( outputFile,
-                 "<line x1=\"%g\" y1=\"%g\" x2=\"%g\" y2=\"%g\" />\n",
-                 rect_dev.GetPosition().x, rect_dev.GetPosition().y,
-                 rect_dev.GetEnd().x, rect_dev.GetEnd().y
-                 );
+        svgPrintf(
+                   "<line x1=\"%g\" y1=\"%g\" x2=\"%g\" y2=\"%g\" />\n",
+                   rect_dev.GetPosition().x, rect_dev.GetPosition().y,
+                   rect_dev.GetEnd().x, rect_dev.GetEnd().y
+                   );
 
     else
-        fprintf( outputFile,
-                 "<rect x=\"%g\" y=\"%g\" width=\"%g\" height=\"%g\" rx=\"%g\" />\n",
-                 rect_dev.GetPosition().x, rect_dev.GetPosition().y,
-                 rect_dev.GetSize().x, rect_dev.GetSize().y,
-                 0.0   // radius of rounded corners
-                 );
+        svgPrintf(
+                   "<rect x=\"%g\" y=\"%g\" width=\"%g\" height=\"%g\" rx=\"%g\" />\n",
+                   rect_dev.GetPosition().x, rect_dev.GetPosition().y,
+                   rect_dev.GetSize().x, rect_dev.GetSize().y,
+                   0.0   // radius of rounded corners
+                   );
 }
 
 
@@ -366,9 +482,21 @@ void SVG_PLOTTER::Circle( const wxPoint& pos, int diametre, FILL_T fill, int wid
         radius = userToDeviceSize( ( diametre / 2.0 ) + ( width / 2.0 ) );
     }
 
-    fprintf( outputFile,
-             "<circle cx=\"%g\" cy=\"%g\" r=\"%g\" /> \n",
-             pos_dev.x, pos_dev.y, radius );
+    if( m_compactOutput )
+    {
+        // Two half circles, drawn clockwise like all the filled shapes of a path
+        DPOINT start( pos_dev.x - radius, pos_dev.y );
+
+        pathTo( start, 'm' );
+        pathArcTo( DPOINT( pos_dev.x + radius, pos_dev.y ), radius, false, true );
+        pathArcTo( start, radius, false, true );
+        closePath();
+        return;
+    }
+
+    svgPrintf(
+               "<circle cx=\"%g\" cy=\"%g\" r=\"%g\" /> \n",
+               pos_dev.x, pos_dev.y, radius );
 }
 
 
@@ -450,15 +578,22 @@ void SVG_PLOTTER::Arc( const wxPoint& centre, double StAngle, double EndAngle, i
 
     int flg_sweep = 0;             // flag for sweep always 0
 
+    if( m_compactOutput )
+    {
+        pathTo( start, 'm' );
+        pathArcTo( end, radius_dev, flg_arc, flg_sweep );
+        return;
+    }
+
     // Draw a single arc: an arc is one of 3 curve commands (2 other are 2 bezier curves)
     // params are start point, radius1, radius2, X axe rotation,
     // flag arc size (0 = small arc > 180 deg, 1 = large arc > 180 deg),
     // sweep arc ( 0 = CCW, 1 = CW),
     // end point
-    fprintf( outputFile, "<path d=\"M%g %g A%g %g 0.0 %d %d %g %g \" />\n",
-             start.x, start.y, radius_dev, radius_dev,
-             flg_arc, flg_sweep,
-             end.x, end.y  );
+    svgPrintf( "<path d=\"M%g %g A%g %g 0.0 %d %d %g %g \" />\n",
+               start.x, start.y, radius_dev, radius_dev,
+               flg_arc, flg_sweep,
+               end.x, end.y  );
 }
 
 
@@ -471,25 +606,56 @@ void SVG_PLOTTER::PlotPoly( const std::vector<wxPoint>& aCornerList,
     setFillMode( aFill );
     SetCurrentLineWidth( aWidth );
 
+    if( m_compactOutput )
+    {
+        std::vector<DPOINT> points;
+
+        for( const wxPoint& corner : aCornerList )
+            points.push_back( userToDeviceCoordinates( corner ) );
+
+        // The shapes of a path are filled using the nonzero rule, so overlapping filled
+        // polygons must have the same orientation (clockwise, like circles and rects)
+        if( aFill != NO_FILL )
+        {
+            double area = 0.0;
+
+            for( size_t ii = 0, jj = points.size() - 1; ii < points.size(); jj = ii++ )
+                area += points[jj].x * points[ii].y - points[ii].x * points[jj].y;
+
+            if( area < 0.0 )
+                std::reverse( points.begin(), points.end() );
+        }
+
+        pathTo( points[0], 'm' );
+
+        for( size_t ii = 1; ii < points.size(); ii++ )
+            pathTo( points[ii], 'l' );
+
+        if( aFill != NO_FILL )
+            closePath();
+
+        return;
+    }
+
     switch( aFill )
     {
     case NO_FILL:
-        fprintf( outputFile, "<polyline fill=\"none;\"\n" );
+        svgPrintf( "<polyline fill=\"none;\"\n" );
         break;
 
     case FILLED_WITH_BG_BODYCOLOR:
     case FILLED_SHAPE:
-        fprintf( outputFile, "<polyline style=\"fill-rule:evenodd;\"\n" );
+        svgPrintf( "<polyline style=\"fill-rule:evenodd;\"\n" );
         break;
     }
 
     DPOINT pos = userToDeviceCoordinates( aCornerList[0] );
-    fprintf( outputFile, "points=\"%d,%d\n", (int) pos.x, (int) pos.y );
+    svgPrintf( "points=\"%d,%d\n", (int) pos.x, (int) pos.y );
 
     for( unsigned ii = 1; ii < aCornerList.size(); ii++ )
     {
         pos = userToDeviceCoordinates( aCornerList[ii] );
-        fprintf( outputFile, "%d,%d\n", (int) pos.x, (int) pos.y );
+        svgPrintf( "%d,%d\n", (int) pos.x, (int) pos.y );
     }
 
     // ensure the shape is closed, for filled shapes (that are closed polygons):
@@ -497,11 +663,11 @@ void SVG_PLOTTER::PlotPoly( const std::vector<wxPoint>& aCornerList,
     if( aCornerList.front() != aCornerList.back() && aFill != NO_FILL )
     {
         pos = userToDeviceCoordinates( aCornerList.front() );
-        fprintf( outputFile, "%d,%d\n", (int) pos.x, (int) pos.y );
+        svgPrintf( "%d,%d\n", (int) pos.x, (int) pos.y );
     }
 
     // Close/(fill) the path
-    fprintf( outputFile, "\" /> \n" );
+    svgPrintf( "\" /> \n" );
 }
 
 
@@ -523,11 +689,38 @@ void SVG_PLOTTER::PlotImage( const wxImage& aImage, const wxPoint& aPos,
 
 void SVG_PLOTTER::PenTo( const wxPoint& pos, char plume )
 {
+    if( m_compactOutput )
+    {
+        if( plume == 'Z' )
+        {
+            penState        = 'Z';
+            penLastpos.x    = -1;
+            penLastpos.y    = -1;
+            return;
+        }
+
+        // Plotting only basic lines, not a filled area
+        if( penState == 'Z' && m_fillMode != NO_FILL )
+        {
+            setFillMode( NO_FILL );
+            setSVGPlotStyle();
+        }
+
+        if( penState == 'Z' || plume == 'U' )
+            pathTo( userToDeviceCoordinates( pos ), 'm' );
+        else if( pos != penLastpos )
+            pathTo( userToDeviceCoordinates( pos ), 'l' );
+
+        penState    = plume;
+        penLastpos  = pos;
+        return;
+    }
+
     if( plume == 'Z' )
     {
         if( penState != 'Z' )
         {
-            fputs( "\" />\n", outputFile );
+            svgPuts( "\" />\n" );
             penState        = 'Z';
             penLastpos.x    = -1;
             penLastpos.y    = -1;
@@ -548,14 +741,14 @@ void SVG_PLOTTER::PenTo( const wxPoint& pos, char plume )
             setSVGPlotStyle();
         }
 
-        fprintf( outputFile, "<path d=\"M%d %d\n",
-                 (int) pos_dev.x, (int) pos_dev.y );
+        svgPrintf( "<path d=\"M%d %d\n",
+                   (int) pos_dev.x, (int) pos_dev.y );
     }
     else if( penState != plume || pos != penLastpos )
     {
         DPOINT pos_dev = userToDeviceCoordinates( pos );
-        fprintf( outputFile, "L%d %d\n",
-                 (int) pos_dev.x, (int) pos_dev.y );
+        svgPrintf( "L%d %d\n",
+                   (int) pos_dev.x, (int) pos_dev.y );
     }
 
     penState    = plume;
@@ -569,7 +762,7 @@ void SVG_PLOTTER::PenTo( const wxPoint& pos, char plume )
  */
 bool SVG_PLOTTER::StartPlot()
 {
-    wxASSERT( outputFile );
+    wxASSERT( outputFile || m_gzipStream );
     wxString            msg;
 
     static const char*  header[] =
@@ -584,18 +777,18 @@ bool SVG_PLOTTER::StartPlot()
     // Write header.
     for( int ii = 0; header[ii] != NULL; ii++ )
     {
-        fputs( header[ii], outputFile );
+        svgPuts( header[ii] );
     }
 
     // Write viewport pos and size
     wxPoint origin;    // TODO set to actual value
-    fprintf( outputFile,
-             "    width=\"%gcm\" height=\"%gcm\" viewBox=\"%d %d %d %d \">\n",
-             (double) paperSize.x / m_IUsPerDecimil * 2.54 / 10000,
-             (double) paperSize.y / m_IUsPerDecimil * 2.54 / 10000,
-             origin.x, origin.y,
-             (int) ( paperSize.x / m_IUsPerDecimil ),
-             (int) ( paperSize.y / m_IUsPerDecimil) );
+    svgPrintf(
+               "    width=\"%gcm\" height=\"%gcm\" viewBox=\"%d %d %d %d \">\n",
+               (double) paperSize.x / m_IUsPerDecimil * 2.54 / 10000,
+               (double) paperSize.y / m_IUsPerDecimil * 2.54 / 10000,
+               origin.x, origin.y,
+               (int) ( paperSize.x / m_IUsPerDecimil ),
+               (int) ( paperSize.y / m_IUsPerDecimil) );
 
     // Write title
     char    date_buf[250];
@@ -603,33 +796,138 @@ bool SVG_PLOTTER::StartPlot()
     strftime( date_buf, 250, "%Y/%m/%d %H:%M:%S",
               localtime( &ltime ) );
 
-    fprintf( outputFile,
-             "<title>SVG Picture created as %s date %s </title>\n",
-             TO_UTF8( XmlEsc( wxFileName( filename ).GetFullName() ) ), date_buf );
+    svgPrintf(
+               "<title>SVG Picture created as %s date %s </title>\n",
+               TO_UTF8( XmlEsc( wxFileName( filename ).GetFullName() ) ), date_buf );
     // End of header
-    fprintf( outputFile, "  <desc>Picture generated by %s </desc>\n",
-             TO_UTF8( XmlEsc( creator ) ) );
+    svgPrintf( "  <desc>Picture generated by %s </desc>\n",
+               TO_UTF8( XmlEsc( creator ) ) );
 
     // output the pen and brush color (RVB values in hex) and opacity
     double opacity = 1.0;      // 0.0 (transparent to 1.0 (solid)
-    fprintf( outputFile,
-             "<g style=\"fill:#%6.6lX; fill-opacity:%g;stroke:#%6.6lX; stroke-opacity:%g;\n",
-             m_brush_rgb_color, opacity, m_pen_rgb_color, opacity );
+    svgPrintf(
+               "<g style=\"fill:#%6.6lX; fill-opacity:%g;stroke:#%6.6lX; stroke-opacity:%g;\n",
+               m_brush_rgb_color, opacity, m_pen_rgb_color, opacity );
 
     // output the pen cap and line joint
-    fputs( "stroke-linecap:round; stroke-linejoin:round; \"\n", outputFile );
-    fputs( " transform=\"translate(0 0) scale(1 1)\">\n", outputFile );
+    svgPuts( "stroke-linecap:round; stroke-linejoin:round; \"\n" );
+    svgPuts( " transform=\"translate(0 0) scale(1 1)\">\n" );
     return true;
 }
 
 
 bool SVG_PLOTTER::EndPlot()
 {
-    fputs( "</g> \n</svg>\n", outputFile );
-    fclose( outputFile );
-    outputFile = NULL;
+    flushPath();
 
-    return true;
+    svgPuts( "</g> \n</svg>\n" );
+
+    if( !m_gzipStream )
+    {
+        fclose( outputFile );
+        outputFile = NULL;
+        return true;
+    }
+
+    bool success = m_gzipStream->Close() && m_gzipFile->Close();
+
+    delete m_gzipStream;
+    m_gzipStream = NULL;
+    delete m_gzipFile;
+    m_gzipFile = NULL;
+
+    return success;
+}
+
+
+double SVG_PLOTTER::roundToPrecision( double aValue ) const
+{
+    double scale = pow( 10.0, m_precision );
+
+    return std::round( aValue * scale ) / scale;
+}
+
+
+void SVG_PLOTTER::appendPathValue( double aValue )
+{
+    char buffer[64];
+
+    snprintf( buffer, sizeof( buffer ), "%.*f", m_precision, aValue );
+
+    // Remove the useless trailing zeros and decimal point
+    size_t len = strlen( buffer );
+
+    if( strchr( buffer, '.' ) )
+    {
+        while( buffer[len - 1] == '0' )
+            buffer[--len] = 0;
+
+        if( buffer[len - 1] == '.' )
+            buffer[--len] = 0;
+    }
+
+    const char* text = strcmp( buffer, "-0" ) ? buffer : "0";
+
+    // A minus sign also separates values
+    if( !m_pathData.empty() && !isalpha( (unsigned char) m_pathData.back() ) && text[0] != '-' )
+        m_pathData += ' ';
+
+    m_pathData += text;
+}
+
+
+void SVG_PLOTTER::pathTo( const DPOINT& aPos, char aCommand )
+{
+    // Relative coordinates are computed from rounded positions, so rounding errors do not
+    // accumulate along the path
+    DPOINT pos( roundToPrecision( aPos.x ), roundToPrecision( aPos.y ) );
+
+    m_pathData += aCommand;
+    appendPathValue( pos.x - m_pathPos.x );
+    appendPathValue( pos.y - m_pathPos.y );
+
+    m_pathPos = pos;
+
+    if( aCommand == 'm' )
+        m_pathStart = pos;
+}
+
+
+void SVG_PLOTTER::pathArcTo( const DPOINT& aPos, double aRadius, bool aLargeArc, bool aSweep )
+{
+    DPOINT pos( roundToPrecision( aPos.x ), roundToPrecision( aPos.y ) );
+
+    m_pathData += 'a';
+    appendPathValue( aRadius );
+    appendPathValue( aRadius );
+    m_pathData += aLargeArc ? " 0 1" : " 0 0";
+    m_pathData += aSweep ? " 1" : " 0";
+    appendPathValue( pos.x - m_pathPos.x );
+    appendPathValue( pos.y - m_pathPos.y );
+
+    m_pathPos = pos;
+}
+
+
+void SVG_PLOTTER::closePath()
+{
+    m_pathData += 'z';
+    m_pathPos = m_pathStart;
+}
+
+
+void SVG_PLOTTER::flushPath()
+{
+    if( m_pathData.empty() )
+        return;
+
+    // The path can be long: it is not formatted
+    svgPuts( "<path d=\"" );
+    svgPuts( m_pathData.c_str() );
+    svgPuts( "\"/>\n" );
+
+    m_pathData.clear();
+    m_pathPos = DPOINT( 0, 0 );
 }
 
 
@@ -22,6 +22,12 @@
 
 #include <ctype.h>
 #include <algorithm>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
 
 #include <wx/mstream.h>
 #include <wx/filename.h>
@@ -481,6 +487,35 @@ class SCH_LEGACY_PLUGIN_CACHE
     int             m_versionMinor;
     int             m_libType;      // Is this cache a component or symbol library.
 
+    /// Location and alias names of a symbol which was not yet loaded from the library file.
+    struct PART_INDEX_ENTRY
+    {
+        long int        m_filePos;      // Position of the DEF line in the library file.
+        unsigned        m_lineNumber;   // Line number before the DEF line, for error reports.
+        wxArrayString   m_aliasNames;   // Root alias name first.
+        bool            m_isPower;
+        bool            m_isLoaded;
+    };
+
+    /// Documentation of an alias whose symbol was not yet loaded from the library file.
+    struct ALIAS_DOC
+    {
+        wxString        m_description;
+        wxString        m_keyWords;
+        wxString        m_docFileName;
+    };
+
+    // Symbols are only indexed when the library is loaded.  The LIB_PART objects are built
+    // on first request, so large libraries only pay for the symbols which are used.
+    std::vector< PART_INDEX_ENTRY >     m_partIndex;
+    std::map< wxString, size_t >        m_indexedAliases;  // Alias name to m_partIndex entry.
+    std::map< wxString, ALIAS_DOC >     m_indexedDocs;
+
+    bool            loadIndex( FILE_LINE_READER& aReader );
+    void            loadIndexedPart( FILE_LINE_READER& aReader, PART_INDEX_ENTRY& aEntry );
+    LIB_ALIAS*      findAlias( const wxString& aAliasName );
+    void            loadAllParts();
+
     LIB_PART*       loadPart( FILE_LINE_READER& aReader );
     void            loadHeader( FILE_LINE_READER& aReader );
     void            loadAliases( std::unique_ptr< LIB_PART >& aPart, FILE_LINE_READER& aReader );
@@ -580,6 +615,10 @@ void SCH_LEGACY_PLUGIN::init( KIWAY* aKiway, const PROPERTIES* aProperties )
     m_kiway = aKiway;
     m_cache = NULL;
     m_out = NULL;
+    m_fixedOnLoad = false;
+    m_deferBitmaps = false;
+    m_preloadedScreens.clear();
+    m_preloadErrors.clear();
 }
 
 
@@ -626,8 +665,19 @@ SCH_SHEET* SCH_LEGACY_PLUGIN::Load( const wxString& aFileName, KIWAY* aKiway,
         std::unique_ptr< SCH_SHEET > newSheet( new SCH_SHEET );
         newSheet->SetFileName( aFileName );
         m_rootSheet = newSheet.get();
+
+        // Parse all the sheet files of the hierarchy in parallel, loadHierarchy() then only
+        // has to link the sheets to their screens.
+        preloadHierarchy( aFileName );
         loadHierarchy( newSheet.get() );
 
+        // Sheets which could not be matched to their preloaded screen loaded their own copy.
+        m_preloadedScreens.clear();
+        m_preloadErrors.clear();
+
+        if( m_fixedOnLoad && m_rootSheet->GetScreen() )
+            m_rootSheet->GetScreen()->SetModify();
+
         // If we got here, the schematic loaded successfully.
         sheet = newSheet.release();
     }
@@ -643,6 +693,123 @@ SCH_SHEET* SCH_LEGACY_PLUGIN::Load( const wxString& aFileName, KIWAY* aKiway,
 }
 
 
+void SCH_LEGACY_PLUGIN::preloadHierarchy( const wxString& aRootFileName )
+{
+    // The hierarchy is walked one level at a time: all the files of a level are parsed in
+    // parallel and the sheets found in them give the files of the next level.  Files used by
+    // several sheets are only parsed once.
+    std::vector< wxString > pending( 1, aRootFileName );
+    std::set< wxString >    found( pending.begin(), pending.end() );
+
+    // The default field names are cached in function-local statics on their first use,
+    // fill them here so the worker threads only read them.
+    for( int ii = 0; ii < MANDATORY_FIELDS; ++ii )
+        TEMPLATE_FIELDNAME::GetDefaultFieldName( ii );
+
+    while( !pending.empty() )
+    {
+        std::vector< SCH_SCREEN* >      screens;
+        std::vector< bool >             failed( pending.size(), false );    // Guarded by errorLock.
+
+        // SCH_SCREEN objects are created here, the worker threads only parse the files.
+        for( const wxString& fileName : pending )
+        {
+            SCH_SCREEN* screen = new SCH_SCREEN( m_kiway );
+            screen->SetFileName( fileName );
+            screens.push_back( screen );
+            m_preloadedScreens[ fileName ].reset( screen );
+        }
+
+        std::atomic< size_t >       nextFile( 0 );
+        std::atomic< bool >         fixedOnLoad( false );
+        std::vector< std::thread >  threads;
+        size_t threadCount = std::min< size_t >( pending.size(),
+                                                 std::max( 1U, std::thread::hardware_concurrency() ) );
+        std::mutex                  errorLock;
+
+        wxLogTrace( traceSchLegacyPlugin, "Preloading %d sheet files with %d threads.",
+                    (int) pending.size(), (int) threadCount );
+
+        for( size_t ii = 0; ii < threadCount; ++ii )
+        {
+            threads.push_back( std::thread( [&]() {
+                // Each thread has its own parser state (file version, error message).
+                SCH_LEGACY_PLUGIN parser;
+
+                parser.init( m_kiway, m_props );
+                parser.m_deferBitmaps = true;
+
+                for( size_t jj = nextFile++; jj < pending.size(); jj = nextFile++ )
+                {
+                    try
+                    {
+                        parser.loadFile( pending[jj], screens[jj] );
+                    }
+                    catch( const IO_ERROR& ioe )
+                    {
+                        std::lock_guard< std::mutex > lock( errorLock );
+                        m_preloadErrors[ pending[jj] ] = ioe;
+                        failed[jj] = true;
+                    }
+                    catch( const std::exception& se )
+                    {
+                        std::lock_guard< std::mutex > lock( errorLock );
+                        m_preloadErrors[ pending[jj] ] = IO_ERROR( se.what(), __FILE__,
+                                                                   __FUNCTION__, __LINE__ );
+                        failed[jj] = true;
+                    }
+                }
+
+                if( parser.m_fixedOnLoad )
+                    fixedOnLoad = true;
+            } ) );
+        }
+
+        for( auto& thread : threads )
+            thread.join();
+
+        if( fixedOnLoad )
+            m_fixedOnLoad = true;
+
+        std::vector< wxString > next;
+
+        for( size_t ii = 0; ii < pending.size(); ++ii )
+        {
+            // Like loadHierarchy(), do not descend into files which failed to load.
+            if( failed[ii] )
+                continue;
+
+            wxFileName parentFileName( pending[ii] );
+
+            for( EDA_ITEM* item = screens[ii]->GetDrawItems(); item; item = item->Next() )
+            {
+                if( item->Type() == SCH_BITMAP_T )
+                {
+                    // wxBitmap objects can only be created on the main thread.
+                    BITMAP_BASE* image = static_cast< SCH_BITMAP* >( item )->GetImage();
+
+                    if( image->GetImageData() )
+                        image->SetBitmap( new wxBitmap( *image->GetImageData() ) );
+                }
+                else if( item->Type() == SCH_SHEET_T )
+                {
+                    // Same file name resolution as loadHierarchy().
+                    wxFileName fileName = static_cast< SCH_SHEET* >( item )->GetFileName();
+
+                    if( !fileName.IsAbsolute() )
+                        fileName.MakeAbsolute( parentFileName.GetPath() );
+
+                    if( found.insert( fileName.GetFullPath() ).second )
+                        next.push_back( fileName.GetFullPath() );
+                }
+            }
+        }
+
+        pending.swap( next );
+    }
+}
+
+
 // Everything below this comment is recursive.  Modify with care.
 
 void SCH_LEGACY_PLUGIN::loadHierarchy( SCH_SHEET* aSheet )
@@ -680,12 +847,26 @@ void SCH_LEGACY_PLUGIN::loadHierarchy( SCH_SHEET* aSheet )
         }
         else
         {
-            aSheet->SetScreen( new SCH_SCREEN( m_kiway ) );
-            aSheet->GetScreen()->SetFileName( fileName.GetFullPath() );
+            auto preloaded = m_preloadedScreens.find( fileName.GetFullPath() );
+            bool isPreloaded = ( preloaded != m_preloadedScreens.end() );
+
+            if( isPreloaded )
+            {
+                aSheet->SetScreen( preloaded->second.release() );
+                m_preloadedScreens.erase( preloaded );
+            }
+            else
+            {
+                aSheet->SetScreen( new SCH_SCREEN( m_kiway ) );
+                aSheet->GetScreen()->SetFileName( fileName.GetFullPath() );
+            }
 
             try
             {
-                loadFile( fileName.GetFullPath(), aSheet->GetScreen() );
+                if( !isPreloaded )
+                    loadFile( fileName.GetFullPath(), aSheet->GetScreen() );
+                else if( m_preloadErrors.count( fileName.GetFullPath() ) )
+                    throw m_preloadErrors[ fileName.GetFullPath() ];
 
                 EDA_ITEM* item = aSheet->GetScreen()->GetDrawItems();
 
@@ -1103,7 +1284,10 @@ SCH_BITMAP* SCH_LEGACY_PLUGIN::loadBitmap( FILE_LINE_READER& aReader )
                     wxMemoryInputStream istream( stream );
                     image->LoadFile( istream, wxBITMAP_TYPE_PNG );
                     bitmap->GetImage()->SetImage( image );
-                    bitmap->GetImage()->SetBitmap( new wxBitmap( *image ) );
+
+                    if( !m_deferBitmaps )
+                        bitmap->GetImage()->SetBitmap( new wxBitmap( *image ) );
+
                     break;
                 }
 
@@ -1481,6 +1665,8 @@ SCH_COMPONENT* SCH_LEGACY_PLUGIN::loadComponent( FILE_LINE_READER& aReader )
                 // Set the file as modified so the user can be warned.
                 if( m_rootSheet && m_rootSheet->GetScreen() )
                     m_rootSheet->GetScreen()->SetModify();
+
+                m_fixedOnLoad = true;
             }
 
             component->SetUnit( unit );
@@ -2282,6 +2468,8 @@ LIB_ALIAS* SCH_LEGACY_PLUGIN_CACHE::removeAlias( LIB_ALIAS* aAlias )
 
 void SCH_LEGACY_PLUGIN_CACHE::AddSymbol( const LIB_PART* aPart )
 {
+    loadAllParts();
+
     // aPart is cloned in PART_LIB::AddPart().  The cache takes ownership of aPart.
     wxArrayString aliasNames = aPart->GetAliasNames();
 
@@ -2355,21 +2543,35 @@ void SCH_LEGACY_PLUGIN_CACHE::Load()
         m_libType = LIBRARY_TYPE_EESCHEMA;
     }
 
-    while( reader.ReadLine() )
-    {
-        line = reader.Line();
+    long int firstLinePos = reader.CurPos();
 
-        if( *line == '#' || isspace( *line ) )  // Skip comments and blank lines.
-            continue;
+    if( !loadIndex( reader ) )
+    {
+        // Libraries with duplicate alias names need the renaming done by loadPart() so they
+        // are loaded completely.
+        wxLogTrace( traceSchLegacyPlugin, "Duplicate alias names in \"%s\", loading all symbols",
+                    m_libFileName.GetFullPath() );
 
-        // Headers where only supported in older library file formats.
-        if( m_libType == LIBRARY_TYPE_EESCHEMA && strCompare( "$HEADER", line ) )
-            loadHeader( reader );
+        m_partIndex.clear();
+        m_indexedAliases.clear();
+        reader.Seek( firstLinePos, 1 );
 
-        if( strCompare( "DEF", line ) )
+        while( reader.ReadLine() )
         {
-            // Read one DEF/ENDDEF part entry from library:
-            loadPart( reader );
+            line = reader.Line();
+
+            if( *line == '#' || isspace( *line ) )  // Skip comments and blank lines.
+                continue;
+
+            // Headers where only supported in older library file formats.
+            if( m_libType == LIBRARY_TYPE_EESCHEMA && strCompare( "$HEADER", line ) )
+                loadHeader( reader );
+
+            if( strCompare( "DEF", line ) )
+            {
+                // Read one DEF/ENDDEF part entry from library:
+                loadPart( reader );
+            }
         }
     }
 
@@ -2385,13 +2587,190 @@ void SCH_LEGACY_PLUGIN_CACHE::Load()
 }
 
 
+bool SCH_LEGACY_PLUGIN_CACHE::loadIndex( FILE_LINE_READER& aReader )
+{
+    long int    pos = aReader.CurPos();
+    const char* line;
+
+    while( aReader.ReadLine() )
+    {
+        line = aReader.Line();
+
+        if( strCompare( "DEF", line, &line ) )
+        {
+            PART_INDEX_ENTRY entry;
+            wxString         name, prefix;
+
+            entry.m_filePos = pos;
+            entry.m_lineNumber = aReader.LineNumber() - 1;
+            entry.m_isPower = false;
+            entry.m_isLoaded = false;
+
+            // Same DEF line parsing as loadPart(), only the name and the power flag are kept.
+            parseUnquotedString( name, aReader, line, &line );           // Part name.
+            parseUnquotedString( prefix, aReader, line, &line );         // Prefix name
+            parseInt( aReader, line, &line );                            // NumOfPins
+            parseInt( aReader, line, &line );                            // Pin name offset.
+            parseChar( aReader, line, &line );                           // Show pin numbers.
+            parseChar( aReader, line, &line );                           // Show pin names.
+            parseInt( aReader, line, &line );                            // Number of units.
+
+            if( LIB_VERSION( m_versionMajor, m_versionMinor ) <= LIB_VERSION( 2, 2 ) )
+                parseInt( aReader, line, &line );
+            else
+                parseChar( aReader, line, &line );                       // Locked units.
+
+            if( *line )
+                entry.m_isPower = ( parseChar( aReader, line, &line ) == 'P' );
+
+            if( name[0] == '~' )
+                name = name.Right( name.Length() - 1 );
+
+            // LIB_ALIAS::SetName() does the same.
+            ReplaceIllegalFileNameChars( name, '_' );
+            entry.m_aliasNames.Add( name );
+
+            // Only the alias names are needed from the symbol body.
+            bool inDraw = false;
+            bool inFpList = false;
+
+            while( true )
+            {
+                line = aReader.ReadLine();
+
+                if( !line )
+                    SCH_PARSE_ERROR( "missing ENDDEF", aReader, line );
+
+                if( inDraw )
+                    inDraw = !strCompare( "ENDDRAW", line );
+                else if( inFpList )
+                    inFpList = !strCompare( "$ENDFPLIST", line );
+                else if( strCompare( "DRAW", line ) )
+                    inDraw = true;
+                else if( strCompare( "$FPLIST", line ) )
+                    inFpList = true;
+                else if( strCompare( "ALIAS", line, &line ) )
+                {
+                    wxString alias;
+                    parseUnquotedString( alias, aReader, line, &line );
+
+                    while( !alias.IsEmpty() )
+                    {
+                        ReplaceIllegalFileNameChars( alias, '_' );
+                        entry.m_aliasNames.Add( alias );
+                        alias.clear();
+                        parseUnquotedString( alias, aReader, line, &line, true );
+                    }
+                }
+                else if( strCompare( "ENDDEF", line ) )
+                {
+                    break;
+                }
+            }
+
+            for( size_t ii = 0; ii < entry.m_aliasNames.size(); ++ii )
+            {
+                if( m_indexedAliases.count( entry.m_aliasNames[ii] ) )
+                    return false;
+
+                m_indexedAliases[ entry.m_aliasNames[ii] ] = m_partIndex.size();
+            }
+
+            m_partIndex.push_back( entry );
+        }
+
+        pos = aReader.CurPos();
+    }
+
+    return true;
+}
+
+
+void SCH_LEGACY_PLUGIN_CACHE::loadIndexedPart( FILE_LINE_READER& aReader,
+                                               PART_INDEX_ENTRY& aEntry )
+{
+    // Drop the entry first so a broken symbol is not parsed again on every request.
+    aEntry.m_isLoaded = true;
+
+    for( size_t ii = 0; ii < aEntry.m_aliasNames.size(); ++ii )
+        m_indexedAliases.erase( aEntry.m_aliasNames[ii] );
+
+    wxLogTrace( traceSchLegacyPlugin, "Loading symbol \"%s\" from library \"%s\"",
+                aEntry.m_aliasNames[0], m_libFileName.GetFullPath() );
+
+    aReader.Seek( aEntry.m_filePos, aEntry.m_lineNumber );
+
+    if( !aReader.ReadLine() )
+        THROW_IO_ERROR( _( "unexpected end of file" ) );
+
+    LIB_PART* part = loadPart( aReader );
+
+    // Apply the documentation read from the document file when the library was loaded.
+    for( size_t ii = 0; ii < part->GetAliasCount(); ++ii )
+    {
+        LIB_ALIAS* alias = part->GetAlias( ii );
+        auto       doc = m_indexedDocs.find( alias->GetName() );
+
+        if( doc == m_indexedDocs.end() )
+            continue;
+
+        alias->SetDescription( doc->second.m_description );
+        alias->SetKeyWords( doc->second.m_keyWords );
+        alias->SetDocFileName( doc->second.m_docFileName );
+        m_indexedDocs.erase( doc );
+    }
+}
+
+
+LIB_ALIAS* SCH_LEGACY_PLUGIN_CACHE::findAlias( const wxString& aAliasName )
+{
+    LIB_ALIAS_MAP::const_iterator it = m_aliases.find( aAliasName );
+
+    if( it != m_aliases.end() )
+        return it->second;
+
+    auto indexed = m_indexedAliases.find( aAliasName );
+
+    if( indexed == m_indexedAliases.end() )
+        return NULL;
+
+    FILE_LINE_READER reader( m_libFileName.GetFullPath() );
+
+    loadIndexedPart( reader, m_partIndex[ indexed->second ] );
+
+    it = m_aliases.find( aAliasName );
+
+    return ( it != m_aliases.end() ) ? it->second : NULL;
+}
+
+
+void SCH_LEGACY_PLUGIN_CACHE::loadAllParts()
+{
+    if( m_indexedAliases.empty() )
+        return;
+
+    FILE_LINE_READER reader( m_libFileName.GetFullPath() );
+
+    for( PART_INDEX_ENTRY& entry : m_partIndex )
+    {
+        if( !entry.m_isLoaded )
+            loadIndexedPart( reader, entry );
+    }
+
+    m_partIndex.clear();
+    m_indexedAliases.clear();
+    m_indexedDocs.clear();
+}
+
+
 void SCH_LEGACY_PLUGIN_CACHE::loadDocs()
 {
     const char* line;
     wxString    text;
     wxString    aliasName;
     wxFileName  fn = m_libFileName;
-    LIB_ALIAS*  alias = NULL;;
+    LIB_ALIAS*  alias = NULL;
+    ALIAS_DOC*  doc = NULL;
 
     fn.SetExt( DOC_EXT );
 
@@ -2428,7 +2807,12 @@ void SCH_LEGACY_PLUGIN_CACHE::loadDocs()
 
         LIB_ALIAS_MAP::iterator it = m_aliases.find( aliasName );
 
-        if( it == m_aliases.end() )
+        doc = NULL;
+
+        // Symbols which are not loaded yet get their documentation when they are loaded.
+        if( it == m_aliases.end() && m_indexedAliases.count( aliasName ) )
+            doc = &m_indexedDocs[ aliasName ];
+        else if( it == m_aliases.end() )
             wxLogWarning( "Alias '%s' not found in library:\n\n"
                           "'%s'\n\nat line %d offset %d", aliasName, fn.GetFullPath(),
                           reader.LineNumber(), (int) (line - reader.Line() ) );
@@ -2454,17 +2838,23 @@ void SCH_LEGACY_PLUGIN_CACHE::loadDocs()
             switch( line[0] )
             {
             case 'D':
-                if( alias )
+                if( doc )
+                    doc->m_description = text;
+                else if( alias )
                     alias->SetDescription( text );
                 break;
 
             case 'K':
-                if( alias )
+                if( doc )
+                    doc->m_keyWords = text;
+                else if( alias )
                     alias->SetKeyWords( text );
                 break;
 
             case 'F':
-                if( alias )
+                if( doc )
+                    doc->m_docFileName = text;
+                else if( alias )
                     alias->SetDocFileName( text );
                 break;
 
@@ -3473,6 +3863,9 @@ void SCH_LEGACY_PLUGIN_CACHE::Save( bool aSaveDocFile )
     if( !m_isModified )
         return;
 
+    // The library file is about to be overwritten.
+    loadAllParts();
+
     std::unique_ptr< FILE_OUTPUTFORMATTER > formatter( new FILE_OUTPUTFORMATTER( m_libFileName.GetFullPath() ) );
     formatter->Print( 0, "%s %d.%d\n", LIBFILE_IDENT, LIB_VERSION_MAJOR, LIB_VERSION_MINOR );
     formatter->Print( 0, "#encoding utf-8\n");
@@ -4001,6 +4394,8 @@ void SCH_LEGACY_PLUGIN_CACHE::saveDocFile()
 
 void SCH_LEGACY_PLUGIN_CACHE::DeleteAlias( const wxString& aAliasName )
 {
+    loadAllParts();
+
     LIB_ALIAS_MAP::iterator it = m_aliases.find( aAliasName );
 
     if( it == m_aliases.end() )
@@ -4036,6 +4431,8 @@ void SCH_LEGACY_PLUGIN_CACHE::DeleteAlias( const wxString& aAliasName )
 
 void SCH_LEGACY_PLUGIN_CACHE::DeleteSymbol( const wxString& aAliasName )
 {
+    loadAllParts();
+
     LIB_ALIAS_MAP::iterator it = m_aliases.find( aAliasName );
 
     if( it == m_aliases.end() )
@@ -4108,7 +4505,7 @@ size_t SCH_LEGACY_PLUGIN::GetSymbolLibCount( const wxString&   aLibraryPath,
 
     cacheLib( aLibraryPath );
 
-    return m_cache->m_aliases.size();
+    return m_cache->m_aliases.size() + m_cache->m_indexedAliases.size();
 }
 
 
@@ -4124,13 +4521,25 @@ void SCH_LEGACY_PLUGIN::EnumerateSymbolLib( wxArrayString&    aAliasNameList,
                               aProperties->find( SYMBOL_LIB_TABLE::PropPowerSymsOnly ) != aProperties->end() );
     cacheLib( aLibraryPath );
 
+    // Merge the loaded and the indexed alias names, keeping the alias map order.
+    std::set< wxString, AliasMapSort > names;
+
     const LIB_ALIAS_MAP& aliases = m_cache->m_aliases;
 
     for( LIB_ALIAS_MAP::const_iterator it = aliases.begin();  it != aliases.end();  ++it )
     {
         if( !powerSymbolsOnly || it->second->GetPart()->IsPower() )
-            aAliasNameList.Add( it->first );
+            names.insert( it->first );
+    }
+
+    for( const auto& indexed : m_cache->m_indexedAliases )
+    {
+        if( !powerSymbolsOnly || m_cache->m_partIndex[ indexed.second ].m_isPower )
+            names.insert( indexed.first );
     }
+
+    for( const wxString& name : names )
+        aAliasNameList.Add( name );
 }
 
 
@@ -4145,6 +4554,7 @@ void SCH_LEGACY_PLUGIN::EnumerateSymbolLib( std::vector<LIB_ALIAS*>& aAliasList,
     bool powerSymbolsOnly = ( aProperties &&
                               aProperties->find( SYMBOL_LIB_TABLE::PropPowerSymsOnly ) != aProperties->end() );
     cacheLib( aLibraryPath );
+    m_cache->loadAllParts();
 
     const LIB_ALIAS_MAP& aliases = m_cache->m_aliases;
 
@@ -4165,12 +4575,7 @@ LIB_ALIAS* SCH_LEGACY_PLUGIN::LoadSymbol( const wxString& aLibraryPath, const wx
 
     cacheLib( aLibraryPath );
 
-    LIB_ALIAS_MAP::const_iterator it = m_cache->m_aliases.find( aAliasName );
-
-    if( it == m_cache->m_aliases.end() )
-        return NULL;
-
-    return it->second;
+    return m_cache->findAlias( aAliasName );
 }
 
 
@@ -4269,6 +4674,9 @@ void SCH_LEGACY_PLUGIN::SaveLibrary( const wxString& aLibraryPath, const PROPERT
     if( !m_cache )
         m_cache = new SCH_LEGACY_PLUGIN_CACHE( aLibraryPath );
 
+    // Symbols not loaded yet must be read from the current file before it is renamed.
+    m_cache->loadAllParts();
+
     wxString oldFileName = m_cache->GetFileName();
 
     if( !m_cache->IsFile( aLibraryPath ) )
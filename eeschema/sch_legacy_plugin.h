@@ -23,6 +23,8 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <map>
+#include <memory>
 #include <sch_io_mgr.h>
 
 
@@ -128,6 +130,7 @@ public:
     const wxString& GetError() const override { return m_error; }
 
 private:
+    void preloadHierarchy( const wxString& aRootFileName );
     void loadHierarchy( SCH_SHEET* aSheet );
     void loadHeader( FILE_LINE_READER& aReader, SCH_SCREEN* aScreen );
     void loadPageSettings( FILE_LINE_READER& aReader, SCH_SCREEN* aScreen );
@@ -168,6 +171,15 @@ protected:
     FILE_OUTPUTFORMATTER* m_out;    ///< The output formatter for saving SCH_SCREEN objects.
     SCH_LEGACY_PLUGIN_CACHE* m_cache;
 
+    /// Screens parsed ahead by preloadHierarchy(), by full file name, not yet used by a sheet.
+    std::map< wxString, std::unique_ptr< SCH_SCREEN > > m_preloadedScreens;
+
+    /// Errors which occurred while preloading the screens, by full file name.
+    std::map< wxString, IO_ERROR > m_preloadErrors;
+
+    bool              m_fixedOnLoad;    ///< A file was fixed while loading it.
+    bool              m_deferBitmaps;   ///< Do not create wxBitmaps, e.g. on worker threads.
+
     /// initialize PLUGIN like a constructor would.
     void init( KIWAY* aKiway, const PROPERTIES* aProperties = NULL );
 };
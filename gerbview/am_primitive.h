@@ -173,9 +173,6 @@ struct APERTURE_MACRO
      */
     AM_PARAMS m_localparamStack;
 
-    SHAPE_POLY_SET m_shape;     ///< The shape of the item, calculated by GetApertureMacroShape
-    EDA_RECT m_boundingBox;     ///< The bounding box of the item, calculated by GetApertureMacroShape
-
     /**
      * function GetLocalParam
      * Usually, parameters are defined inside the aperture primitive
@@ -193,25 +190,14 @@ struct APERTURE_MACRO
     /**
      * Function GetApertureMacroShape
      * Calculate the primitive shape for flashed items.
-     * When an item is flashed, this is the shape of the item
-     * @param aParent = the parent GERBER_DRAW_ITEM which is actually drawn
-     * @return The shape of the item
-     */
-    SHAPE_POLY_SET* GetApertureMacroShape( const GERBER_DRAW_ITEM* aParent, wxPoint aShapePos );
-
-   /**
-     * Function DrawApertureMacroShape
-     * Draw the primitive shape for flashed items.
-     * When an item is flashed, this is the shape of the item
+     * When an item is flashed, this is the shape of the item.
+     * Usually called only once for a D_CODE, see D_CODE::GetFlashedShape()
      * @param aParent = the parent GERBER_DRAW_ITEM which is actually drawn
-     * @param aClipBox = DC clip box (NULL is no clip)
-     * @param aDC = device context
-     * @param aColor = the color of shape
      * @param aShapePos = the actual shape position
-     * @param aFilledShape = true to draw in filled mode, false to draw in skecth mode
+     * @param aShape = a buffer to store the shape of the item, in absolute coordinates
      */
-    void DrawApertureMacroShape( GERBER_DRAW_ITEM* aParent, EDA_RECT* aClipBox, wxDC* aDC,
-                                 COLOR4D aColor, wxPoint aShapePos, bool aFilledShape );
+    void GetApertureMacroShape( const GERBER_DRAW_ITEM* aParent, wxPoint aShapePos,
+                                SHAPE_POLY_SET& aShape );
 
     /**
      * Function GetShapeDim
@@ -226,12 +212,6 @@ struct APERTURE_MACRO
      * @return a dimension, or -1 if no dim to calculate
      */
     int  GetShapeDim( GERBER_DRAW_ITEM* aParent );
-
-    /// Returns the bounding box of the shape
-    EDA_RECT GetBoundingBox() const
-    {
-        return m_boundingBox;
-    }
 };
 
 
@@ -209,13 +209,20 @@ void GERBVIEW_FRAME::Block_Move()
             continue;
 
         /* Move items in block */
-        for( GERBER_DRAW_ITEM* item = gerber->GetItemsList(); item; item = item->Next() )
-        {
-            GERBER_DRAW_ITEM* gerb_item = item;
+        bool moved = false;
 
+        for( GERBER_DRAW_ITEM* gerb_item : gerber->GetItemsInArea( GetScreen()->m_BlockLocate ) )
+        {
             if( gerb_item->HitTest( GetScreen()->m_BlockLocate ) )
+            {
                 gerb_item->MoveAB( delta );
+                moved = true;
+            }
         }
+
+        // The spatial index is no longer valid: it will be rebuilt on the next search
+        if( moved )
+            gerber->ClearItemsIndex();
     }
 
     m_canvas->Refresh( true );
@@ -89,6 +89,7 @@ void D_CODE::Clear_D_CODE_Data()
     m_Rotation   = 0.0;
     m_EdgesCount = 0;
     m_Polygon.RemoveAllContours();
+    ClearFlashedShapes();
 }
 
 
@@ -160,8 +161,7 @@ void D_CODE::DrawFlashedShape(  GERBER_DRAW_ITEM* aParent,
     switch( m_Shape )
     {
     case APT_MACRO:
-        GetMacro()->DrawApertureMacroShape( aParent, aClipBox, aDC, aColor,
-                                            aShapePos, aFilledShape);
+        DrawFlashedPolygon( aParent, aClipBox, aDC, aColor, aFilledShape, aShapePos );
         break;
 
     case APT_CIRCLE:
@@ -182,9 +182,6 @@ void D_CODE::DrawFlashedShape(  GERBER_DRAW_ITEM* aParent,
             }
             else                            // rectangular hole
             {
-                if( m_Polygon.OutlineCount() == 0 )
-                    ConvertShapeToPolygon();
-
                 DrawFlashedPolygon( aParent, aClipBox, aDC, aColor, aFilledShape, aShapePos );
             }
         break;
@@ -208,9 +205,6 @@ void D_CODE::DrawFlashedShape(  GERBER_DRAW_ITEM* aParent,
         }
         else
         {
-            if( m_Polygon.OutlineCount() == 0 )
-                ConvertShapeToPolygon();
-
             DrawFlashedPolygon( aParent, aClipBox, aDC, aColor, aFilledShape, aShapePos );
         }
     }
@@ -249,18 +243,12 @@ void D_CODE::DrawFlashedShape(  GERBER_DRAW_ITEM* aParent,
         }
         else
         {
-            if( m_Polygon.OutlineCount() == 0 )
-                ConvertShapeToPolygon();
-
             DrawFlashedPolygon( aParent, aClipBox, aDC, aColor, aFilledShape, aShapePos );
         }
     }
     break;
 
     case APT_POLYGON:
-        if( m_Polygon.OutlineCount() == 0 )
-            ConvertShapeToPolygon();
-
         DrawFlashedPolygon( aParent, aClipBox, aDC, aColor, aFilledShape, aShapePos );
         break;
     }
@@ -272,21 +260,75 @@ void D_CODE::DrawFlashedPolygon( GERBER_DRAW_ITEM* aParent,
                                  COLOR4D aColor, bool aFilled,
                                  const wxPoint& aPosition )
 {
-    if( m_Polygon.OutlineCount() == 0 )
-        return;
-
-    int pointCount = m_Polygon.VertexCount();
+    const SHAPE_POLY_SET& shape = GetFlashedShape( aParent );
+    wxPoint origin = aParent->GetABPosition( aPosition );
     std::vector<wxPoint> points;
-    points.reserve( pointCount );
 
-    for( int ii = 0; ii < pointCount; ii++ )
+    for( int ii = 0; ii < shape.OutlineCount(); ii++ )
+    {
+        const SHAPE_LINE_CHAIN& outline = shape.COutline( ii );
+
+        points.clear();
+
+        for( int jj = 0; jj < outline.PointCount(); jj++ )
+            points.push_back( wxPoint( outline.CPoint( jj ).x, outline.CPoint( jj ).y ) + origin );
+
+        if( points.size() )
+            GRClosedPoly( aClipBox, aDC, points.size(), &points[0], aFilled, aColor, aColor );
+    }
+}
+
+
+const SHAPE_POLY_SET& D_CODE::GetFlashedShape( const GERBER_DRAW_ITEM* aParent )
+{
+    APERTURE_TRANSFORM transform = aParent->GetApertureTransform();
+
+    MUTLOCK lock( m_flashedShapesLock );
+
+    for( const FLASHED_SHAPE& flashedShape : m_flashedShapes )
     {
-        wxPoint p( m_Polygon.Vertex( ii ).x, m_Polygon.Vertex( ii ).y );
-        points[ii] = p + aPosition;
-        points[ii] = aParent->GetABPosition( points[ii] );
+        if( flashedShape.m_transform == transform )
+            return flashedShape.m_shape;
     }
 
-    GRClosedPoly( aClipBox, aDC, pointCount, &points[0], aFilled, aColor, aColor );
+    m_flashedShapes.emplace_back();
+    m_flashedShapes.back().m_transform = transform;
+    SHAPE_POLY_SET& shape = m_flashedShapes.back().m_shape;
+
+    // The shape is calculated for a flash at (0,0), and made relative to its AB position
+    VECTOR2I origin( aParent->GetABPosition( wxPoint( 0, 0 ) ) );
+
+    if( m_Shape == APT_MACRO )
+    {
+        if( GetMacro() )
+            GetMacro()->GetApertureMacroShape( aParent, wxPoint( 0, 0 ), shape );
+    }
+    else
+    {
+        if( m_Polygon.OutlineCount() == 0 )
+            ConvertShapeToPolygon();
+
+        shape = m_Polygon;
+
+        for( int ii = 0; ii < shape.OutlineCount(); ii++ )
+        {
+            for( auto it = shape.IterateWithHoles( ii ); it; ++it )
+                *it = aParent->GetABPosition( wxPoint( it->x, it->y ) );
+        }
+    }
+
+    shape.Move( -origin );
+    shape.CacheTriangulation();
+
+    return shape;
+}
+
+
+void D_CODE::ClearFlashedShapes()
+{
+    MUTLOCK lock( m_flashedShapesLock );
+
+    m_flashedShapes.clear();
 }
 
 
@@ -31,10 +31,12 @@
 #define _DCODE_H_
 
 #include <vector>
+#include <deque>
 
 #include <base_struct.h>
 #include <gal/color4d.h>
 #include <geometry/shape_poly_set.h>
+#include <ki_mutex.h>
 
 using KIGFX::COLOR4D;
 
@@ -75,6 +77,29 @@ enum APERTURE_DEF_HOLETYPE {
 struct APERTURE_MACRO;
 
 
+/**
+ * Struct APERTURE_TRANSFORM
+ * is the linear part of the transform from XY gerber coordinates to AB draw
+ * coordinates of an item (see GERBER_DRAW_ITEM::GetABPosition()).
+ * Flashes using the same D_CODE and the same transform have the same shape.
+ */
+struct APERTURE_TRANSFORM
+{
+    bool        m_swapAxis;
+    bool        m_mirrorA;
+    bool        m_mirrorB;
+    wxRealPoint m_drawScale;
+    double      m_rotation;         ///< layer and image rotation, in degrees
+
+    bool operator==( const APERTURE_TRANSFORM& aOther ) const
+    {
+        return m_swapAxis == aOther.m_swapAxis && m_mirrorA == aOther.m_mirrorA
+               && m_mirrorB == aOther.m_mirrorB && m_drawScale == aOther.m_drawScale
+               && m_rotation == aOther.m_rotation;
+    }
+};
+
+
 /**
  * Class D_CODE
  * holds a gerber DCODE (also called Aperture) definition.
@@ -90,6 +115,21 @@ private:
      */
     std::vector<double>   m_am_params;
 
+    /// A shape of this aperture, calculated for a given transform
+    struct FLASHED_SHAPE
+    {
+        APERTURE_TRANSFORM  m_transform;
+        SHAPE_POLY_SET      m_shape;
+    };
+
+    /**
+     * The flashed shapes already calculated, see GetFlashedShape().
+     * A deque, because references to its items must stay valid when a new
+     * shape is added
+     */
+    std::deque<FLASHED_SHAPE> m_flashedShapes;
+    MUTEX                 m_flashedShapesLock;
+
 public:
     wxSize                m_Size;           ///< Horizontal and vertical dimensions.
     APERTURE_T            m_Shape;          ///< shape ( Line, rectangle, circle , oval .. )
@@ -195,6 +235,25 @@ public:
                              EDA_RECT* aClipBox, wxDC* aDC, COLOR4D aColor,
                              bool aFilled, const wxPoint& aPosition );
 
+    /**
+     * Function GetFlashedShape
+     * returns the shape of this aperture as a polygon (aperture macros, shapes with
+     * holes and regular polygons) for the flashed item aParent, in AB coordinates,
+     * relative to the flash position: the shape of the flash is this shape moved to
+     * aParent->GetABPosition( aParent->m_Start ).
+     * The shape is calculated, and triangulated, only once for all the flashes using
+     * the same transform, and this function can be called from several threads.
+     * @param aParent = the flashed GERBER_DRAW_ITEM
+     */
+    const SHAPE_POLY_SET& GetFlashedShape( const GERBER_DRAW_ITEM* aParent );
+
+    /**
+     * Function ClearFlashedShapes
+     * removes the shapes calculated by GetFlashedShape(), to be called when the
+     * aperture definition is modified.
+     */
+    void ClearFlashedShapes();
+
     /**
      * Function ConvertShapeToPolygon
      * convert a shape to an equivalent polygon.
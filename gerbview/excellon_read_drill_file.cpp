@@ -160,32 +160,50 @@ static EXCELLON_CMD excellon_G_CmdList[] =
 
 bool GERBVIEW_FRAME::Read_EXCELLON_File( const wxString& aFullFileName )
 {
-    wxString msg;
+    EXCELLON_IMAGE* drill_layer = prepareExcellonImage();
+
+    if( drill_layer == nullptr )
+        return false;
+
+    // Read the Excellon drill file:
+    bool success = drill_layer->LoadFile( aFullFileName );
+
+    return finishExcellonImageLoading( drill_layer, aFullFileName, success );
+}
+
+
+EXCELLON_IMAGE* GERBVIEW_FRAME::prepareExcellonImage()
+{
     int layerId = GetActiveLayer();      // current layer used in GerbView
     GERBER_FILE_IMAGE_LIST* images = GetGerberLayout()->GetImagesList();
-    auto gerber_layer = images->GetGbrImage( layerId );
-    auto drill_layer = dynamic_cast<EXCELLON_IMAGE*>( gerber_layer );
 
-    if( gerber_layer && !drill_layer )
+    if( images->GetGbrImage( layerId ) )
     {
-        // The active layer contains old gerber data we have to clear
+        // The active layer contains old data we have to clear.
+        // Do not reuse an old drill image: the file can be read in a worker
+        // thread, and the old items must be removed from the view before.
         Erase_Current_DrawLayer( false );
     }
 
-    if( drill_layer == nullptr )
-    {
-        drill_layer = new EXCELLON_IMAGE( layerId );
-        layerId = images->AddGbrImage( drill_layer, layerId );
-    }
+    EXCELLON_IMAGE* drill_layer = new EXCELLON_IMAGE( layerId );
+    layerId = images->AddGbrImage( drill_layer, layerId );
 
     if( layerId < 0 )
     {
         DisplayError( this, _( "No room to load file" ) );
-        return false;
+        delete drill_layer;
+        return nullptr;
     }
 
-    // Read the Excellon drill file:
-    bool success = drill_layer->LoadFile( aFullFileName );
+    return drill_layer;
+}
+
+
+bool GERBVIEW_FRAME::finishExcellonImageLoading( EXCELLON_IMAGE* drill_layer,
+                                                 const wxString& aFullFileName,
+                                                 bool success )
+{
+    wxString msg;
 
     if( !success )
     {
@@ -210,7 +228,7 @@ bool GERBVIEW_FRAME::Read_EXCELLON_File( const wxString& aFullFileName )
         {
             KIGFX::VIEW* view = canvas->GetView();
 
-            for( GERBER_DRAW_ITEM* item = drill_layer->GetItemsList(); item; item = item->Next() )
+            for( GERBER_DRAW_ITEM* item : drill_layer->GetItems() )
             {
                 view->Add( (KIGFX::VIEW_ITEM*) item );
             }
@@ -318,6 +336,9 @@ bool EXCELLON_IMAGE::LoadFile( const wxString & aFullFileName )
     delete m_FileFunction;
     m_FileFunction = new X2_ATTRIBUTE_FILEFUNCTION( dummy );
 
+    // Locate and block commands search the items in the spatial index
+    BuildItemsIndex();
+
     m_InUse = true;
 
     return true;
@@ -592,8 +613,7 @@ bool EXCELLON_IMAGE::Execute_Drill_Command( char*& text )
                     return false;
                 }
 
-                gbritem = new GERBER_DRAW_ITEM( this );
-                m_Drawings.Append( gbritem );
+                gbritem = m_Drawings.NewItem( this );
 
                 if( m_SlotOn )  // Oblong hole
                 {
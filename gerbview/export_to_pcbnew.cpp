@@ -28,12 +28,16 @@
  */
 
 #include <vector>
+#include <set>
+#include <algorithm>
 
 #include <fctsys.h>
 #include <common.h>
 #include <confirm.h>
 #include <macros.h>
 #include <trigo.h>
+#include <richio.h>
+#include <geometry/shape_poly_set.h>
 #include <gerbview.h>
 #include <gerbview_frame.h>
 #include <gerber_file_image.h>
@@ -53,13 +57,25 @@ extern const wxString GetPCBDefaultLayerName( LAYER_NUM aLayerNumber );
 class GBR_TO_PCB_EXPORTER
 {
 private:
+    /// A straight line to export, in Pcbnew coordinates (Y axis reversed)
+    struct EXPORT_SEGMENT
+    {
+        wxPoint m_Start;
+        wxPoint m_End;
+        int     m_Width;
+    };
+
     GERBVIEW_FRAME*         m_gerbview_frame;   // the main gerber frame
     wxString                m_pcb_file_name;    // BOARD file to write to
-    FILE*                   m_fp;               // the board file
+    OUTPUTFORMATTER*        m_out;              // the board file formatter
     int                     m_pcbCopperLayersCount;
-    std::vector<wxPoint>    m_vias_coordinates; // list of already generated vias,
+    std::set< std::pair<int, int> > m_vias_coordinates; // list of already generated vias,
                                                 // used to export only once a via
                                                 // having a given coordinate
+    std::vector<EXPORT_SEGMENT> m_segments;     // lines of the current layer, written
+                                                // after merging the collinear ones
+    SHAPE_POLY_SET          m_regions;          // regions of the current copper layer,
+                                                // written as zones
 public:
     GBR_TO_PCB_EXPORTER( GERBVIEW_FRAME* aFrame, const wxString& aFileName );
     ~GBR_TO_PCB_EXPORTER();
@@ -125,12 +141,41 @@ private:
                               int aWidth, LAYER_NUM aLayer, double aAngle = 0 );
 
     /**
-     * function writeCopperLineItem
-     * basic write function to write a a TRACK item
-     * to the board file, from a non flashed item
+     * function addLineItem
+     * stores a straight line (track or graphic line) of the current layer,
+     * to be written by writeLineItems()
+     */
+    void    addLineItem( const wxPoint& aStart, const wxPoint& aEnd, int aWidth );
+
+    /**
+     * function writeLineItems
+     * merges the collinear and overlapping lines stored by addLineItem(),
+     * and writes them as TRACK items (copper layers) or DRAWSEGMENT items
+     * @param aLayer = the layer to use
+     * @param aIsCopper = true to write tracks, false to write graphic lines
+     */
+    void    writeLineItems( LAYER_NUM aLayer, bool aIsCopper );
+
+    /**
+     * function addCopperRegion
+     * adds (or removes, for a clear polarity item) a region of the current copper layer
+     * to the area written by writeCopperZones()
      */
-    void    writeCopperLineItem( wxPoint& aStart, wxPoint& aEnd,
-                                 int aWidth, LAYER_NUM aLayer );
+    void    addCopperRegion( GERBER_DRAW_ITEM* aGbrItem );
+
+    /**
+     * function writeCopperZones
+     * writes the regions stored by addCopperRegion() as filled ZONE_CONTAINER items,
+     * one by merged region
+     * @param aLayer = the copper layer to use
+     */
+    void    writeCopperZones( LAYER_NUM aLayer );
+
+    /**
+     * function writePolygonPts
+     * writes a "(aKeyword (pts (xy x y) ...))" list from a polygon outline
+     */
+    void    writePolygonPts( const char* aKeyword, const SHAPE_LINE_CHAIN& aPoly );
 
     /**
      * function writePcbHeader
@@ -144,7 +189,7 @@ GBR_TO_PCB_EXPORTER::GBR_TO_PCB_EXPORTER( GERBVIEW_FRAME* aFrame, const wxString
 {
     m_gerbview_frame    = aFrame;
     m_pcb_file_name     = aFileName;
-    m_fp                = NULL;
+    m_out               = NULL;
     m_pcbCopperLayersCount = 2;
 }
 
@@ -211,69 +256,79 @@ bool GBR_TO_PCB_EXPORTER::ExportPcb( LAYER_NUM* aLayerLookUpTable, int aCopperLa
 {
     LOCALE_IO   toggle;     // toggles on, then off, the C locale.
 
-    m_fp = wxFopen( m_pcb_file_name, wxT( "wt" ) );
+    m_pcbCopperLayersCount = aCopperLayers;
+    m_vias_coordinates.clear();
 
-    if( m_fp == NULL )
+    try
     {
-        wxString msg;
-        msg.Printf( _( "Cannot create file \"%s\"" ), GetChars( m_pcb_file_name ) );
-        DisplayError( m_gerbview_frame, msg );
-        return false;
-    }
+        // The board file is written while the gerber items are read: no BOARD is built
+        FILE_OUTPUTFORMATTER formatter( m_pcb_file_name );
+        m_out = &formatter;
 
-    m_pcbCopperLayersCount = aCopperLayers;
+        writePcbHeader( aLayerLookUpTable );
 
-    writePcbHeader( aLayerLookUpTable );
+        // create an image of gerber data
+        // First: non copper layers:
+        const int pcbCopperLayerMax = 31;
+        GERBER_FILE_IMAGE_LIST* images = m_gerbview_frame->GetGerberLayout()->GetImagesList();
 
-    // create an image of gerber data
-    // First: non copper layers:
-    const int pcbCopperLayerMax = 31;
-    GERBER_FILE_IMAGE_LIST* images = m_gerbview_frame->GetGerberLayout()->GetImagesList();
+        for( unsigned layer = 0; layer < images->ImagesMaxCount(); ++layer )
+        {
+            GERBER_FILE_IMAGE* gerber = images->GetGbrImage( layer );
 
-    for( unsigned layer = 0; layer < images->ImagesMaxCount(); ++layer )
-    {
-        GERBER_FILE_IMAGE* gerber = images->GetGbrImage( layer );
+            if( gerber == NULL )    // Graphic layer not yet used
+                continue;
 
-        if( gerber == NULL )    // Graphic layer not yet used
-            continue;
+            LAYER_NUM pcb_layer_number = aLayerLookUpTable[layer];
 
-        LAYER_NUM pcb_layer_number = aLayerLookUpTable[layer];
+            if( !IsPcbLayer( pcb_layer_number ) )
+                continue;
 
-        if( !IsPcbLayer( pcb_layer_number ) )
-            continue;
+            if( pcb_layer_number <= pcbCopperLayerMax ) // copper layer
+                continue;
 
-        if( pcb_layer_number <= pcbCopperLayerMax ) // copper layer
-            continue;
+            for( GERBER_DRAW_ITEM* gerb_item : gerber->GetItems() )
+                export_non_copper_item( gerb_item, pcb_layer_number );
 
-        GERBER_DRAW_ITEM* gerb_item = gerber->GetItemsList();
+            writeLineItems( pcb_layer_number, false );
+        }
 
-        for( ; gerb_item; gerb_item = gerb_item->Next() )
-            export_non_copper_item( gerb_item, pcb_layer_number );
-    }
+        // Copper layers
+        for( unsigned layer = 0; layer < images->ImagesMaxCount(); ++layer )
+        {
+            GERBER_FILE_IMAGE* gerber = images->GetGbrImage( layer );
 
-    // Copper layers
-    for( unsigned layer = 0; layer < images->ImagesMaxCount(); ++layer )
-    {
-        GERBER_FILE_IMAGE* gerber = images->GetGbrImage( layer );
+            if( gerber == NULL )    // Graphic layer not yet used
+                continue;
 
-        if( gerber == NULL )    // Graphic layer not yet used
-            continue;
+            LAYER_NUM pcb_layer_number = aLayerLookUpTable[layer];
 
-        LAYER_NUM pcb_layer_number = aLayerLookUpTable[layer];
+            if( pcb_layer_number < 0 || pcb_layer_number > pcbCopperLayerMax )
+                continue;
 
-        if( pcb_layer_number < 0 || pcb_layer_number > pcbCopperLayerMax )
-            continue;
+            for( GERBER_DRAW_ITEM* gerb_item : gerber->GetItems() )
+                export_copper_item( gerb_item, pcb_layer_number );
 
-        GERBER_DRAW_ITEM* gerb_item = gerber->GetItemsList();
+            writeLineItems( pcb_layer_number, true );
+            writeCopperZones( pcb_layer_number );
+        }
 
-        for( ; gerb_item; gerb_item = gerb_item->Next() )
-            export_copper_item( gerb_item, pcb_layer_number );
+        m_out->Print( 0, ")\n" );
     }
+    catch( const IO_ERROR& ioe )
+    {
+        m_out = NULL;
+        m_segments.clear();
+        m_regions.RemoveAllContours();
 
-    fprintf( m_fp, ")\n" );
+        wxString msg;
+        msg.Printf( _( "Cannot create file \"%s\"" ), GetChars( m_pcb_file_name ) );
+        msg << wxT( "\n" ) << ioe.What();
+        DisplayError( m_gerbview_frame, msg );
+        return false;
+    }
 
-    fclose( m_fp );
-    m_fp = NULL;
+    m_out = NULL;
     return true;
 }
 
@@ -311,7 +366,11 @@ void GBR_TO_PCB_EXPORTER::export_non_copper_item( GERBER_DRAW_ITEM* aGbrItem, LA
     // Reverse Y axis:
     seg_start.y = -seg_start.y;
     seg_end.y = -seg_end.y;
-    writePcbLineItem( isArc, seg_start, seg_end, aGbrItem->m_Size.x, aLayer, angle );
+
+    if( isArc )
+        writePcbLineItem( isArc, seg_start, seg_end, aGbrItem->m_Size.x, aLayer, angle );
+    else
+        addLineItem( seg_start, seg_end, aGbrItem->m_Size.x );
 }
 
 
@@ -331,9 +390,8 @@ void GBR_TO_PCB_EXPORTER::export_copper_item( GERBER_DRAW_ITEM* aGbrItem, LAYER_
         break;
 
     case GBR_POLYGON:
-        // Currently: Pcbnew does not really handle polygons on copper layers (no DRC test).
-        // However, we can export them if the purpose of this export is to help recreate a board
-        writePcbPolygonItem( aGbrItem, aLayer );
+        // Regions are merged, and exported as zones once the layer is read
+        addCopperRegion( aGbrItem );
         break;
 
     default:
@@ -354,20 +412,240 @@ void GBR_TO_PCB_EXPORTER::export_segline_copper_item( GERBER_DRAW_ITEM* aGbrItem
     seg_start.y = -seg_start.y;
     seg_end.y = -seg_end.y;
 
-    writeCopperLineItem( seg_start, seg_end, aGbrItem->m_Size.x, aLayer );
+    addLineItem( seg_start, seg_end, aGbrItem->m_Size.x );
+}
+
+
+void GBR_TO_PCB_EXPORTER::addLineItem( const wxPoint& aStart, const wxPoint& aEnd, int aWidth )
+{
+    m_segments.push_back( EXPORT_SEGMENT{ aStart, aEnd, aWidth } );
+}
+
+
+static int gcd( int aA, int aB )
+{
+    while( aB )
+    {
+        int r = aA % aB;
+        aA = aB;
+        aB = r;
+    }
+
+    return aA;
+}
+
+
+void GBR_TO_PCB_EXPORTER::writeLineItems( LAYER_NUM aLayer, bool aIsCopper )
+{
+    // Gerber files often draw long tracks as many short strokes, and tracks drawn by
+    // several apertures overlap.  Lines having the same width, and lying on the same
+    // line (exactly: the coordinates are integers) are merged when they overlap or touch.
+    struct LINE_ON_AXIS
+    {
+        int     width;
+        int     dx, dy;         // reduced direction of the line
+        int64_t offset;         // identifies the line among the parallel ones
+        int64_t t0, t1;         // position of the ends along the line, t0 <= t1
+        wxPoint start, end;     // the ends, start at t0
+
+        bool SameLine( const LINE_ON_AXIS& aOther ) const
+        {
+            return width == aOther.width && dx == aOther.dx && dy == aOther.dy
+                   && offset == aOther.offset;
+        }
+    };
+
+    std::vector<LINE_ON_AXIS> lines;
+    lines.reserve( m_segments.size() );
+
+    for( const EXPORT_SEGMENT& seg : m_segments )
+    {
+        LINE_ON_AXIS line;
+        line.width = seg.m_Width;
+        line.start = seg.m_Start;
+        line.end   = seg.m_End;
+
+        int dx = seg.m_End.x - seg.m_Start.x;
+        int dy = seg.m_End.y - seg.m_Start.y;
+        int div = gcd( std::abs( dx ), std::abs( dy ) );
+
+        if( div == 0 )
+        {
+            // A null length line: merged only with an other one at the same place
+            line.dx = line.dy = 0;
+            line.offset = seg.m_Start.x;
+            line.t0 = line.t1 = seg.m_Start.y;
+        }
+        else
+        {
+            dx /= div;
+            dy /= div;
+
+            if( dx < 0 || ( dx == 0 && dy < 0 ) )
+            {
+                dx = -dx;
+                dy = -dy;
+            }
+
+            line.dx = dx;
+            line.dy = dy;
+            line.offset = (int64_t) dx * seg.m_Start.y - (int64_t) dy * seg.m_Start.x;
+            line.t0 = (int64_t) dx * seg.m_Start.x + (int64_t) dy * seg.m_Start.y;
+            line.t1 = (int64_t) dx * seg.m_End.x + (int64_t) dy * seg.m_End.y;
+
+            if( line.t0 > line.t1 )
+            {
+                std::swap( line.t0, line.t1 );
+                std::swap( line.start, line.end );
+            }
+        }
+
+        lines.push_back( line );
+    }
+
+    m_segments.clear();
+
+    std::sort( lines.begin(), lines.end(),
+               []( const LINE_ON_AXIS& aA, const LINE_ON_AXIS& aB )
+               {
+                   if( aA.width != aB.width )
+                       return aA.width < aB.width;
+
+                   if( aA.dx != aB.dx )
+                       return aA.dx < aB.dx;
+
+                   if( aA.dy != aB.dy )
+                       return aA.dy < aB.dy;
+
+                   if( aA.offset != aB.offset )
+                       return aA.offset < aB.offset;
+
+                   return aA.t0 < aB.t0;
+               } );
+
+    for( size_t ii = 0; ii < lines.size(); )
+    {
+        LINE_ON_AXIS merged = lines[ii];
+
+        for( ++ii; ii < lines.size(); ++ii )
+        {
+            const LINE_ON_AXIS& next = lines[ii];
+
+            if( !merged.SameLine( next ) || next.t0 > merged.t1 )
+                break;
+
+            if( next.t1 > merged.t1 )
+            {
+                merged.t1 = next.t1;
+                merged.end = next.end;
+            }
+        }
+
+        if( aIsCopper )
+        {
+            m_out->Print( 0, "(segment (start %s %s) (end %s %s) (width %s) (layer %s) (net 0))\n",
+                          Double2Str( TO_PCB_UNIT( merged.start.x ) ).c_str(),
+                          Double2Str( TO_PCB_UNIT( merged.start.y ) ).c_str(),
+                          Double2Str( TO_PCB_UNIT( merged.end.x ) ).c_str(),
+                          Double2Str( TO_PCB_UNIT( merged.end.y ) ).c_str(),
+                          Double2Str( TO_PCB_UNIT( merged.width ) ).c_str(),
+                          TO_UTF8( GetPCBDefaultLayerName( aLayer ) ) );
+        }
+        else
+        {
+            writePcbLineItem( false, merged.start, merged.end, merged.width, aLayer );
+        }
+    }
 }
 
 
-void GBR_TO_PCB_EXPORTER::writeCopperLineItem( wxPoint& aStart, wxPoint& aEnd,
-                                               int aWidth, LAYER_NUM aLayer )
+void GBR_TO_PCB_EXPORTER::addCopperRegion( GERBER_DRAW_ITEM* aGbrItem )
 {
-  fprintf( m_fp, "(segment (start %s %s) (end %s %s) (width %s) (layer %s) (net 0))\n",
-                  Double2Str( TO_PCB_UNIT(aStart.x) ).c_str(),
-                  Double2Str( TO_PCB_UNIT(aStart.y) ).c_str(),
-                  Double2Str( TO_PCB_UNIT(aEnd.x) ).c_str(),
-                  Double2Str( TO_PCB_UNIT(aEnd.y) ).c_str(),
-                  Double2Str( TO_PCB_UNIT( aWidth ) ).c_str(),
-                  TO_UTF8( GetPCBDefaultLayerName( aLayer ) ) );
+    SHAPE_POLY_SET region = aGbrItem->m_Polygon;
+
+    if( region.OutlineCount() == 0 )
+        return;
+
+    // Reverse Y axis:
+    for( auto it = region.Iterate(); it; it++ )
+        it->y = -it->y;
+
+    // Clear polarity regions remove copper from the previous regions
+    if( aGbrItem->GetLayerPolarity() )
+        m_regions.BooleanSubtract( region, SHAPE_POLY_SET::PM_FAST );
+    else
+        m_regions.Append( region );
+}
+
+
+void GBR_TO_PCB_EXPORTER::writeCopperZones( LAYER_NUM aLayer )
+{
+    if( m_regions.OutlineCount() == 0 )
+        return;
+
+    // Merge the overlapping regions: a zone is a outline with holes
+    m_regions.Simplify( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+
+    // The fill of a zone is drawn with a pen of min_thickness:
+    // use the smallest one, and shrink the filled area by half of it
+    const int minThickness = KiROUND( 0.0254 * IU_PER_MM );
+    std::string layerName = TO_UTF8( GetPCBDefaultLayerName( aLayer ) );
+
+    for( int ii = 0; ii < m_regions.OutlineCount(); ii++ )
+    {
+        m_out->Print( 0, "(zone (net 0) (net_name \"\") (layer %s) (hatch edge 0.508)\n",
+                      layerName.c_str() );
+        m_out->Print( 1, "(connect_pads (clearance 0))\n" );
+        m_out->Print( 1, "(min_thickness %s)\n",
+                      Double2Str( TO_PCB_UNIT( minThickness ) ).c_str() );
+        m_out->Print( 1, "(fill yes (arc_segments 16) (thermal_gap 0.508) (thermal_bridge_width 0.508))\n" );
+
+        SHAPE_POLY_SET zone;
+        zone.AddOutline( m_regions.COutline( ii ) );
+        writePolygonPts( "polygon", m_regions.COutline( ii ) );
+
+        for( int jj = 0; jj < m_regions.HoleCount( ii ); jj++ )
+        {
+            zone.AddHole( m_regions.CHole( ii, jj ) );
+            writePolygonPts( "polygon", m_regions.CHole( ii, jj ) );
+        }
+
+        zone.Inflate( -minThickness / 2, 16 );
+        zone.Fracture( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+
+        for( int jj = 0; jj < zone.OutlineCount(); jj++ )
+            writePolygonPts( "filled_polygon", zone.COutline( jj ) );
+
+        m_out->Print( 0, ")\n" );
+    }
+
+    m_regions.RemoveAllContours();
+}
+
+
+void GBR_TO_PCB_EXPORTER::writePolygonPts( const char* aKeyword, const SHAPE_LINE_CHAIN& aPoly )
+{
+    m_out->Print( 1, "(%s (pts", aKeyword );
+
+    #define MAX_COORD_CNT 4
+    int jj = MAX_COORD_CNT;
+
+    for( int ii = 0; ii < aPoly.PointCount(); ii++ )
+    {
+        bool newLine = --jj == 0;
+
+        if( newLine )
+        {
+            jj = MAX_COORD_CNT;
+            m_out->Print( 0, "\n" );
+        }
+
+        m_out->Print( newLine ? 2 : 0, " (xy %s %s)",
+                      Double2Str( TO_PCB_UNIT( aPoly.CPoint( ii ).x ) ).c_str(),
+                      Double2Str( TO_PCB_UNIT( aPoly.CPoint( ii ).y ) ).c_str() );
+    }
+
+    m_out->Print( 0, "))\n" );
 }
 
 
@@ -408,7 +686,7 @@ void GBR_TO_PCB_EXPORTER::export_segarc_copper_item( GERBER_DRAW_ITEM* aGbrItem,
         // Reverse Y axis:
         seg_start.y = -seg_start.y;
         seg_end.y = -seg_end.y;
-        writeCopperLineItem( seg_start, seg_end, aGbrItem->m_Size.x, aLayer );
+        addLineItem( seg_start, seg_end, aGbrItem->m_Size.x );
         curr_start = curr_end;
     }
 
@@ -419,7 +697,7 @@ void GBR_TO_PCB_EXPORTER::export_segarc_copper_item( GERBER_DRAW_ITEM* aGbrItem,
         // Reverse Y axis:
         seg_start.y = -seg_start.y;
         seg_end.y = -seg_end.y;
-        writeCopperLineItem( seg_start, seg_end, aGbrItem->m_Size.x, aLayer );
+        addLineItem( seg_start, seg_end, aGbrItem->m_Size.x );
     }
 }
 
@@ -432,13 +710,9 @@ void GBR_TO_PCB_EXPORTER::export_segarc_copper_item( GERBER_DRAW_ITEM* aGbrItem,
 void GBR_TO_PCB_EXPORTER::export_flashed_copper_item( GERBER_DRAW_ITEM* aGbrItem )
 {
     // First, explore already created vias, before creating a new via
-    for( unsigned ii = 0; ii < m_vias_coordinates.size(); ii++ )
-    {
-        if( m_vias_coordinates[ii] == aGbrItem->m_Start ) // Already created
-            return;
-    }
-
-    m_vias_coordinates.push_back( aGbrItem->m_Start );
+    if( !m_vias_coordinates.insert( std::make_pair( aGbrItem->m_Start.x,
+                                                    aGbrItem->m_Start.y ) ).second )
+        return;     // Already created
 
     wxPoint via_pos = aGbrItem->m_Start;
     int width   = (aGbrItem->m_Size.x + aGbrItem->m_Size.y) / 2;
@@ -446,23 +720,23 @@ void GBR_TO_PCB_EXPORTER::export_flashed_copper_item( GERBER_DRAW_ITEM* aGbrItem
     via_pos.y = -via_pos.y;
 
     // Layers are Front to Back
-    fprintf( m_fp, " (via (at %s %s) (size %s)",
+    m_out->Print( 0, " (via (at %s %s) (size %s)",
                   Double2Str( TO_PCB_UNIT(via_pos.x) ).c_str(),
                   Double2Str( TO_PCB_UNIT(via_pos.y) ).c_str(),
                   Double2Str( TO_PCB_UNIT( width ) ).c_str() );
 
-    fprintf( m_fp, " (layers %s %s))\n",
+    m_out->Print( 0, " (layers %s %s))\n",
                   TO_UTF8( GetPCBDefaultLayerName( F_Cu ) ),
                   TO_UTF8( GetPCBDefaultLayerName( B_Cu ) ) );
 }
 
 void GBR_TO_PCB_EXPORTER::writePcbHeader( LAYER_NUM* aLayerLookUpTable )
 {
-    fprintf( m_fp, "(kicad_pcb (version 4) (host Gerbview \"%s\")\n\n",
+    m_out->Print( 0, "(kicad_pcb (version 4) (host Gerbview \"%s\")\n\n",
              TO_UTF8( GetBuildVersion() ) );
 
     // Write layers section
-    fprintf( m_fp, "  (layers \n" );
+    m_out->Print( 0, "  (layers \n" );
 
     for( int ii = 0; ii < m_pcbCopperLayersCount; ii++ )
     {
@@ -471,15 +745,15 @@ void GBR_TO_PCB_EXPORTER::writePcbHeader( LAYER_NUM* aLayerLookUpTable )
         if( ii == m_pcbCopperLayersCount-1)
             id = B_Cu;
 
-        fprintf( m_fp, "    (%d %s signal)\n", id, TO_UTF8( GetPCBDefaultLayerName( id ) ) );
+        m_out->Print( 0, "    (%d %s signal)\n", id, TO_UTF8( GetPCBDefaultLayerName( id ) ) );
     }
 
     for( int ii = B_Adhes; ii < PCB_LAYER_ID_COUNT; ii++ )
     {
-        fprintf( m_fp, "    (%d %s user)\n", ii, TO_UTF8( GetPCBDefaultLayerName( ii ) ) );
+        m_out->Print( 0, "    (%d %s user)\n", ii, TO_UTF8( GetPCBDefaultLayerName( ii ) ) );
     }
 
-    fprintf( m_fp, "  )\n\n" );
+    m_out->Print( 0, "  )\n\n" );
 }
 
 
@@ -488,7 +762,7 @@ void GBR_TO_PCB_EXPORTER::writePcbLineItem( bool aIsArc, wxPoint& aStart, wxPoin
 {
     if( aIsArc && ( aAngle == 360.0 ||  aAngle == 0 ) )
     {
-        fprintf( m_fp, "(gr_circle (center %s %s) (end %s %s)(layer %s) (width %s))\n",
+        m_out->Print( 0, "(gr_circle (center %s %s) (end %s %s)(layer %s) (width %s))\n",
                  Double2Str( TO_PCB_UNIT(aStart.x) ).c_str(),
                  Double2Str( TO_PCB_UNIT(aStart.y) ).c_str(),
                  Double2Str( TO_PCB_UNIT(aEnd.x) ).c_str(),
@@ -499,7 +773,7 @@ void GBR_TO_PCB_EXPORTER::writePcbLineItem( bool aIsArc, wxPoint& aStart, wxPoin
     }
     else if( aIsArc )
     {
-        fprintf( m_fp, "(gr_arc (start %s %s) (end %s %s) (angle %s)(layer %s) (width %s))\n",
+        m_out->Print( 0, "(gr_arc (start %s %s) (end %s %s) (angle %s)(layer %s) (width %s))\n",
                  Double2Str( TO_PCB_UNIT(aStart.x) ).c_str(),
                  Double2Str( TO_PCB_UNIT(aStart.y) ).c_str(),
                  Double2Str( TO_PCB_UNIT(aEnd.x) ).c_str(),
@@ -511,7 +785,7 @@ void GBR_TO_PCB_EXPORTER::writePcbLineItem( bool aIsArc, wxPoint& aStart, wxPoin
     }
     else
     {
-        fprintf( m_fp, "(gr_line (start %s %s) (end %s %s)(layer %s) (width %s))\n",
+        m_out->Print( 0, "(gr_line (start %s %s) (end %s %s)(layer %s) (width %s))\n",
                  Double2Str( TO_PCB_UNIT(aStart.x) ).c_str(),
                  Double2Str( TO_PCB_UNIT(aStart.y) ).c_str(),
                  Double2Str( TO_PCB_UNIT(aEnd.x) ).c_str(),
@@ -525,12 +799,11 @@ void GBR_TO_PCB_EXPORTER::writePcbLineItem( bool aIsArc, wxPoint& aStart, wxPoin
 
 void GBR_TO_PCB_EXPORTER::writePcbPolygonItem( GERBER_DRAW_ITEM* aGbrItem, LAYER_NUM aLayer )
 {
-    fprintf( m_fp, "(gr_poly (pts " );
+    m_out->Print( 0, "(gr_poly (pts " );
 
     SHAPE_POLY_SET polys = aGbrItem->m_Polygon;
     SHAPE_LINE_CHAIN& poly = polys.Outline( 0 );
 
-    #define MAX_COORD_CNT 4
     int jj = MAX_COORD_CNT;
     int cnt_max = poly.PointCount() -1;
 
@@ -543,19 +816,19 @@ void GBR_TO_PCB_EXPORTER::writePcbPolygonItem( GERBER_DRAW_ITEM* aGbrItem, LAYER
         if( --jj == 0 )
         {
             jj = MAX_COORD_CNT;
-            fprintf( m_fp, "\n" );
+            m_out->Print( 0, "\n" );
         }
 
-        fprintf( m_fp, " (xy %s %s)",
+        m_out->Print( 0, " (xy %s %s)",
                  Double2Str( TO_PCB_UNIT( poly.Point( ii ).x ) ).c_str(),
                  Double2Str( TO_PCB_UNIT( -poly.Point( ii ).y ) ).c_str() );
     }
 
-    fprintf( m_fp, ")" );
+    m_out->Print( 0, ")" );
 
     if( jj != MAX_COORD_CNT )
-        fprintf( m_fp, "\n" );
+        m_out->Print( 0, "\n" );
 
-    fprintf( m_fp, "(layer %s) (width 0) )\n",
+    m_out->Print( 0, "(layer %s) (width 0) )\n",
              TO_UTF8( GetPCBDefaultLayerName( aLayer ) ) );
 }
@@ -40,10 +40,14 @@
 #include <gerbview_id.h>
 #include <gerber_file_image.h>
 #include <gerber_file_image_list.h>
+#include <excellon_image.h>
 #include <gerbview_layer_widget.h>
 #include <wildcards_and_files_ext.h>
 #include <widgets/progress_reporter.h>
 
+#include <atomic>
+#include <thread>
+
 // HTML Messages used more than one time:
 #define MSG_NO_MORE_LAYER\
     _( "<b>No more available free graphic layer</b> in Gerbview to load files" )
@@ -231,74 +235,72 @@ bool GERBVIEW_FRAME::loadListOfGerberFiles( const wxString& aPath,
     // Read gerber files: each file is loaded on a new GerbView layer
     bool success = true;
     int layer = GetActiveLayer();
+    const int firstLayer = layer;
     int visibility = GetVisibleLayers();
 
     // Manage errors when loading files
     wxString msg;
     WX_STRING_REPORTER reporter( &msg );
 
-    // Show progress dialog after 1 second of loading
-    static const long long progressShowDelay = 1000;
-
-    auto startTime = wxGetUTCTimeMillis();
-    std::unique_ptr<WX_PROGRESS_REPORTER> progress = nullptr;
+    // Give a layer and an empty image to each file, the files are read later
+    std::vector<GERBER_FILE_IMAGE*> gerbers;
+    std::vector<wxString> fullFilenames;
 
     for( unsigned ii = 0; ii < aFilenameList.GetCount(); ii++ )
     {
-        if( !progress && wxGetUTCTimeMillis() - startTime > progressShowDelay )
-        {
-            progress = std::make_unique<WX_PROGRESS_REPORTER>( this,
-                            _( "Loading Gerber files..." ), 1, false );
-            progress->SetMaxProgress( aFilenameList.GetCount() - 1 );
-            progress->Report( _("Loading Gerber files..." ) );
-        }
-        else if( progress )
-        {
-            progress->KeepRefreshing();
-        }
-
         filename = aFilenameList[ii];
 
         if( !filename.IsAbsolute() )
             filename.SetPath( aPath );
 
-        m_lastFileName = filename.GetFullPath();
-
         SetActiveLayer( layer, false );
 
         visibility |= ( 1 << layer );
 
-        if( Read_GERBER_File( filename.GetFullPath() ) )
-        {
-            UpdateFileHistory( m_lastFileName );
+        gerbers.push_back( prepareGerberImage() );
+        fullFilenames.push_back( filename.GetFullPath() );
 
-            layer = getNextAvailableLayer( layer );
+        layer = getNextAvailableLayer( layer );
 
-            if( layer == NO_AVAILABLE_LAYERS && ii < aFilenameList.GetCount()-1 )
-            {
-                success = false;
-                reporter.Report( MSG_NO_MORE_LAYER, REPORTER::RPT_ERROR );
+        if( layer == NO_AVAILABLE_LAYERS && ii < aFilenameList.GetCount()-1 )
+        {
+            success = false;
+            reporter.Report( MSG_NO_MORE_LAYER, REPORTER::RPT_ERROR );
 
-                // Report the name of not loaded files:
-                ii += 1;
-                while( ii < aFilenameList.GetCount() )
-                {
-                    filename = aFilenameList[ii++];
-                    wxString txt;
-                    txt.Printf( MSG_NOT_LOADED,
-                                GetChars( filename.GetFullName() ) );
-                    reporter.Report( txt, REPORTER::RPT_ERROR );
-                }
-                break;
+            // Report the name of not loaded files:
+            ii += 1;
+            while( ii < aFilenameList.GetCount() )
+            {
+                filename = aFilenameList[ii++];
+                wxString txt;
+                txt.Printf( MSG_NOT_LOADED,
+                            GetChars( filename.GetFullName() ) );
+                reporter.Report( txt, REPORTER::RPT_ERROR );
             }
-
-            SetActiveLayer( layer, false );
+            break;
         }
+    }
 
-        if( progress )
-            progress->AdvanceProgress();
+    std::vector<bool> loaded = loadImagesConcurrently( gerbers, fullFilenames,
+                                                       _( "Loading Gerber files..." ) );
+
+    for( unsigned ii = 0; ii < gerbers.size(); ii++ )
+    {
+        if( loaded[ii] )
+        {
+            m_lastFileName = fullFilenames[ii];
+            UpdateFileHistory( m_lastFileName );
+        }
+        else
+        {
+            // Free the layer of a file which cannot be read
+            GetImagesList()->DeleteImage( gerbers[ii]->m_GraphicLayer );
+        }
     }
 
+    // The layers of the files which cannot be read are available again
+    layer = getNextAvailableLayer( firstLayer );
+
     if( !success )
     {
         wxSafeYield();  // Allows slice of time to redraw the screen
@@ -331,6 +333,104 @@ bool GERBVIEW_FRAME::loadListOfGerberFiles( const wxString& aPath,
 }
 
 
+std::vector<bool> GERBVIEW_FRAME::loadImagesConcurrently(
+        const std::vector<GERBER_FILE_IMAGE*>& aImages,
+        const std::vector<wxString>& aFilenames,
+        const wxString& aProgressTitle )
+{
+    size_t count = aImages.size();
+    std::vector<bool> success( count, false );
+
+    if( count == 0 )
+        return success;
+
+    // LOCALE_IO is not thread safe: set the C locale once for all the readers
+    LOCALE_IO toggleIo;
+
+    // Each file is read in its own image: the readers share nothing but the D_CODE
+    // shapes caches, which are thread safe.
+    std::vector<char> readOk( count, false );
+    std::unique_ptr<std::atomic<bool>[]> done( new std::atomic<bool>[count] );
+    std::atomic<size_t> nextFile( 0 );
+
+    for( size_t ii = 0; ii < count; ii++ )
+        done[ii] = false;
+
+    size_t threadCount = std::min<size_t>( count,
+                                           std::max( 1U, std::thread::hardware_concurrency() ) );
+    std::vector<std::thread> threads;
+
+    for( size_t ii = 0; ii < threadCount; ii++ )
+    {
+        threads.emplace_back( [&]()
+        {
+            for( size_t jj = nextFile++; jj < count; jj = nextFile++ )
+            {
+                EXCELLON_IMAGE* drill = dynamic_cast<EXCELLON_IMAGE*>( aImages[jj] );
+
+                // An exception must not escape the thread: the file is only reported
+                // as unreadable, and the main thread must always see it as done
+                try
+                {
+                    if( drill )
+                        readOk[jj] = drill->LoadFile( aFilenames[jj] );
+                    else
+                        readOk[jj] = aImages[jj]->LoadGerberFile( aFilenames[jj] );
+                }
+                catch( ... )
+                {
+                    readOk[jj] = false;
+                }
+
+                done[jj] = true;
+            }
+        } );
+    }
+
+    // Show progress dialog after 1 second of loading
+    static const long long progressShowDelay = 1000;
+
+    auto startTime = wxGetUTCTimeMillis();
+    std::unique_ptr<WX_PROGRESS_REPORTER> progress = nullptr;
+
+    // Add the items to the view in the main thread, as soon as their file is read
+    for( size_t ii = 0; ii < count; ii++ )
+    {
+        while( !done[ii] )
+        {
+            if( !progress && wxGetUTCTimeMillis() - startTime > progressShowDelay )
+            {
+                progress = std::make_unique<WX_PROGRESS_REPORTER>( this, aProgressTitle,
+                                                                   1, false );
+                progress->SetMaxProgress( count - ii );
+                progress->Report( aProgressTitle );
+            }
+            else if( progress )
+            {
+                progress->KeepRefreshing();
+            }
+
+            wxMilliSleep( 20 );
+        }
+
+        EXCELLON_IMAGE* drill = dynamic_cast<EXCELLON_IMAGE*>( aImages[ii] );
+
+        if( drill )
+            success[ii] = finishExcellonImageLoading( drill, aFilenames[ii], readOk[ii] );
+        else
+            success[ii] = finishGerberImageLoading( aImages[ii], aFilenames[ii], readOk[ii] );
+
+        if( progress )
+            progress->AdvanceProgress();
+    }
+
+    for( std::thread& thread : threads )
+        thread.join();
+
+    return success;
+}
+
+
 bool GERBVIEW_FRAME::LoadExcellonFiles( const wxString& aFullFileName )
 {
     wxString   filetypes;
@@ -373,11 +473,16 @@ bool GERBVIEW_FRAME::LoadExcellonFiles( const wxString& aFullFileName )
     // Read Excellon drill files: each file is loaded on a new GerbView layer
     bool success = true;
     int layer = GetActiveLayer();
+    const int firstLayer = layer;
 
     // Manage errors when loading files
     wxString msg;
     WX_STRING_REPORTER reporter( &msg );
 
+    // Give a layer and an empty image to each file, the files are read later
+    std::vector<GERBER_FILE_IMAGE*> drills;
+    std::vector<wxString> fullFilenames;
+
     for( unsigned ii = 0; ii < filenamesList.GetCount(); ii++ )
     {
         filename = filenamesList[ii];
@@ -385,39 +490,58 @@ bool GERBVIEW_FRAME::LoadExcellonFiles( const wxString& aFullFileName )
         if( !filename.IsAbsolute() )
             filename.SetPath( currentPath );
 
-        m_lastFileName = filename.GetFullPath();
-
         SetActiveLayer( layer, false );
 
-        if( Read_EXCELLON_File( filename.GetFullPath() ) )
-        {
-            // Update the list of recent drill files.
-            UpdateFileHistory( filename.GetFullPath(),  &m_drillFileHistory );
+        EXCELLON_IMAGE* drill = prepareExcellonImage();
 
-            layer = getNextAvailableLayer( layer );
+        if( drill == nullptr )
+            break;
 
-            if( layer == NO_AVAILABLE_LAYERS && ii < filenamesList.GetCount()-1 )
-            {
-                success = false;
-                reporter.Report( MSG_NO_MORE_LAYER, REPORTER::RPT_ERROR );
+        drills.push_back( drill );
+        fullFilenames.push_back( filename.GetFullPath() );
 
-                // Report the name of not loaded files:
-                ii += 1;
-                while( ii < filenamesList.GetCount() )
-                {
-                    filename = filenamesList[ii++];
-                    wxString txt;
-                    txt.Printf( MSG_NOT_LOADED,
-                                GetChars( filename.GetFullName() ) );
-                    reporter.Report( txt, REPORTER::RPT_ERROR );
-                }
-                break;
+        layer = getNextAvailableLayer( layer );
+
+        if( layer == NO_AVAILABLE_LAYERS && ii < filenamesList.GetCount()-1 )
+        {
+            success = false;
+            reporter.Report( MSG_NO_MORE_LAYER, REPORTER::RPT_ERROR );
+
+            // Report the name of not loaded files:
+            ii += 1;
+            while( ii < filenamesList.GetCount() )
+            {
+                filename = filenamesList[ii++];
+                wxString txt;
+                txt.Printf( MSG_NOT_LOADED,
+                            GetChars( filename.GetFullName() ) );
+                reporter.Report( txt, REPORTER::RPT_ERROR );
             }
+            break;
+        }
+    }
 
-            SetActiveLayer( layer, false );
+    std::vector<bool> loaded = loadImagesConcurrently( drills, fullFilenames,
+                                                       _( "Loading drill files..." ) );
+
+    for( unsigned ii = 0; ii < drills.size(); ii++ )
+    {
+        if( loaded[ii] )
+        {
+            // Update the list of recent drill files.
+            m_lastFileName = fullFilenames[ii];
+            UpdateFileHistory( m_lastFileName, &m_drillFileHistory );
+        }
+        else
+        {
+            // Free the layer of a file which cannot be read
+            GetImagesList()->DeleteImage( drills[ii]->m_GraphicLayer );
         }
     }
 
+    // The layers of the files which cannot be read are available again
+    SetActiveLayer( getNextAvailableLayer( firstLayer ), false );
+
     if( !success )
     {
         HTML_MESSAGE_BOX mbox( this, _( "Errors" ) );
@@ -77,7 +77,7 @@ EDA_RECT GBR_LAYOUT::ComputeBoundingBox() const
         if( gerber == NULL )    // Graphic layer not yet used
             continue;
 
-        for( GERBER_DRAW_ITEM* item = gerber->GetItemsList(); item; item = item->Next() )
+        for( GERBER_DRAW_ITEM* item : gerber->GetItems() )
         {
             if( first_item )
             {
@@ -291,7 +291,7 @@ void GBR_LAYOUT::Draw( EDA_DRAW_PANEL* aPanel, wxDC* aDC, GR_DRAWMODE aDrawMode,
 
         // Now we can draw the current layer to the bitmap buffer
         // When needed, the previous bitmap is already copied to the screen buffer.
-        for( GERBER_DRAW_ITEM* item = gerber->GetItemsList(); item; item = item->Next() )
+        for( GERBER_DRAW_ITEM* item : gerber->GetItems() )
         {
             if( item->GetLayer() != layer )
                 continue;
@@ -384,7 +384,7 @@ void GBR_LAYOUT::DrawItemsDCodeID( EDA_DRAW_PANEL* aPanel, wxDC* aDC,
         if( ! gerber->m_IsVisible )
             continue;
 
-        for( GERBER_DRAW_ITEM* item = gerber->GetItemsList(); item != NULL; item = item->Next() )
+        for( GERBER_DRAW_ITEM* item : gerber->GetItems() )
         {
             wxPoint pos;
             int     size;
@@ -18,6 +18,9 @@
  */
 
 #include "gerber_collectors.h"
+#include <gbr_layout.h>
+#include <gerber_file_image.h>
+#include <gerber_file_image_list.h>
 
 const KICAD_T GERBER_COLLECTOR::AllItems[] = {
     GERBER_IMAGE_LIST_T,
@@ -62,7 +65,28 @@ void GERBER_COLLECTOR::Collect( EDA_ITEM* aItem, const KICAD_T aScanList[],
     // the Inspect() function.
     SetRefPos( aRefPos );
 
-    aItem->Visit( m_inspector, NULL, m_ScanTypes );
+    if( aItem->Type() == GERBER_LAYOUT_T )
+    {
+        // Only the items near aRefPos can be hit: use the spatial index of each
+        // image instead of visiting all the items of the layout
+        GERBER_FILE_IMAGE_LIST* images = static_cast<GBR_LAYOUT*>( aItem )->GetImagesList();
+        EDA_RECT refArea( aRefPos, wxSize( 1, 1 ) );
+
+        for( unsigned layer = 0; layer < images->ImagesMaxCount(); ++layer )
+        {
+            GERBER_FILE_IMAGE* gerber = images->GetGbrImage( layer );
+
+            if( gerber == NULL )    // Graphic layer not yet used
+                continue;
+
+            for( GERBER_DRAW_ITEM* item : gerber->GetItemsInArea( refArea ) )
+                item->Visit( m_inspector, NULL, m_ScanTypes );
+        }
+    }
+    else
+    {
+        aItem->Visit( m_inspector, NULL, m_ScanTypes );
+    }
 
     SetTimeNow();               // when snapshot was taken
 
@@ -181,6 +181,20 @@ wxPoint GERBER_DRAW_ITEM::GetABPosition( const wxPoint& aXYPosition ) const
 }
 
 
+APERTURE_TRANSFORM GERBER_DRAW_ITEM::GetApertureTransform() const
+{
+    APERTURE_TRANSFORM transform;
+
+    transform.m_swapAxis  = m_swapAxis;
+    transform.m_mirrorA   = m_mirrorA;
+    transform.m_mirrorB   = m_mirrorB;
+    transform.m_drawScale = m_drawScale;
+    transform.m_rotation  = m_lyrRotation + m_GerberImageFile->m_ImageRotation;
+
+    return transform;
+}
+
+
 wxPoint GERBER_DRAW_ITEM::GetXYPosition( const wxPoint& aABPosition ) const
 {
     // do the inverse transform made by GetABPosition
@@ -358,10 +372,13 @@ const EDA_RECT GERBER_DRAW_ITEM::GetBoundingBox() const
     {
         if( code )
         {
-            // Update the shape drawings and the bounding box coordiantes:
-            code->GetMacro()->GetApertureMacroShape( this, m_Start );
-            // now the bounding box is valid:
-            bbox = code->GetMacro()->GetBoundingBox();
+            // The shape is already in A,B axis
+            BOX2I bb = code->GetFlashedShape( this ).BBox();
+            bbox = EDA_RECT( GetABPosition( m_Start ) + wxPoint( bb.GetX(), bb.GetY() ),
+                             wxSize( bb.GetWidth(), bb.GetHeight() ) );
+            bbox.Normalize();
+
+            return bbox;
         }
         break;
     }
@@ -826,15 +843,19 @@ bool GERBER_DRAW_ITEM::HitTest( const wxPoint& aRefPos ) const
         }
 
     case GBR_SPOT_MACRO:
-        // Aperture macro polygons are already in absolute coordinates
-        auto p = GetDcodeDescr()->GetMacro()->GetApertureMacroShape( this, m_Start );
-        for( int i = 0; i < p->OutlineCount(); ++i )
+    {
+        // Aperture macro polygons are already in A,B axis, relative to the flash position
+        const SHAPE_POLY_SET& p = GetDcodeDescr()->GetFlashedShape( this );
+        VECTOR2I relPos( aRefPos - GetABPosition( m_Start ) );
+
+        for( int i = 0; i < p.OutlineCount(); ++i )
         {
-            if( p->Contains( VECTOR2I( aRefPos ), i ) )
+            if( p.Contains( relPos, i ) )
                 return true;
         }
         return false;
     }
+    }
 
     // TODO: a better analyze of the shape (perhaps create a D_CODE::HitTest for flashed items)
     int radius = std::min( m_Size.x, m_Size.y ) >> 1;
@@ -916,7 +937,7 @@ unsigned int GERBER_DRAW_ITEM::ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) cons
         switch( m_Shape )
         {
         case GBR_SPOT_MACRO:
-            size = GetDcodeDescr()->GetMacro()->GetBoundingBox().GetWidth();
+            size = GetDcodeDescr()->GetFlashedShape( this ).BBox().GetWidth();
             break;
 
         case GBR_ARC:
@@ -30,7 +30,6 @@
 #define GERBER_DRAW_ITEM_H
 
 #include <base_struct.h>
-#include <dlist.h>
 #include <layers_id_colors_and_visibility.h>
 #include <gr_basic.h>
 #include <gbr_netlist_metadata.h>
@@ -68,7 +67,7 @@ enum Gbr_Basic_Shapes {
 class GERBER_DRAW_ITEM : public EDA_ITEM
 {
     // make SetNext() and SetBack() private so that they may not be called from anywhere.
-    // list management is done on GERBER_DRAW_ITEMs using DLIST<GERBER_DRAW_ITEM> only.
+    // GERBER_DRAW_ITEMs are not linked: they are stored in a GERBER_DRAW_ITEMS.
 private:
     void SetNext( EDA_ITEM* aNext )       { Pnext = aNext; }
     void SetBack( EDA_ITEM* aBack )       { Pback = aBack; }
@@ -118,9 +117,6 @@ public:
     GERBER_DRAW_ITEM( GERBER_FILE_IMAGE* aGerberparams );
     ~GERBER_DRAW_ITEM();
 
-    GERBER_DRAW_ITEM* Next() const { return static_cast<GERBER_DRAW_ITEM*>( Pnext ); }
-    GERBER_DRAW_ITEM* Back() const { return static_cast<GERBER_DRAW_ITEM*>( Pback ); }
-
     void SetNetAttributes( const GBR_NETLIST_METADATA& aNetAttributes );
     const GBR_NETLIST_METADATA& GetNetAttributes() const { return m_netAttributes; }
 
@@ -212,6 +208,13 @@ public:
         return VECTOR2I( GetABPosition( wxPoint( aXYPosition.x, aXYPosition.y ) ) );
     }
 
+    /**
+     * Function GetApertureTransform
+     * returns the linear part of the transform made by GetABPosition(), i.e. what
+     * defines the shape of a flashed D_CODE in A,B axis
+     */
+    APERTURE_TRANSFORM GetApertureTransform() const;
+
     /**
      * Function GetXYPosition
      * returns the image position of aPosition for this object.
@@ -284,28 +287,6 @@ public:
         return wxT( "GERBER_DRAW_ITEM" );
     }
 
-    /**
-     * Function UnLink
-     * detaches this object from its owner.
-     */
-    void UnLink()
-    {
-        DLIST<GERBER_DRAW_ITEM>* list = (DLIST<GERBER_DRAW_ITEM>*) GetList();
-        wxASSERT( list );
-
-        if( list )
-            list->Remove( this );
-    }
-
-    /**
-     * Function DeleteStructure
-     * deletes this object after UnLink()ing it from its owner.
-     */
-    void DeleteStructure()
-    {
-        UnLink();
-        delete this;
-    }
 #if defined(DEBUG)
     void Show( int nestLevel, std::ostream& os ) const override;
 #endif
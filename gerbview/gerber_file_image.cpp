@@ -108,7 +108,7 @@ GERBER_FILE_IMAGE::GERBER_FILE_IMAGE( int aLayer ) :
 
 GERBER_FILE_IMAGE::~GERBER_FILE_IMAGE()
 {
-    m_Drawings.DeleteAll();
+    m_Drawings.Clear();
 
     for( unsigned ii = 0; ii < DIM( m_Aperture_List ); ii++ )
     {
@@ -118,16 +118,6 @@ GERBER_FILE_IMAGE::~GERBER_FILE_IMAGE()
     delete m_FileFunction;
 }
 
-/*
- * Function GetItemsList
- * returns the first GERBER_DRAW_ITEM * item of the items list
- */
-GERBER_DRAW_ITEM * GERBER_FILE_IMAGE::GetItemsList()
-{
-    return m_Drawings;
-}
-
-
 D_CODE* GERBER_FILE_IMAGE::GetDCODEOrCreate( int aDCODE, bool aCreateIfNoExist )
 {
     unsigned ndx = aDCODE - FIRST_DCODE;
@@ -226,6 +216,7 @@ void GERBER_FILE_IMAGE::ResetDefaultValues()
     m_Selected_Tool = 0;
     m_Last_Pen_Command = 0;
     m_Exposure = false;
+    m_itemsIndex.reset();                           // spatial index of items, built after loading
 }
 
 
@@ -242,7 +233,7 @@ bool GERBER_FILE_IMAGE::HasNegativeItems()
         else
         {
             m_hasNegativeItems = 0;
-            for( GERBER_DRAW_ITEM* item = GetItemsList(); item; item = item->Next() )
+            for( GERBER_DRAW_ITEM* item : GetItems() )
             {
                 if( item->GetLayer() != m_GraphicLayer )
                     continue;
@@ -257,6 +248,72 @@ bool GERBER_FILE_IMAGE::HasNegativeItems()
     return m_hasNegativeItems == 1;
 }
 
+void GERBER_FILE_IMAGE::BuildItemsIndex()
+{
+    // Items having a very tiny width can be hit a bit outside their bounding box
+    // (see MIN_HIT_TEST_RADIUS in GERBER_DRAW_ITEM::HitTest)
+    const int margin = Millimeter2iu( 0.01 );
+
+    m_itemsIndex.reset( new ITEMS_INDEX );
+
+    size_t rank = 0;
+
+    for( GERBER_DRAW_ITEM* item : GetItems() )
+    {
+        EDA_RECT bbox = item->GetBoundingBox();
+
+        // A block selection tests the ends of items, which are not always
+        // inside the shape (aperture macros)
+        bbox.Merge( item->GetABPosition( item->m_Start ) );
+        bbox.Merge( item->GetABPosition( item->m_End ) );
+        bbox.Inflate( margin );
+
+        const int mmin[2] = { bbox.GetX(), bbox.GetY() };
+        const int mmax[2] = { bbox.GetRight(), bbox.GetBottom() };
+
+        m_itemsIndex->Insert( mmin, mmax, INDEXED_ITEM{ item, rank++ } );
+    }
+}
+
+
+std::vector<GERBER_DRAW_ITEM*> GERBER_FILE_IMAGE::GetItemsInArea( const EDA_RECT& aArea )
+{
+    if( !m_itemsIndex )
+        BuildItemsIndex();
+
+    EDA_RECT area( aArea );
+    area.Normalize();
+
+    const int mmin[2] = { area.GetX(), area.GetY() };
+    const int mmax[2] = { area.GetRight(), area.GetBottom() };
+
+    std::vector<INDEXED_ITEM> found;
+
+    auto visitor = [&found]( const INDEXED_ITEM& aEntry ) -> bool
+    {
+        found.push_back( aEntry );
+        return true;
+    };
+
+    m_itemsIndex->Search( mmin, mmax, visitor );
+
+    // Callers expect the items in file order, like when iterating on the item list
+    std::sort( found.begin(), found.end(),
+               []( const INDEXED_ITEM& aA, const INDEXED_ITEM& aB )
+               {
+                   return aA.m_Rank < aB.m_Rank;
+               } );
+
+    std::vector<GERBER_DRAW_ITEM*> items;
+    items.reserve( found.size() );
+
+    for( const INDEXED_ITEM& entry : found )
+        items.push_back( entry.m_Item );
+
+    return items;
+}
+
+
 int GERBER_FILE_IMAGE::GetDcodesCount()
 {
     int count = 0;
@@ -310,14 +367,13 @@ void GERBER_FILE_IMAGE::StepAndRepeatItem( const GERBER_DRAW_ITEM& aItem )
             // create duplicate only if ii or jj > 0
             if( jj == 0 && ii == 0 )
                 continue;
-            GERBER_DRAW_ITEM* dupItem = new GERBER_DRAW_ITEM( aItem );
+            GERBER_DRAW_ITEM* dupItem = m_Drawings.DuplicateItem( aItem );
             wxPoint           move_vector;
             move_vector.x = scaletoIU( ii * GetLayerParams().m_StepForRepeat.x,
                                    GetLayerParams().m_StepForRepeatMetric );
             move_vector.y = scaletoIU( jj * GetLayerParams().m_StepForRepeat.y,
                                    GetLayerParams().m_StepForRepeatMetric );
             dupItem->MoveXY( move_vector );
-            m_Drawings.Append( dupItem );
         }
     }
 }
@@ -410,7 +466,14 @@ SEARCH_RESULT GERBER_FILE_IMAGE::Visit( INSPECTOR inspector, void* testData, con
             break;
 
         case GERBER_DRAW_ITEM_T:
-            result = IterateForward( &m_Drawings[0], inspector, testData, p );
+            for( GERBER_DRAW_ITEM* item : m_Drawings )
+            {
+                result = item->Visit( inspector, testData, p );
+
+                if( result == SEARCH_QUIT )
+                    break;
+            }
+
             ++p;
             break;
 
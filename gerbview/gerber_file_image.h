@@ -27,11 +27,14 @@
 
 #include <vector>
 #include <set>
+#include <memory>
+#include <algorithm>
 
 #include <dcode.h>
 #include <gerber_draw_item.h>
 #include <am_primitive.h>
 #include <gbr_netlist_metadata.h>
+#include <geometry/rtree.h>
 
 // An useful macro used when reading gerber files;
 #define IsNumber( x ) ( ( ( (x) >= '0' ) && ( (x) <='9' ) )   \
@@ -90,6 +93,136 @@ private:
     void ResetDefaultValues();
 };
 
+/**
+ * Class GERBER_DRAW_ITEMS
+ * stores the GERBER_DRAW_ITEMs of a GERBER_FILE_IMAGE, in file order.
+ * Items are not allocated one by one and linked, but stored in blocks of contiguous
+ * memory: large files have millions of items, and drawing or hit testing them reads
+ * the memory sequentially.
+ * Items are never moved (pointers to items are used by the view and the selection)
+ * and are all deleted together with the store.
+ */
+class GERBER_DRAW_ITEMS
+{
+public:
+    /**
+     * Iterates over the items in file order. Like for a list of pointers, dereferencing
+     * an iterator gives a GERBER_DRAW_ITEM*.
+     */
+    class ITERATOR
+    {
+    public:
+        ITERATOR( const GERBER_DRAW_ITEMS* aStore, size_t aBlock, size_t aIndex ) :
+            m_store( aStore ), m_block( aBlock ), m_index( aIndex )
+        {
+        }
+
+        GERBER_DRAW_ITEM* operator*() const
+        {
+            return &( *m_store->m_blocks[m_block] )[m_index];
+        }
+
+        ITERATOR& operator++()
+        {
+            if( ++m_index >= m_store->m_blocks[m_block]->size() )
+            {
+                m_block++;
+                m_index = 0;
+            }
+
+            return *this;
+        }
+
+        bool operator!=( const ITERATOR& aOther ) const
+        {
+            return m_block != aOther.m_block || m_index != aOther.m_index;
+        }
+
+    private:
+        const GERBER_DRAW_ITEMS* m_store;
+        size_t m_block;
+        size_t m_index;
+    };
+
+    GERBER_DRAW_ITEMS() : m_count( 0 ) {}
+
+    /**
+     * Function NewItem
+     * creates a new item at the end of the store.
+     * @param aImage = the gerber image of the item
+     */
+    GERBER_DRAW_ITEM* NewItem( GERBER_FILE_IMAGE* aImage )
+    {
+        BLOCK& block = reserveBlock();
+
+        block.emplace_back( aImage );
+        return &block.back();
+    }
+
+    /**
+     * Function DuplicateItem
+     * creates a copy of aItem at the end of the store.
+     */
+    GERBER_DRAW_ITEM* DuplicateItem( const GERBER_DRAW_ITEM& aItem )
+    {
+        BLOCK& block = reserveBlock();
+
+        block.emplace_back( aItem );
+        return &block.back();
+    }
+
+    /// @return the last item, or NULL if the store is empty
+    GERBER_DRAW_ITEM* GetLast() const
+    {
+        return m_count ? &m_blocks.back()->back() : NULL;
+    }
+
+    size_t GetCount() const { return m_count; }
+
+    bool IsEmpty() const { return m_count == 0; }
+
+    /// Deletes all the items
+    void Clear()
+    {
+        m_blocks.clear();
+        m_count = 0;
+    }
+
+    ITERATOR begin() const { return ITERATOR( this, 0, 0 ); }
+    ITERATOR end() const { return ITERATOR( this, m_blocks.size(), 0 ); }
+
+private:
+    typedef std::vector<GERBER_DRAW_ITEM> BLOCK;
+
+    /**
+     * @return the last block, after creating a new one if it is full.
+     * A block never grows beyond its reserved size, so its items never move.
+     * Blocks are small for the small files (drill files), and larger for the large ones.
+     */
+    BLOCK& reserveBlock()
+    {
+        if( m_blocks.empty() || m_blocks.back()->size() == m_blocks.back()->capacity() )
+        {
+            const size_t minBlockSize = 64;
+            const size_t maxBlockSize = 16384;
+            size_t blockSize = m_blocks.empty() ? minBlockSize
+                                                : std::min( 2 * m_blocks.back()->capacity(),
+                                                            maxBlockSize );
+
+            m_blocks.emplace_back( new BLOCK );
+            m_blocks.back()->reserve( blockSize );
+        }
+
+        m_count++;
+
+        return *m_blocks.back();
+    }
+
+    std::vector<std::unique_ptr<BLOCK>> m_blocks;
+    size_t m_count;
+};
+
+
 /**
  * Class GERBER_FILE_IMAGE
  * holds the Image data and parameters for one gerber file
@@ -103,7 +236,7 @@ class GERBER_FILE_IMAGE : public EDA_ITEM
     GERBER_LAYER       m_GBRLayerParams; // hold params for the current gerber layer
 
 public:
-    DLIST<GERBER_DRAW_ITEM> m_Drawings;                         // linked list of Gerber Items to draw
+    GERBER_DRAW_ITEMS  m_Drawings;                              // the Gerber Items to draw
 
     bool               m_InUse;                                 // true if this image is currently in use
                                                                 // (a file is loaded in it)
@@ -166,6 +299,18 @@ public:
     std::map<wxString, int> m_NetnamesList;                     // list of net names
 
 private:
+    /// An entry of the spatial index: an item and its rank in file order
+    struct INDEXED_ITEM
+    {
+        GERBER_DRAW_ITEM* m_Item;
+        size_t            m_Rank;
+    };
+
+    typedef RTree<INDEXED_ITEM, int, 2, double> ITEMS_INDEX;
+
+    std::unique_ptr<ITEMS_INDEX> m_itemsIndex;                  // spatial index of m_Drawings,
+                                                                // or NULL if not (yet) built
+
     wxArrayString      m_messagesList;                          // A list of messages created when reading a file
     int                m_hasNegativeItems;                      // true if the image is negative or has some negative items
                                                                 // Used to optimize drawing, because when there are no
@@ -222,10 +367,32 @@ public:
     COLOR4D GetPositiveDrawColor() const { return m_PositiveDrawColor; }
 
     /**
-     * Function GetItemsList
-     * @return the first GERBER_DRAW_ITEM * item of the items list
+     * Function GetItems
+     * @return the items of the image, in file order
+     */
+    GERBER_DRAW_ITEMS& GetItems() { return m_Drawings; }
+
+    /**
+     * Function BuildItemsIndex
+     * builds the spatial index of the items, used to find quickly the items
+     * at a given location. It is built when the file is loaded.
+     */
+    void BuildItemsIndex();
+
+    /**
+     * Function ClearItemsIndex
+     * deletes the spatial index of the items. Must be called when items are moved:
+     * the index will be rebuilt on the next search.
+     */
+    void ClearItemsIndex() { m_itemsIndex.reset(); }
+
+    /**
+     * Function GetItemsInArea
+     * @return the items which can be hit inside aArea, in file order.
+     * This is a fast pre-selection: the candidates must be tested by the caller,
+     * using GERBER_DRAW_ITEM::HitTest().
      */
-    GERBER_DRAW_ITEM * GetItemsList();
+    std::vector<GERBER_DRAW_ITEM*> GetItemsInArea( const EDA_RECT& aArea );
 
     /**
      * Function GetLayerParams
@@ -49,6 +49,7 @@ class GBR_LAYER_BOX_SELECTOR;
 class GERBER_DRAW_ITEM;
 class GERBER_FILE_IMAGE;
 class GERBER_FILE_IMAGE_LIST;
+class EXCELLON_IMAGE;
 class REPORTER;
 
 
@@ -224,6 +225,46 @@ private:
      */
     bool loadListOfGerberFiles( const wxString& aPath, const wxArrayString& aFilenameList );
 
+    /**
+     * Reads the gerber or drill files of aFilenames in aImages (already created by
+     * prepareGerberImage() or prepareExcellonImage()), using several worker threads.
+     * Each image is added to the view in the main thread as soon as it is read (and
+     * the images before it in the list).
+     * @param aImages are the images to fill
+     * @param aFilenames are the full file names, one for each image
+     * @param aProgressTitle is the title of the progress dialog, shown for long loads
+     * @return the success of each file
+     */
+    std::vector<bool> loadImagesConcurrently( const std::vector<GERBER_FILE_IMAGE*>& aImages,
+                                              const std::vector<wxString>& aFilenames,
+                                              const wxString& aProgressTitle );
+
+    /**
+     * Creates an empty gerber image in the active layer, after clearing this layer.
+     */
+    GERBER_FILE_IMAGE* prepareGerberImage();
+
+    /**
+     * Creates an empty drill image in the active layer, after clearing this layer.
+     * @return the drill image, or NULL if there is no room to load a file
+     */
+    EXCELLON_IMAGE* prepareExcellonImage();
+
+    /**
+     * Reports the errors found when reading a gerber file in aGerber, and adds the
+     * items of aGerber to the view. Must be called from the main thread.
+     * @param aReadOk is the value returned by GERBER_FILE_IMAGE::LoadGerberFile()
+     * @return true if the file was loaded
+     */
+    bool finishGerberImageLoading( GERBER_FILE_IMAGE* aGerber, const wxString& aFullFileName,
+                                   bool aReadOk );
+
+    /**
+     * Same as finishGerberImageLoading(), for drill files
+     */
+    bool finishExcellonImageLoading( EXCELLON_IMAGE* aDrill, const wxString& aFullFileName,
+                                     bool aReadOk );
+
 public:
     GERBVIEW_FRAME( KIWAY* aKiway, wxWindow* aParent );
     ~GERBVIEW_FRAME();
@@ -432,13 +432,7 @@ void GERBVIEW_PAINTER::drawFlashedShape( GERBER_DRAW_ITEM* aItem, bool aFilled )
             }
             else    // rectangular hole
             {
-                if( code->m_Polygon.OutlineCount() == 0 )
-                    code->ConvertShapeToPolygon();
-
-                SHAPE_POLY_SET poly = code->m_Polygon;
-                poly.Move( aItem->m_Start );
-
-                drawPolygon( aItem, poly, aFilled );
+                drawFlashedPolygon( aItem, aFilled );
             }
         }
         break;
@@ -460,13 +454,7 @@ void GERBVIEW_PAINTER::drawFlashedShape( GERBER_DRAW_ITEM* aItem, bool aFilled )
         }
         else
         {
-            if( code->m_Polygon.OutlineCount() == 0 )
-                code->ConvertShapeToPolygon();
-
-            SHAPE_POLY_SET poly = code->m_Polygon;
-            poly.Move( aItem->m_Start );
-
-            drawPolygon( aItem, poly, aFilled );
+            drawFlashedPolygon( aItem, aFilled );
         }
         break;
     }
@@ -502,31 +490,14 @@ void GERBVIEW_PAINTER::drawFlashedShape( GERBER_DRAW_ITEM* aItem, bool aFilled )
         }
         else
         {
-            if( code->m_Polygon.OutlineCount() == 0 )
-                code->ConvertShapeToPolygon();
-
-            SHAPE_POLY_SET poly = code->m_Polygon;
-            poly.Move( aItem->m_Start );
-
-            drawPolygon( aItem, poly, aFilled );
+            drawFlashedPolygon( aItem, aFilled );
         }
         break;
     }
 
     case GBR_SPOT_POLY:
-    {
-        if( code->m_Polygon.OutlineCount() == 0 )
-            code->ConvertShapeToPolygon();
-
-        SHAPE_POLY_SET poly = code->m_Polygon;
-        poly.Move( aItem->m_Start );
-
-        drawPolygon( aItem, poly, aFilled );
-        break;
-    }
-
     case GBR_SPOT_MACRO:
-        drawApertureMacro( aItem, aFilled );
+        drawFlashedPolygon( aItem, aFilled );
         break;
 
     default:
@@ -536,23 +507,27 @@ void GERBVIEW_PAINTER::drawFlashedShape( GERBER_DRAW_ITEM* aItem, bool aFilled )
 }
 
 
-void GERBVIEW_PAINTER::drawApertureMacro( GERBER_DRAW_ITEM* aParent, bool aFilled )
+void GERBVIEW_PAINTER::drawFlashedPolygon( GERBER_DRAW_ITEM* aParent, bool aFilled )
 {
-    D_CODE* code = aParent->GetDcodeDescr();
-    APERTURE_MACRO* macro = code->GetMacro();
-
-    SHAPE_POLY_SET* macroShape = macro->GetApertureMacroShape( aParent, aParent->m_Start );
+    // The shape is calculated and triangulated once for all the flashes of the D_CODE,
+    // and is relative to the flash position
+    const SHAPE_POLY_SET& shape = aParent->GetDcodeDescr()->GetFlashedShape( aParent );
 
     if( !m_gerbviewSettings.m_polygonFill )
         m_gal->SetLineWidth( m_gerbviewSettings.m_outlineWidth );
 
+    m_gal->Save();
+    m_gal->Translate( VECTOR2D( aParent->GetABPosition( aParent->m_Start ) ) );
+
     if( !aFilled )
     {
-        for( int i = 0; i < macroShape->OutlineCount(); i++ )
-            m_gal->DrawPolyline( macroShape->COutline( i ) );
+        for( int i = 0; i < shape.OutlineCount(); i++ )
+            m_gal->DrawPolyline( shape.COutline( i ) );
     }
     else
-        m_gal->DrawPolygon( *macroShape );
+        m_gal->DrawPolygon( shape );
+
+    m_gal->Restore();
 }
 
 
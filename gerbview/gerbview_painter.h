@@ -186,8 +186,9 @@ protected:
     /// Helper to draw a flashed shape (aka spot)
     void drawFlashedShape( GERBER_DRAW_ITEM* aItem, bool aFilled );
 
-    /// Helper to draw an aperture macro shape
-    void drawApertureMacro( GERBER_DRAW_ITEM* aParent, bool aFilled );
+    /// Helper to draw a flashed shape converted to polygon by its D_CODE
+    /// (aperture macros, shapes with holes and regular polygons)
+    void drawFlashedPolygon( GERBER_DRAW_ITEM* aParent, bool aFilled );
 
     /**
      * Function getLineThickness()
@@ -53,11 +53,14 @@ GERBER_DRAW_ITEM* GERBVIEW_FRAME::Locate( const wxPoint& aPosition, int aTypeloc
 
     GERBER_DRAW_ITEM* gerb_item = nullptr;
 
+    // Only the items near ref can be hit
+    EDA_RECT refArea( ref, wxSize( 1, 1 ) );
+
     // Search first on active layer
     // A not used graphic layer can be selected. So gerber can be NULL
     if( gerber && gerber->m_IsVisible )
     {
-        for( auto item = gerber->GetItemsList(); item; item = item->Next() )
+        for( GERBER_DRAW_ITEM* item : gerber->GetItemsInArea( refArea ) )
         {
             if( item->HitTest( ref ) )
             {
@@ -82,7 +85,7 @@ GERBER_DRAW_ITEM* GERBVIEW_FRAME::Locate( const wxPoint& aPosition, int aTypeloc
             if( layer == GetActiveLayer() )
                 continue;
 
-            for( auto item = gerber->GetItemsList(); item; item = item->Next() )
+            for( GERBER_DRAW_ITEM* item : gerber->GetItemsInArea( refArea ) )
             {
                 if( item->HitTest( ref ) )
                 {
@@ -39,8 +39,17 @@
  */
 bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
 {
-    wxString msg;
+    GERBER_FILE_IMAGE* gerber = prepareGerberImage();
 
+    /* Read the gerber file */
+    bool success = gerber->LoadGerberFile( GERBER_FullFileName );
+
+    return finishGerberImageLoading( gerber, GERBER_FullFileName, success );
+}
+
+
+GERBER_FILE_IMAGE* GERBVIEW_FRAME::prepareGerberImage()
+{
     int layer = GetActiveLayer();
     GERBER_FILE_IMAGE_LIST* images = GetImagesList();
     GERBER_FILE_IMAGE* gerber = GetGbrImage( layer );
@@ -53,8 +62,15 @@ bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
     gerber = new GERBER_FILE_IMAGE( layer );
     images->AddGbrImage( gerber, layer );
 
-    /* Read the gerber file */
-    bool success = gerber->LoadGerberFile( GERBER_FullFileName );
+    return gerber;
+}
+
+
+bool GERBVIEW_FRAME::finishGerberImageLoading( GERBER_FILE_IMAGE* gerber,
+                                               const wxString& GERBER_FullFileName,
+                                               bool success )
+{
+    wxString msg;
 
     if( !success )
     {
@@ -74,7 +90,7 @@ bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
     /* if the gerber file is only a RS274D file
      * (i.e. without any aperture information, but with items), warn the user:
      */
-    if( !gerber->m_Has_DCode && gerber->GetItemsList() )
+    if( !gerber->m_Has_DCode && !gerber->GetItems().IsEmpty() )
     {
         msg = _("Warning: this file has no D-Code definition\n"
                 "It is perhaps an old RS274D file\n"
@@ -93,7 +109,7 @@ bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
             // (maybe convert geometry into positives?)
         }
 
-        for( auto item = gerber->GetItemsList(); item; item = item->Next() )
+        for( GERBER_DRAW_ITEM* item : gerber->GetItems() )
         {
             view->Add( (KIGFX::VIEW_ITEM*) item );
         }
@@ -107,8 +123,7 @@ bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
 // size of a single line of text from a gerber file.
 // warning: some files can have *very long* lines, so the buffer must be large.
 #define GERBER_BUFZ 1000000
-// A large buffer to store one line
-static char lineBuffer[GERBER_BUFZ+1];
+
 
 bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
 {
@@ -131,6 +146,11 @@ bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
 
     wxString msg;
 
+    // A large buffer to store one line.
+    // Not a static buffer: several files can be read at the same time
+    std::unique_ptr<char[]> buffer( new char[GERBER_BUFZ+1] );
+    char* lineBuffer = buffer.get();
+
     while( true )
     {
         if( fgets( lineBuffer, GERBER_BUFZ, m_Current_File ) == NULL )
@@ -215,6 +235,9 @@ bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
 
     fclose( m_Current_File );
 
+    // Locate and block commands search the items in the spatial index
+    BuildItemsIndex();
+
     m_InUse = true;
 
     return true;
@@ -141,8 +141,8 @@ void fillFlashedGBRITEM(  GERBER_DRAW_ITEM* aGbrItem,
     case APT_MACRO:
         aGbrItem->m_Shape = GBR_SPOT_MACRO;
 
-        // Cache the bounding box for aperture macros
-        aGbrItem->GetDcodeDescr()->GetMacro()->GetApertureMacroShape( aGbrItem, aPos );
+        // Calculate the shape of the aperture macro (only once for all the flashes)
+        aGbrItem->GetDcodeDescr()->GetFlashedShape( aGbrItem );
         break;
     }
 }
@@ -343,8 +343,9 @@ static void fillArcPOLY(  GERBER_DRAW_ITEM* aGbrItem,
 {
     /* in order to calculate arc parameters, we use fillArcGBRITEM
      * so we muse create a dummy track and use its geometric parameters
+     * (not a static one: several files can be read at the same time)
      */
-    static GERBER_DRAW_ITEM dummyGbrItem( NULL );
+    GERBER_DRAW_ITEM dummyGbrItem( NULL );
 
     aGbrItem->SetLayerPolarity( aLayerNegative );
 
@@ -555,7 +556,7 @@ bool GERBER_FILE_IMAGE::Execute_G_Command( char*& text, int G_command )
         break;
 
     case GC_TURN_OFF_POLY_FILL:
-        if( m_Exposure && GetItemsList() )    // End of polygon
+        if( m_Exposure && !m_Drawings.IsEmpty() )    // End of polygon
         {
             GERBER_DRAW_ITEM * gbritem = m_Drawings.GetLast();
             gbritem->m_Polygon.Append( gbritem->m_Polygon.Vertex( 0 ) );
@@ -620,8 +621,7 @@ bool GERBER_FILE_IMAGE::Execute_DCODE_Command( char*& text, int D_commande )
             if( !m_Exposure )   // Start a new polygon outline:
             {
                 m_Exposure = true;
-                gbritem    = new GERBER_DRAW_ITEM( this );
-                m_Drawings.Append( gbritem );
+                gbritem    = m_Drawings.NewItem( this );
                 gbritem->m_Shape = GBR_POLYGON;
                 gbritem->m_Flashed = false;
             }
@@ -658,7 +658,7 @@ bool GERBER_FILE_IMAGE::Execute_DCODE_Command( char*& text, int D_commande )
             break;
 
         case 2:     // code D2: exposure OFF (i.e. "move to")
-            if( m_Exposure && GetItemsList() )    // End of polygon
+            if( m_Exposure && !m_Drawings.IsEmpty() )    // End of polygon
             {
                 gbritem = m_Drawings.GetLast();
                 gbritem->m_Polygon.Append( gbritem->m_Polygon.Vertex( 0 ) );
@@ -691,8 +691,7 @@ bool GERBER_FILE_IMAGE::Execute_DCODE_Command( char*& text, int D_commande )
             switch( m_Iterpolation )
             {
             case GERB_INTERPOL_LINEAR_1X:
-                gbritem = new GERBER_DRAW_ITEM( this );
-                m_Drawings.Append( gbritem );
+                gbritem = m_Drawings.NewItem( this );
 
                 fillLineGBRITEM( gbritem, dcode, m_PreviousPos,
                                  m_CurrentPos, size, GetLayerParams().m_LayerNegative );
@@ -707,8 +706,7 @@ bool GERBER_FILE_IMAGE::Execute_DCODE_Command( char*& text, int D_commande )
 
             case GERB_INTERPOL_ARC_NEG:
             case GERB_INTERPOL_ARC_POS:
-                gbritem = new GERBER_DRAW_ITEM( this );
-                m_Drawings.Append( gbritem );
+                gbritem = m_Drawings.NewItem( this );
 
                 fillArcGBRITEM( gbritem, dcode, m_PreviousPos,
                                 m_CurrentPos, m_IJPos, size,
@@ -741,8 +739,7 @@ bool GERBER_FILE_IMAGE::Execute_DCODE_Command( char*& text, int D_commande )
                 aperture = tool->m_Shape;
             }
 
-            gbritem = new GERBER_DRAW_ITEM( this );
-            m_Drawings.Append( gbritem );
+            gbritem = m_Drawings.NewItem( this );
             fillFlashedGBRITEM( gbritem, aperture, dcode, m_CurrentPos,
                                 size, GetLayerParams().m_LayerNegative );
             StepAndRepeatItem( *gbritem );
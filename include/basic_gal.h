@@ -25,6 +25,8 @@
 #ifndef BASIC_GAL_H
 #define BASIC_GAL_H
 
+#include <mutex>
+
 #include <eda_rect.h>
 
 #include <gal/stroke_font.h>
@@ -164,4 +166,8 @@ private:
 
 extern BASIC_GAL basic_gal;
 
+/// basic_gal holds the state of the text being drawn or plotted: it must be locked by
+/// its users, since boards can be plotted by several threads at once.
+extern std::recursive_mutex basic_gal_mutex;
+
 #endif      // define BASIC_GAL_H
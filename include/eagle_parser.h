@@ -29,6 +29,9 @@
 #define _EAGLE_PARSER_H_
 
 #include <errno.h>
+#include <cstdio>
+#include <functional>
+#include <string>
 #include <unordered_map>
 
 #include <wx/xml/xml.h>
@@ -364,6 +367,100 @@ public:
  */
 NODE_MAP MapChildren( wxXmlNode* aCurrentNode );
 
+
+/**
+ * Class EAGLE_XML_READER
+ * is a streaming reader for Eagle XML files.
+ *
+ * Instead of building the whole document tree like wxXmlDocument, the file is scanned once
+ * per call to Read() and only the elements selected by the caller are built, as wxXmlNode
+ * subtrees, and handed to a callback before being freed.  The memory used then scales with
+ * the largest selected element instead of the whole file.
+ *
+ * The nodes are built like wxXmlDocument would with its default flags: whitespace only text
+ * nodes, comments and processing instructions are dropped.
+ */
+class EAGLE_XML_READER
+{
+public:
+    /// What to do with an element, as decided by a #FILTER.
+    enum MODE
+    {
+        DESCEND,    ///< Do not build the element, but look for selected elements inside it.
+        WHOLE,      ///< Build the element with its whole subtree.
+        CHILDREN    ///< Build the element once per child, holding only this child subtree.
+    };
+
+    /**
+     * Decides what to do with the element at \a aPath, which is the dot separated list of
+     * element names from the document root, e.g. "eagle.drawing.board.signals".
+     */
+    typedef std::function<MODE( const wxString& aPath )> FILTER;
+
+    /**
+     * Receives the elements built according to the #FILTER.
+     *
+     * @return true if the handler takes ownership of \a aNode, only allowed for #WHOLE
+     *         elements.  Otherwise \a aNode is deleted when the handler returns.
+     */
+    typedef std::function<bool( const wxString& aPath, wxXmlNode* aNode )> HANDLER;
+
+    /**
+     * @throw IO_ERROR if \a aFileName cannot be opened.
+     */
+    EAGLE_XML_READER( const wxString& aFileName );
+    ~EAGLE_XML_READER();
+
+    /**
+     * Function Read
+     * scans the file from its beginning and calls \a aHandler for every element selected by
+     * \a aFilter.
+     *
+     * @throw XML_PARSER_ERROR if the file is not well formed XML.
+     */
+    void Read( const FILTER& aFilter, const HANDLER& aHandler );
+
+    /**
+     * Function Stop
+     * ends the current Read() once the handler returns, e.g. when all the wanted elements
+     * were found.
+     */
+    void Stop() { m_stop = true; }
+
+private:
+    FILE*       m_fp;
+    wxString    m_fileName;
+    char        m_buffer[65536];
+    size_t      m_bufferLen;
+    size_t      m_bufferPos;
+    int         m_lineNumber;
+    bool        m_stop;
+
+    int         peekChar();
+    int         getChar();
+    void        expect( const char* aText );
+    void        skipPast( const char* aText );
+    void        skipSpaces();
+
+    /**
+     * Skips the comment, processing instruction, declaration or CDATA section following a
+     * '<'.  The text of a CDATA section is stored in \a aCData if it is not NULL.
+     * @return false if the '<' starts an element start or end tag, which is not read.
+     */
+    bool        skipMarkup( std::string* aCData );
+
+    /// Moves after the '<' of the next element start or end tag, false at end of file.
+    bool        nextTag();
+
+    std::string readName();
+    void        readText( std::string& aText, char aDelimiter );
+    wxXmlNode*  readStartTag( bool& aEmptyElement );
+    void        readEndTag( const wxString& aName );
+    void        readChildren( wxXmlNode* aNode );
+
+    [[noreturn]] void error( const wxString& aMessage );
+};
+
 ///> Make a unique time stamp
 timestamp_t EagleTimeStamp( wxXmlNode* aTree );
 
@@ -33,6 +33,7 @@
 #define PLOT_COMMON_H_
 
 #include <vector>
+#include <unordered_map>
 #include <math/box2.h>
 #include <draw_graphic_text.h>
 #include <page_info.h>
@@ -41,6 +42,8 @@
 class SHAPE_POLY_SET;
 class SHAPE_LINE_CHAIN;
 class GBR_NETLIST_METADATA;
+class wxOutputStream;
+class wxZlibOutputStream;
 
 /**
  * Enum PlotFormat
@@ -733,6 +736,9 @@ protected:
                                       std::vector<int> *pos_pairs );
     void fputsPostscriptString(FILE *fout, const wxString& txt);
 
+    /// Returns a text as a postscript string, i.e. with parenthesis and escapes
+    std::string postscriptString( const wxString& txt );
+
     /// Virtual primitive for emitting the setrgbcolor operator
     virtual void emitSetRGBColor( double r, double g, double b ) = 0;
 
@@ -811,7 +817,7 @@ protected:
 class PDF_PLOTTER : public PSLIKE_PLOTTER
 {
 public:
-    PDF_PLOTTER() : pageStreamHandle( 0 ), workFile( NULL )
+    PDF_PLOTTER() : pageStreamHandle( 0 ), streamOutput( NULL ), streamCompressor( NULL )
     {
         // Avoid non initialized variables:
         pageStreamHandle = streamLengthHandle = fontResDictHandle = 0;
@@ -892,26 +898,59 @@ protected:
     std::vector<int> pageHandles;/// Handles to the page objects
     int pageStreamHandle;	 /// Handle of the page content object
     int streamLengthHandle;      /// Handle to the deferred stream length
-    wxString workFilename;
-    FILE* workFile;  	         /// Temporary file to costruct the stream before zipping
+    wxOutputStream* streamOutput;           /// outputFile, as a stream for streamCompressor
+    wxZlibOutputStream* streamCompressor;   /// Compresses the current stream to outputFile
+    long streamStart;            /// Offset in outputFile of the current stream data
     std::vector<long> xrefTable; /// The PDF xref offset table
+
+    /// Write to the current stream, like fprintf, fputs and putc would to a file
+    void streamPrintf( const char* aFormat, ... );
+    void streamPuts( const char* aText );
+    void streamPutc( int aChar );
 };
 
 class SVG_PLOTTER : public PSLIKE_PLOTTER
 {
 public:
     SVG_PLOTTER();
+    ~SVG_PLOTTER();
 
     static wxString GetDefaultFileExtension()
     {
         return wxString( wxT( "svg" ) );
     }
 
+    /// The file extension of gzip compressed svg files, see OpenFile()
+    static wxString GetCompressedFileExtension()
+    {
+        return wxString( wxT( "svgz" ) );
+    }
+
     virtual PlotFormat GetPlotterType() const override
     {
         return PLOT_FORMAT_SVG;
     }
 
+    /**
+     * Function SetCompactOutput
+     * selects the compact output mode, to create small files: consecutive shapes having
+     * the same style are written as a single path, using relative coordinates.
+     * Must be called before StartPlot().
+     * @param aCompact = true to use the compact mode
+     * @param aPrecision = the number of decimals of the coordinates (which are in 0.1 mil)
+     */
+    void SetCompactOutput( bool aCompact, int aPrecision = 1 )
+    {
+        m_compactOutput = aCompact;
+        m_precision = aPrecision;
+    }
+
+    /**
+     * Open or create the plot file aFullFilename.
+     * If its extension is .svgz, the file is written gzip compressed, on the fly.
+     */
+    virtual bool OpenFile( const wxString& aFullFilename ) override;
+
     virtual void SetColor( COLOR4D color ) override;
     virtual bool StartPlot() override;
     virtual bool EndPlot() override;
@@ -964,6 +1003,13 @@ protected:
                                     // 1 = plot dashed line style
                                     // 2 = plot dotted line style
                                     // 3 = plot dash-dot line style
+    bool m_compactOutput;           // true to merge the shapes in paths, see SetCompactOutput()
+    int m_precision;                // number of decimals of coordinates in compact mode
+    std::string m_pathData;         // the path being built in compact mode
+    DPOINT m_pathPos;               // the current point of m_pathData
+    DPOINT m_pathStart;             // the start of the current subpath of m_pathData
+    wxOutputStream* m_gzipFile;     // the .svgz file, used instead of outputFile
+    wxZlibOutputStream* m_gzipStream; // compresses the svg text to m_gzipFile
 
     /**
      * function emitSetRGBColor()
@@ -983,6 +1029,28 @@ protected:
      * prepare parameters for setSVGPlotStyle()
      */
     void setFillMode( FILL_T fill );
+
+    /// Write to the plot file (compressed or not), like fprintf and fputs would
+    void svgPrintf( const char* aFormat, ... );
+    void svgPuts( const char* aText );
+
+    /// Compact mode: appends a number to m_pathData, using the output precision
+    void appendPathValue( double aValue );
+
+    /// Compact mode: appends a move ('m') or line ('l') command to m_pathData
+    void pathTo( const DPOINT& aPos, char aCommand );
+
+    /// Compact mode: appends an arc command to m_pathData
+    void pathArcTo( const DPOINT& aPos, double aRadius, bool aLargeArc, bool aSweep );
+
+    /// Compact mode: closes the current subpath of m_pathData
+    void closePath();
+
+    /// Compact mode: rounds a coordinate to the output precision
+    double roundToPrecision( double aValue ) const;
+
+    /// Compact mode: writes the path being built, if any
+    void flushPath();
 };
 
 /* Class to handle a D_CODE when plotting a board : */
@@ -1217,6 +1285,36 @@ protected:
     std::vector<APERTURE>           apertures;
     std::vector<APERTURE>::iterator currentAperture;
 
+    /// The aperture lookup key: its type, size and attribute
+    struct APERTURE_KEY
+    {
+        APERTURE::APERTURE_TYPE m_Type;
+        wxSize                  m_Size;
+        int                     m_ApertureAttribute;
+
+        bool operator==( const APERTURE_KEY& aOther ) const
+        {
+            return m_Type == aOther.m_Type && m_Size == aOther.m_Size
+                   && m_ApertureAttribute == aOther.m_ApertureAttribute;
+        }
+    };
+
+    struct APERTURE_KEY_HASH
+    {
+        size_t operator()( const APERTURE_KEY& aKey ) const
+        {
+            size_t seed = std::hash<int>()( aKey.m_Type );
+
+            for( int value : { aKey.m_Size.x, aKey.m_Size.y, aKey.m_ApertureAttribute } )
+                seed ^= std::hash<int>()( value ) + 0x9e3779b9 + ( seed << 6 ) + ( seed >> 2 );
+
+            return seed;
+        }
+    };
+
+    /// The index in apertures of each aperture, to find them without scanning the list
+    std::unordered_map<APERTURE_KEY, size_t, APERTURE_KEY_HASH> m_apertureIndex;
+
     bool     m_gerberUnitInch;  // true if the gerber units are inches, false for mm
     int      m_gerberUnitFmt;   // number of digits in mantissa.
                                 // usually 6 in Inches and 5 or 6  in mm
@@ -83,6 +83,31 @@ namespace S3D
     SGLIB_API SGNODE* ReadCache( const char* aFileName, void* aPluginMgr,
         bool (*aTagCheck)( const char*, void* ) );
 
+    /**
+     * Function WriteModelCache
+     * writes the render data of a model (see GetModel()) to a binary cache file;
+     * the vertex and index arrays are stored as they are in memory, so they are
+     * read back without building the scene graph.
+     *
+     * @param aFileName is the name of the file to write
+     * @param aModel is the render data to write
+     * @param aPluginInfo is the PluginName:Version string of the plugin which loaded the model
+     * @return true on success
+     */
+    SGLIB_API bool WriteModelCache( const char* aFileName, const S3DMODEL* aModel,
+        const char* aPluginInfo );
+
+    /**
+     * Function ReadModelCache
+     * reads a binary cache file written by WriteModelCache()
+     *
+     * @param aFileName is the name of the render data cache file to be read
+     * @return NULL on failure (no file, other version of the format or of the plugin),
+     * otherwise the render data, to be destroyed by Destroy3DModel()
+     */
+    SGLIB_API S3DMODEL* ReadModelCache( const char* aFileName, void* aPluginMgr,
+        bool (*aTagCheck)( const char*, void* ) );
+
     /**
      * Function WriteVRML
      * writes out the given node and its subnodes to a VRML2 file
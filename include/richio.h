@@ -244,6 +244,27 @@ public:
         rewind( m_fp );
         m_lineNum = 0;
     }
+
+    /**
+     * Function CurPos
+     * returns the current position in the file, i.e. the position of the next line to read.
+     * It can be given later to #Seek() to read this line again.
+     */
+    long int CurPos()
+    {
+        return ftell( m_fp );
+    }
+
+    /**
+     * Function Seek
+     * moves to a position previously returned by #CurPos() and sets the line number back to
+     * \a aLineNumber.  Line number will go to \a aLineNumber + 1 on the next ReadLine().
+     */
+    void Seek( long int aPos, unsigned aLineNumber )
+    {
+        fseek( m_fp, aPos, SEEK_SET );
+        m_lineNum = aLineNumber;
+    }
 };
 
 
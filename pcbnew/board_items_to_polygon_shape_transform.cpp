@@ -52,9 +52,9 @@
 // These variables are parameters used in addTextSegmToPoly.
 // But addTextSegmToPoly is a call-back function,
 // so we cannot send them as arguments.
-static int s_textWidth;
-static int s_textCircle2SegmentCount;
-static SHAPE_POLY_SET* s_cornerBuffer;
+static thread_local int s_textWidth;
+static thread_local int s_textCircle2SegmentCount;
+static thread_local SHAPE_POLY_SET* s_cornerBuffer;
 
 // The max error is the distance between the middle of a segment, and the circle
 // for circle/arc to segment approximation.
@@ -71,10 +71,12 @@ static void addTextSegmToPoly( int x0, int y0, int xf, int yf )
 }
 
 
-void BOARD::ConvertBrdLayerToPolygonalContours( PCB_LAYER_ID aLayer, SHAPE_POLY_SET& aOutlines )
+void BOARD::ConvertBrdLayerToPolygonalContours( PCB_LAYER_ID aLayer, SHAPE_POLY_SET& aOutlines,
+                                                 int aSegCountPerCircle, bool aIncludeModuleTexts,
+                                                 bool aSkipNPTHPadsWihNoCopper )
 {
     // Number of segments to convert a circle to a polygon
-    const int       segcountforcircle   = 18;
+    const int       segcountforcircle   = aSegCountPerCircle;
     double          correctionFactor    = GetCircletoPolyCorrectionFactor( segcountforcircle );
 
     // convert tracks and vias:
@@ -91,11 +93,11 @@ void BOARD::ConvertBrdLayerToPolygonalContours( PCB_LAYER_ID aLayer, SHAPE_POLY_
     for( MODULE* module = m_Modules; module != NULL; module = module->Next() )
     {
         module->TransformPadsShapesWithClearanceToPolygon( aLayer,
-                aOutlines, 0, segcountforcircle, correctionFactor );
+                aOutlines, 0, segcountforcircle, correctionFactor, aSkipNPTHPadsWihNoCopper );
 
         // Micro-wave modules may have items on copper layers
         module->TransformGraphicShapesWithClearanceToPolygonSet( aLayer,
-                aOutlines, 0, segcountforcircle, correctionFactor );
+                aOutlines, 0, segcountforcircle, correctionFactor, 0, aIncludeModuleTexts );
     }
 
     // convert copper zones
@@ -489,6 +491,30 @@ void TEXTE_PCB::TransformShapeWithClearanceToPolygonSet(
 }
 
 
+void TEXTE_MODULE::TransformShapeWithClearanceToPolygonSet(
+                            SHAPE_POLY_SET& aCornerBuffer,
+                            int                    aClearanceValue,
+                            int                    aCircleToSegmentsCount,
+                            double                 aCorrectionFactor ) const
+{
+    wxSize size = GetTextSize();
+
+    if( IsMirrored() )
+        size.x = -size.x;
+
+    s_cornerBuffer = &aCornerBuffer;
+    s_textWidth  = GetThickness() + ( 2 * aClearanceValue );
+    s_textCircle2SegmentCount = aCircleToSegmentsCount;
+    COLOR4D color = COLOR4D::BLACK;  // not actually used, but needed by DrawGraphicText
+
+    DrawGraphicText( NULL, NULL, GetTextPos(), color,
+                     GetShownText(), GetDrawRotation(), size,
+                     GetHorizJustify(), GetVertJustify(),
+                     GetThickness(), IsItalic(),
+                     true, addTextSegmToPoly );
+}
+
+
 /**
  * Function TransformShapeWithClearanceToPolygon
  * Convert the track shape to a closed polygon
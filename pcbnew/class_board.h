@@ -595,8 +595,16 @@ public:
      * the polygons are not merged.
      * @param aLayer = A copper layer, like B_Cu, etc.
      * @param aOutlines The SHAPE_POLY_SET to fill in with items outline.
-     */
-    void ConvertBrdLayerToPolygonalContours( PCB_LAYER_ID aLayer, SHAPE_POLY_SET& aOutlines );
+     * @param aSegCountPerCircle = the number of segments to approximate a circle
+     * @param aIncludeModuleTexts = false to skip the texts of the footprints, when the
+     * caller selects them itself
+     * @param aSkipNPTHPadsWihNoCopper = true to skip the NPTH pads having no copper
+     * around their hole (see MODULE::TransformPadsShapesWithClearanceToPolygon())
+     */
+    void ConvertBrdLayerToPolygonalContours( PCB_LAYER_ID aLayer, SHAPE_POLY_SET& aOutlines,
+                                             int aSegCountPerCircle = 18,
+                                             bool aIncludeModuleTexts = true,
+                                             bool aSkipNPTHPadsWihNoCopper = false );
 
     /**
      * Function GetLayerID
@@ -165,6 +165,22 @@ public:
     ///> Set relative coordinates.
     void SetLocalCoord();
 
+    /**
+     * Function TransformShapeWithClearanceToPolygonSet
+     * Convert the text shape to a set of polygons (one by segment)
+     * Circles and arcs are approximated by segments
+     * @param aCornerBuffer = a buffer to store the polygon
+     * @param aClearanceValue = the clearance around the text
+     * @param aCircleToSegmentsCount = the number of segments to approximate a circle
+     * @param aCorrectionFactor = the correction to apply to circles radius to keep
+     * clearance when the circle is approximated by segment bigger or equal
+     * to the real clearance value (usually near from 1.0)
+     */
+    void TransformShapeWithClearanceToPolygonSet( SHAPE_POLY_SET& aCornerBuffer,
+                                                  int             aClearanceValue,
+                                                  int             aCircleToSegmentsCount,
+                                                  double          aCorrectionFactor ) const;
+
     /* drawing functions */
 
     /**
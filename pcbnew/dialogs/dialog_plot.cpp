@@ -214,6 +214,13 @@ void DIALOG_PLOT::init_Dialog()
     // Put vias on mask layer
     m_plotNoViaOnMaskOpt->SetValue( m_plotOpts.GetPlotViaOnMaskLayer() );
 
+    // Plot copper layers as merged shapes
+    m_mergeCopperShapesOpt->SetValue( m_plotOpts.GetMergeCopperShapes() );
+
+    // SVG options: the first choice is the legacy output (precision -1)
+    m_SVGPrecisionOpt->SetSelection( m_plotOpts.GetSvgPrecision() + 1 );
+    m_SVGCompressOpt->SetValue( m_plotOpts.GetSvgCompressed() );
+
     // Initialize a few other parameters, which can also be modified
     // from the drill dialog
     reInitDialog();
@@ -434,6 +441,7 @@ void DIALOG_PLOT::SetPlotFormat( wxCommandEvent& event )
 
         m_PlotOptionsSizer->Hide( m_GerberOptionsSizer );
         m_PlotOptionsSizer->Hide( m_HPGLOptionsSizer );
+        m_PlotOptionsSizer->Show( m_SVGOptionsSizer, getPlotFormat() == PLOT_FORMAT_SVG );
         m_PlotOptionsSizer->Hide( m_PSOptionsSizer );
         m_PlotOptionsSizer->Hide( m_SizerDXF_options );
         break;
@@ -456,6 +464,7 @@ void DIALOG_PLOT::SetPlotFormat( wxCommandEvent& event )
 
         m_PlotOptionsSizer->Hide( m_GerberOptionsSizer );
         m_PlotOptionsSizer->Hide( m_HPGLOptionsSizer );
+        m_PlotOptionsSizer->Hide( m_SVGOptionsSizer );
         m_PlotOptionsSizer->Show( m_PSOptionsSizer );
         m_PlotOptionsSizer->Hide( m_SizerDXF_options );
         break;
@@ -483,6 +492,7 @@ void DIALOG_PLOT::SetPlotFormat( wxCommandEvent& event )
 
         m_PlotOptionsSizer->Show( m_GerberOptionsSizer );
         m_PlotOptionsSizer->Hide( m_HPGLOptionsSizer );
+        m_PlotOptionsSizer->Hide( m_SVGOptionsSizer );
         m_PlotOptionsSizer->Hide( m_PSOptionsSizer );
         m_PlotOptionsSizer->Hide( m_SizerDXF_options );
         break;
@@ -506,6 +516,7 @@ void DIALOG_PLOT::SetPlotFormat( wxCommandEvent& event )
 
         m_PlotOptionsSizer->Hide( m_GerberOptionsSizer );
         m_PlotOptionsSizer->Show( m_HPGLOptionsSizer );
+        m_PlotOptionsSizer->Hide( m_SVGOptionsSizer );
         m_PlotOptionsSizer->Hide( m_PSOptionsSizer );
         m_PlotOptionsSizer->Hide( m_SizerDXF_options );
         break;
@@ -532,6 +543,7 @@ void DIALOG_PLOT::SetPlotFormat( wxCommandEvent& event )
 
         m_PlotOptionsSizer->Hide( m_GerberOptionsSizer );
         m_PlotOptionsSizer->Hide( m_HPGLOptionsSizer );
+        m_PlotOptionsSizer->Hide( m_SVGOptionsSizer );
         m_PlotOptionsSizer->Hide( m_PSOptionsSizer );
         m_PlotOptionsSizer->Show( m_SizerDXF_options );
 
@@ -609,6 +621,10 @@ void DIALOG_PLOT::applyPlotSettings()
     tempOptions.SetDXFPlotPolygonMode( m_DXF_plotModeOpt->GetValue() );
     tempOptions.SetPlotViaOnMaskLayer( m_plotNoViaOnMaskOpt->GetValue() );
 
+    tempOptions.SetMergeCopperShapes( m_mergeCopperShapesOpt->GetValue() );
+    tempOptions.SetSvgPrecision( m_SVGPrecisionOpt->GetSelection() - 1 );
+    tempOptions.SetSvgCompressed( m_SVGCompressOpt->GetValue() );
+
     if( !m_DXF_plotTextStrokeFontOpt->IsEnabled() )     // Currently, only DXF supports this option
         tempOptions.SetTextMode( PLOTTEXTMODE_DEFAULT  );
     else
@@ -823,6 +839,9 @@ void DIALOG_PLOT::Plot( wxCommandEvent& event )
 
     wxString file_ext( GetDefaultPlotExtension( m_plotOpts.GetFormat() ) );
 
+    if( m_plotOpts.GetFormat() == PLOT_FORMAT_SVG && m_plotOpts.GetSvgCompressed() )
+        file_ext = SVG_PLOTTER::GetCompressedFileExtension();
+
     // Test for a reasonable scale value
     // XXX could this actually happen? isn't it constrained in the apply
     // function?
@@ -841,6 +860,9 @@ void DIALOG_PLOT::Plot( wxCommandEvent& event )
 
     wxBusyCursor dummy;
 
+    std::vector<PCB_LAYER_ID>   layers;
+    std::vector<wxString>       fileNames;
+
     for( LSEQ seq = m_plotOpts.GetLayerSelection().UIOrder();  seq;  ++seq )
     {
         PCB_LAYER_ID layer = *seq;
@@ -866,25 +888,27 @@ void DIALOG_PLOT::Plot( wxCommandEvent& event )
         wxString fullname = fn.GetFullName();
         jobfile_writer.AddGbrFile( layer, fullname );
 
-        LOCALE_IO toggle;
+        layers.push_back( layer );
+        fileNames.push_back( fn.GetFullPath() );
+    }
 
-        PLOTTER*    plotter = StartPlotBoard( board, &m_plotOpts, layer, fn.GetFullPath(), wxEmptyString );
+    // The layers are independent: they are plotted in parallel
+    std::vector<bool> plotted = PlotLayersToFiles( board, &m_plotOpts, layers, fileNames,
+                                                   wxEmptyString );
 
-        // Print diags in messages box:
+    // Print diags in messages box:
+    for( size_t ii = 0; ii < layers.size(); ++ii )
+    {
         wxString msg;
 
-        if( plotter )
+        if( plotted[ii] )
         {
-            PlotOneBoardLayer( board, plotter, layer, m_plotOpts );
-            plotter->EndPlot();
-            delete plotter;
-
-            msg.Printf( _( "Plot file \"%s\" created." ), GetChars( fn.GetFullPath() ) );
+            msg.Printf( _( "Plot file \"%s\" created." ), GetChars( fileNames[ii] ) );
             reporter.Report( msg, REPORTER::RPT_ACTION );
         }
         else
         {
-            msg.Printf( _( "Unable to create file \"%s\"." ), GetChars( fn.GetFullPath() ) );
+            msg.Printf( _( "Unable to create file \"%s\"." ), GetChars( fileNames[ii] ) );
             reporter.Report( msg, REPORTER::RPT_ERROR );
         }
     }
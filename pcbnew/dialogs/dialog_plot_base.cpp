@@ -130,6 +130,11 @@ DIALOG_PLOT_BASE::DIALOG_PLOT_BASE( wxWindow* parent, wxWindowID id, const wxStr
 	
 	bSizerPlotItems->Add( m_useAuxOriginCheckBox, 0, wxALL, 2 );
 	
+	m_mergeCopperShapesOpt = new wxCheckBox( sbOptionsSizer->GetStaticBox(), wxID_ANY, _("Merge copper shapes"), wxDefaultPosition, wxDefaultSize, 0 );
+	m_mergeCopperShapesOpt->SetToolTip( _("Plot the copper layers as the union of their shapes (filled plot mode only).\nGerber files get regions instead of overlapping flashes and strokes.") );
+	
+	bSizerPlotItems->Add( m_mergeCopperShapesOpt, 0, wxALL, 2 );
+	
 	
 	bSizer192->Add( bSizerPlotItems, 0, wxEXPAND, 5 );
 	
@@ -282,6 +287,34 @@ DIALOG_PLOT_BASE::DIALOG_PLOT_BASE( wxWindow* parent, wxWindowID id, const wxStr
 	
 	m_PlotOptionsSizer->Add( m_HPGLOptionsSizer, 0, wxALL|wxEXPAND, 3 );
 	
+	m_SVGOptionsSizer = new wxStaticBoxSizer( new wxStaticBox( this, wxID_ANY, _("SVG Options") ), wxVERTICAL );
+	
+	wxBoxSizer* bSizerSVG_options;
+	bSizerSVG_options = new wxBoxSizer( wxVERTICAL );
+	
+	m_textSVGPrecision = new wxStaticText( m_SVGOptionsSizer->GetStaticBox(), wxID_ANY, _("Coordinate precision"), wxDefaultPosition, wxDefaultSize, 0 );
+	m_textSVGPrecision->Wrap( -1 );
+	bSizerSVG_options->Add( m_textSVGPrecision, 0, wxRIGHT|wxLEFT, 5 );
+	
+	wxString m_SVGPrecisionOptChoices[] = { _("Standard"), _("Compact, 0 decimals"), _("Compact, 1 decimal"), _("Compact, 2 decimals"), _("Compact, 3 decimals"), _("Compact, 4 decimals"), _("Compact, 5 decimals"), _("Compact, 6 decimals") };
+	int m_SVGPrecisionOptNChoices = sizeof( m_SVGPrecisionOptChoices ) / sizeof( wxString );
+	m_SVGPrecisionOpt = new wxChoice( m_SVGOptionsSizer->GetStaticBox(), wxID_ANY, wxDefaultPosition, wxDefaultSize, m_SVGPrecisionOptNChoices, m_SVGPrecisionOptChoices, 0 );
+	m_SVGPrecisionOpt->SetSelection( 0 );
+	m_SVGPrecisionOpt->SetToolTip( _("Standard: one SVG element per shape, like previous versions.\nCompact: consecutive shapes of the same style are merged in paths,\nusing relative coordinates with the given number of decimals (in 0.1 mils).") );
+	
+	bSizerSVG_options->Add( m_SVGPrecisionOpt, 0, wxBOTTOM|wxRIGHT|wxLEFT|wxEXPAND, 5 );
+	
+	m_SVGCompressOpt = new wxCheckBox( m_SVGOptionsSizer->GetStaticBox(), wxID_ANY, _("Compress output (.svgz)"), wxDefaultPosition, wxDefaultSize, 0 );
+	m_SVGCompressOpt->SetToolTip( _("Write gzip compressed SVG files, with the .svgz extension") );
+	
+	bSizerSVG_options->Add( m_SVGCompressOpt, 0, wxALL, 2 );
+	
+	
+	m_SVGOptionsSizer->Add( bSizerSVG_options, 1, wxEXPAND, 5 );
+	
+	
+	m_PlotOptionsSizer->Add( m_SVGOptionsSizer, 0, wxALL|wxEXPAND, 3 );
+	
 	m_PSOptionsSizer = new wxStaticBoxSizer( new wxStaticBox( this, wxID_ANY, _("Postscript Options") ), wxVERTICAL );
 	
 	wxBoxSizer* bSizer17;
@@ -78,6 +78,7 @@ class DIALOG_PLOT_BASE : public DIALOG_SHIM
 		wxCheckBox* m_plotMirrorOpt;
 		wxCheckBox* m_plotPSNegativeOpt;
 		wxCheckBox* m_useAuxOriginCheckBox;
+		wxCheckBox* m_mergeCopperShapesOpt;
 		wxStaticText* m_staticText11;
 		wxChoice* m_drillShapeOpt;
 		wxStaticText* m_staticText12;
@@ -100,6 +101,10 @@ class DIALOG_PLOT_BASE : public DIALOG_SHIM
 		wxStaticBoxSizer* m_HPGLOptionsSizer;
 		wxStaticText* m_textPenSize;
 		wxTextCtrl* m_HPGLPenSizeOpt;
+		wxStaticBoxSizer* m_SVGOptionsSizer;
+		wxStaticText* m_textSVGPrecision;
+		wxChoice* m_SVGPrecisionOpt;
+		wxCheckBox* m_SVGCompressOpt;
 		wxStaticBoxSizer* m_PSOptionsSizer;
 		wxStaticText* m_staticText7;
 		wxTextCtrl* m_fineAdjustXscaleOpt;
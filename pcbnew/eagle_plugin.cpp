@@ -203,7 +203,6 @@ wxSize inline EAGLE_PLUGIN::kicad_fontz( const ECOORD& d ) const
 BOARD* EAGLE_PLUGIN::Load( const wxString& aFileName, BOARD* aAppendToMe,  const PROPERTIES* aProperties )
 {
     LOCALE_IO       toggle;     // toggles on, then off, the C locale.
-    wxXmlNode*      doc;
 
     init( aProperties );
 
@@ -218,21 +217,15 @@ BOARD* EAGLE_PLUGIN::Load( const wxString& aFileName, BOARD* aAppendToMe,  const
 
     try
     {
-        // Load the document
-        wxXmlDocument xmlDocument;
+        // Open the document, which is streamed instead of being loaded as a whole
         wxFileName fn = aFileName;
-
-        if( !xmlDocument.Load( fn.GetFullPath() ) )
-            THROW_IO_ERROR( wxString::Format( _( "Unable to read file \"%s\"" ),
-                                              fn.GetFullPath() ) );
-
-        doc = xmlDocument.GetRoot();
+        EAGLE_XML_READER reader( fn.GetFullPath() );
 
         m_min_trace    = INT_MAX;
         m_min_via      = INT_MAX;
         m_min_via_hole = INT_MAX;
 
-        loadAllSections( doc );
+        loadAllSections( reader );
 
         BOARD_DESIGN_SETTINGS& designSettings = m_board->GetDesignSettings();
 
@@ -294,6 +287,7 @@ void EAGLE_PLUGIN::init( const PROPERTIES* aProperties )
     m_min_trace    = 0;
     m_min_via      = 0;
     m_min_via_hole = 0;
+    m_next_netcode = 1;
     m_xpath->clear();
     m_pads_to_nets.clear();
 
@@ -315,48 +309,87 @@ void EAGLE_PLUGIN::clear_cu_map()
 }
 
 
-void EAGLE_PLUGIN::loadAllSections( wxXmlNode* aDoc )
+void EAGLE_PLUGIN::loadAllSections( EAGLE_XML_READER& aReader )
 {
-    wxXmlNode* drawing       = MapChildren( aDoc )["drawing"];
-    NODE_MAP drawingChildren = MapChildren( drawing );
+    // The board is streamed: only one child of the big sections (plain, libraries and
+    // signals) is held in memory at a time.  The file is read twice, since the design rules
+    // and layers are needed by all the other sections but may come after them in the file.
+    std::unique_ptr<wxXmlNode> designrules;
+    std::unique_ptr<wxXmlNode> layers;
+    std::unique_ptr<wxXmlNode> elements;
+
+    aReader.Read( []( const wxString& aPath )
+    {
+        if( aPath == "eagle.drawing.layers" || aPath == "eagle.drawing.board.designrules" )
+            return EAGLE_XML_READER::WHOLE;
 
-    wxXmlNode* board         = drawingChildren["board"];
-    NODE_MAP boardChildren   = MapChildren( board );
+        return EAGLE_XML_READER::DESCEND;
+    },
+    [&]( const wxString& aPath, wxXmlNode* aNode )
+    {
+        if( aPath == "eagle.drawing.layers" )
+            layers.reset( aNode );
+        else
+            designrules.reset( aNode );
+
+        if( layers && designrules )
+            aReader.Stop();
+
+        return true;
+    } );
+
+    if( !layers || !designrules )
+        THROW_IO_ERROR( _( "Eagle board file has no layers or design rules" ) );
 
     m_xpath->push( "eagle.drawing" );
 
     {
         m_xpath->push( "board" );
-
-        wxXmlNode* designrules = boardChildren["designrules"];
-        loadDesignRules( designrules );
-
+        loadDesignRules( designrules.get() );
         m_xpath->pop();
     }
 
     {
         m_xpath->push( "layers" );
-
-        wxXmlNode* layers = drawingChildren["layers"];
-        loadLayerDefs( layers );
-
+        loadLayerDefs( layers.get() );
         m_xpath->pop();
     }
 
     {
         m_xpath->push( "board" );
 
-        wxXmlNode* plain = boardChildren["plain"];
-        loadPlain( plain );
+        // Elements need the nets built by loadSignals(), so they are kept until the end.
+        aReader.Read( []( const wxString& aPath )
+        {
+            if( aPath == "eagle.drawing.board.plain"
+                    || aPath == "eagle.drawing.board.libraries"
+                    || aPath == "eagle.drawing.board.signals" )
+                return EAGLE_XML_READER::CHILDREN;
 
-        wxXmlNode*  signals = boardChildren["signals"];
-        loadSignals( signals );
+            if( aPath == "eagle.drawing.board.elements" )
+                return EAGLE_XML_READER::WHOLE;
 
-        wxXmlNode*  libs = boardChildren["libraries"];
-        loadLibraries( libs );
+            return EAGLE_XML_READER::DESCEND;
+        },
+        [&]( const wxString& aPath, wxXmlNode* aNode )
+        {
+            if( aPath == "eagle.drawing.board.plain" )
+                loadPlain( aNode );
+            else if( aPath == "eagle.drawing.board.libraries" )
+                loadLibraries( aNode );
+            else if( aPath == "eagle.drawing.board.signals" )
+                loadSignals( aNode );
+            else
+            {
+                elements.reset( aNode );
+                return true;
+            }
 
-        wxXmlNode* elems = boardChildren["elements"];
-        loadElements( elems );
+            return false;
+        } );
+
+        if( elements )
+            loadElements( elements.get() );
 
         m_xpath->pop();     // "board"
     }
@@ -1798,7 +1831,8 @@ void EAGLE_PLUGIN::loadSignals( wxXmlNode* aSignals )
 
     m_xpath->push( "signals.signal", "name" );
 
-    int netCode = 1;
+    // Signals may be loaded in several calls, see loadAllSections().
+    int netCode = m_next_netcode;
 
     // Get the first signal and iterate
     wxXmlNode* net = aSignals->GetChildren();
@@ -2132,6 +2166,8 @@ void EAGLE_PLUGIN::loadSignals( wxXmlNode* aSignals )
         net = net->GetNext();
     }
 
+    m_next_netcode = netCode;
+
     m_xpath->pop();     // "signals.signal"
 }
 
@@ -179,6 +179,7 @@ private:
     int         m_min_trace;        ///< smallest trace we find on Load(), in BIU.
     int         m_min_via;          ///< smallest via we find on Load(), in BIU.
     int         m_min_via_hole;     ///< smallest via diameter hole we find on Load(), in BIU.
+    int         m_next_netcode;     ///< net code given to the next signal loaded.
 
     wxString    m_lib_path;
     wxDateTime  m_mod_time;
@@ -209,7 +210,7 @@ private:
 
     // all these loadXXX() throw IO_ERROR or ptree_error exceptions:
 
-    void loadAllSections( wxXmlNode* aDocument );
+    void loadAllSections( EAGLE_XML_READER& aReader );
     void loadDesignRules( wxXmlNode* aDesignRules );
     void loadLayerDefs( wxXmlNode* aLayers );
     void loadPlain( wxXmlNode* aPlain );
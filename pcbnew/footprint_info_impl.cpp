@@ -38,9 +38,20 @@
 #include <wildcards_and_files_ext.h>
 #include <widgets/progress_reporter.h>
 
+#include <wx/textfile.h>
+
+#include <boost/uuid/sha1.hpp>
+
 #include <thread>
 
 
+/// Version of the footprint index file format; bump it when the format changes.
+static const wxString FP_INDEX_VERSION = wxT( "fp-index 1" );
+
+/// Directory, inside the KiCad config path, holding the footprint index files.
+static const wxString FP_INDEX_DIR = wxT( "fp-index" );
+
+
 void FOOTPRINT_INFO_IMPL::load()
 {
     FP_LIB_TABLE* fptable = m_owner->GetTable();
@@ -96,6 +107,122 @@ bool FOOTPRINT_LIST_IMPL::CatchErrors( const std::function<void()>& aFunc )
 }
 
 
+static wxFileName indexDirectory()
+{
+    wxFileName dir;
+
+    dir.AssignDir( GetKicadConfigPath() );
+    dir.AppendDir( FP_INDEX_DIR );
+
+    return dir;
+}
+
+
+wxFileName FOOTPRINT_LIST_IMPL::indexFileName( const wxString& aNickname )
+{
+    // The same nickname can point to different libraries in different projects.
+    const FP_LIB_TABLE_ROW* row = m_lib_table->FindRow( aNickname );
+    wxString                key = aNickname + wxT( "|" ) + row->GetFullURI( true );
+    std::string             utf8Key( key.ToUTF8() );
+
+    // The name must not change with the compiler or the standard library, unlike std::hash,
+    // or the indexes would be rebuilt after each toolchain update.
+    boost::uuids::detail::sha1  sha1;
+    unsigned int                digest[5];
+
+    sha1.process_bytes( utf8Key.data(), utf8Key.size() );
+    sha1.get_digest( digest );
+
+    wxFileName fn = indexDirectory();
+
+    fn.SetName( wxString::Format( wxT( "%08x%08x%08x%08x%08x" ),
+                                  digest[0], digest[1], digest[2], digest[3], digest[4] ) );
+    fn.SetExt( wxT( "idx" ) );
+
+    return fn;
+}
+
+
+bool FOOTPRINT_LIST_IMPL::readLibIndex( const wxString& aNickname, long long aTimestamp,
+                                        std::vector<std::unique_ptr<FOOTPRINT_INFO>>& aList )
+{
+    wxFileName  fn = indexFileName( aNickname );
+    wxTextFile  indexFile( fn.GetFullPath() );
+
+    if( !fn.FileExists() || !indexFile.Open() )
+        return false;
+
+    // Header: version, library nickname, library timestamp.
+    if( indexFile.GetLineCount() < 3
+            || indexFile.GetLine( 0 ) != FP_INDEX_VERSION
+            || indexFile.GetLine( 1 ) != aNickname
+            || indexFile.GetLine( 2 ) != wxString::Format( wxT( "%lld" ), aTimestamp ) )
+        return false;
+
+    // Then one record of 5 lines per footprint.
+    const size_t recordSize = 5;
+
+    if( ( indexFile.GetLineCount() - 3 ) % recordSize != 0 )
+        return false;
+
+    for( size_t ii = 3; ii < indexFile.GetLineCount(); ii += recordSize )
+    {
+        long padCount, uniquePadCount;
+
+        if( !indexFile.GetLine( ii + 3 ).ToLong( &padCount )
+                || !indexFile.GetLine( ii + 4 ).ToLong( &uniquePadCount ) )
+        {
+            aList.clear();
+            return false;
+        }
+
+        aList.push_back( std::make_unique<FOOTPRINT_INFO_IMPL>( this, aNickname,
+                                                                indexFile.GetLine( ii ),
+                                                                indexFile.GetLine( ii + 1 ),
+                                                                indexFile.GetLine( ii + 2 ),
+                                                                padCount, uniquePadCount ) );
+    }
+
+    return true;
+}
+
+
+void FOOTPRINT_LIST_IMPL::writeLibIndex( const wxString& aNickname, long long aTimestamp,
+                                         const std::vector<std::unique_ptr<FOOTPRINT_INFO>>& aList )
+{
+    wxFileName  fn = indexFileName( aNickname );
+    wxTextFile  indexFile( fn.GetFullPath() );
+
+    if( !( fn.FileExists() ? indexFile.Open() : indexFile.Create() ) )
+        return;
+
+    indexFile.Clear();
+    indexFile.AddLine( FP_INDEX_VERSION );
+    indexFile.AddLine( aNickname );
+    indexFile.AddLine( wxString::Format( wxT( "%lld" ), aTimestamp ) );
+
+    // Records are line based, so the free text fields are kept on a single line.
+    auto singleLine = []( wxString aText ) -> wxString
+    {
+        aText.Replace( wxT( "\r" ), wxT( " " ) );
+        aText.Replace( wxT( "\n" ), wxT( " " ) );
+        return aText;
+    };
+
+    for( auto& fpinfo : aList )
+    {
+        indexFile.AddLine( fpinfo->GetFootprintName() );
+        indexFile.AddLine( singleLine( fpinfo->GetDoc() ) );
+        indexFile.AddLine( singleLine( fpinfo->GetKeywords() ) );
+        indexFile.AddLine( wxString::Format( wxT( "%u" ), fpinfo->GetPadCount() ) );
+        indexFile.AddLine( wxString::Format( wxT( "%u" ), fpinfo->GetUniquePadCount() ) );
+    }
+
+    indexFile.Write();
+    indexFile.Close();
+}
+
+
 void FOOTPRINT_LIST_IMPL::loader_job()
 {
     wxString nickname;
@@ -226,6 +353,13 @@ bool FOOTPRINT_LIST_IMPL::JoinWorkers()
     SYNC_QUEUE<std::unique_ptr<FOOTPRINT_INFO>> queue_parsed;
     std::vector<std::thread>                    threads;
 
+    // The footprint index files are stored per library.  A library whose timestamp matches
+    // its index is not parsed at all.
+    wxFileName indexDir = indexDirectory();
+
+    if( !indexDir.DirExists() )
+        indexDir.Mkdir( wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL );
+
     for( size_t ii = 0; ii < std::thread::hardware_concurrency() + 1; ++ii )
     {
         threads.push_back( std::thread( [this, &queue_parsed]() {
@@ -233,7 +367,32 @@ bool FOOTPRINT_LIST_IMPL::JoinWorkers()
 
             while( this->m_queue_out.pop( nickname ) && !m_cancelled )
             {
-                wxArrayString fpnames;
+                wxArrayString                                   fpnames;
+                std::vector<std::unique_ptr<FOOTPRINT_INFO>>    fpinfos;
+                long long                                       timestamp = 0;
+                bool                                            libOk = true;
+
+                try
+                {
+                    timestamp = m_lib_table->GenerateTimestamp( &nickname );
+                }
+                catch( const IO_ERROR& )
+                {
+                    // FootprintEnumerate() below will report the problem.
+                    libOk = false;
+                }
+
+                if( libOk && readLibIndex( nickname, timestamp, fpinfos ) )
+                {
+                    for( auto& fpinfo : fpinfos )
+                        queue_parsed.move_push( std::move( fpinfo ) );
+
+                    if( m_progress_reporter )
+                        m_progress_reporter->AdvanceProgress();
+
+                    m_count_finished.fetch_add( 1 );
+                    continue;
+                }
 
                 try
                 {
@@ -241,6 +400,7 @@ bool FOOTPRINT_LIST_IMPL::JoinWorkers()
                 }
                 catch( const IO_ERROR& ioe )
                 {
+                    libOk = false;
                     m_errors.move_push( std::make_unique<IO_ERROR>( ioe ) );
                 }
                 catch( const std::exception& se )
@@ -253,6 +413,7 @@ bool FOOTPRINT_LIST_IMPL::JoinWorkers()
                     }
                     catch( const IO_ERROR& ioe )
                     {
+                        libOk = false;
                         m_errors.move_push( std::make_unique<IO_ERROR>( ioe ) );
                     }
                 }
@@ -261,9 +422,16 @@ bool FOOTPRINT_LIST_IMPL::JoinWorkers()
                 {
                     wxString fpname = fpnames[jj];
                     FOOTPRINT_INFO* fpinfo = new FOOTPRINT_INFO_IMPL( this, nickname, fpname );
-                    queue_parsed.move_push( std::unique_ptr<FOOTPRINT_INFO>( fpinfo ) );
+                    fpinfos.push_back( std::unique_ptr<FOOTPRINT_INFO>( fpinfo ) );
                 }
 
+                // Only index complete libraries, so errors are reported again next time.
+                if( libOk && !m_cancelled )
+                    writeLibIndex( nickname, timestamp, fpinfos );
+
+                for( auto& fpinfo : fpinfos )
+                    queue_parsed.move_push( std::move( fpinfo ) );
+
                 if( m_progress_reporter )
                     m_progress_reporter->AdvanceProgress();
 
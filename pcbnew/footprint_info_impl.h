@@ -28,6 +28,7 @@
 
 #include <footprint_info.h>
 #include <sync_queue.h>
+#include <wx/filename.h>
 #include <widgets/progress_reporter.h>
 
 class LOCALE_IO;
@@ -50,6 +51,24 @@ public:
 #endif
     }
 
+    /**
+     * Construct an already loaded footprint info, e.g. from a footprint index file.
+     */
+    FOOTPRINT_INFO_IMPL( FOOTPRINT_LIST* aOwner, const wxString& aNickname,
+                         const wxString& aFootprintName, const wxString& aDoc,
+                         const wxString& aKeywords, int aPadCount, int aUniquePadCount )
+    {
+        m_owner = aOwner;
+        m_loaded = true;
+        m_nickname = aNickname;
+        m_fpname = aFootprintName;
+        m_num = 0;
+        m_pad_count = aPadCount;
+        m_unique_pad_count = aUniquePadCount;
+        m_doc = aDoc;
+        m_keywords = aKeywords;
+    }
+
 protected:
     virtual void load() override;
 };
@@ -73,6 +92,29 @@ class FOOTPRINT_LIST_IMPL : public FOOTPRINT_LIST
      */
     bool CatchErrors( const std::function<void()>& aFunc );
 
+    /**
+     * Return the name of the footprint index file of library \a aNickname.
+     */
+    wxFileName indexFileName( const wxString& aNickname );
+
+    /**
+     * Read the footprint index file of library \a aNickname.
+     *
+     * @param aTimestamp is the current library timestamp; the index is only used when it
+     *                   was written for the same timestamp.
+     * @param aList receives the footprint infos read from the index.
+     * @return true if a valid, up to date index was read.
+     */
+    bool readLibIndex( const wxString& aNickname, long long aTimestamp,
+                       std::vector<std::unique_ptr<FOOTPRINT_INFO>>& aList );
+
+    /**
+     * Write the footprint index file of library \a aNickname.  Failures are silently
+     * ignored: the index is only an accelerator.
+     */
+    void writeLibIndex( const wxString& aNickname, long long aTimestamp,
+                        const std::vector<std::unique_ptr<FOOTPRINT_INFO>>& aList );
+
 protected:
     virtual void StartWorkers( FP_LIB_TABLE* aTable, wxString const* aNickname,
             FOOTPRINT_ASYNC_LOADER* aLoader, unsigned aNThreads ) override;
@@ -49,6 +49,7 @@
 #include <wx/wfstream.h>
 #include <boost/ptr_container/ptr_map.hpp>
 #include <memory.h>
+#include <set>
 #include <connectivity_data.h>
 
 using namespace PCB_KEYS_T;
@@ -93,6 +94,8 @@ class FP_CACHE_ITEM
 {
     wxFileName              m_file_name; ///< The the full file name and path of the footprint to cache.
     std::unique_ptr<MODULE> m_module;
+    long long               m_mod_time;  ///< File modification time when the footprint was cached.
+    wxULongLong             m_file_size; ///< File size when the footprint was cached.
 
 public:
     FP_CACHE_ITEM( MODULE* aModule, const wxFileName& aFileName );
@@ -101,6 +104,22 @@ public:
     wxFileName  GetFileName() const { return m_file_name; }
 
     MODULE*     GetModule() const { return m_module.get(); }
+
+    long long   GetModificationTime() const { return m_mod_time; }
+
+    /**
+     * Function UpdateFileInfo
+     * records the current modification time and size of the footprint file so later
+     * changes to the file can be detected by #IsFileModified().
+     */
+    void UpdateFileInfo();
+
+    /**
+     * Function IsFileModified
+     * @return true if the footprint file was changed or removed since the last call to
+     *         #UpdateFileInfo().
+     */
+    bool IsFileModified() const;
 };
 
 
@@ -108,6 +127,32 @@ FP_CACHE_ITEM::FP_CACHE_ITEM( MODULE* aModule, const wxFileName& aFileName ) :
     m_module( aModule )
 {
     m_file_name = aFileName;
+    UpdateFileInfo();
+}
+
+
+void FP_CACHE_ITEM::UpdateFileInfo()
+{
+    if( m_file_name.FileExists() )
+    {
+        m_mod_time  = m_file_name.GetModificationTime().GetValue().GetValue();
+        m_file_size = m_file_name.GetSize();
+    }
+    else
+    {
+        m_mod_time  = 0;
+        m_file_size = wxInvalidSize;
+    }
+}
+
+
+bool FP_CACHE_ITEM::IsFileModified() const
+{
+    if( !m_file_name.FileExists() )
+        return true;
+
+    return m_file_name.GetModificationTime().GetValue().GetValue() != m_mod_time
+            || m_file_name.GetSize() != m_file_size;
 }
 
 
@@ -146,6 +191,14 @@ public:
      */
     void Save( MODULE* aModule = NULL );
 
+    /**
+     * Function Load
+     * reads the footprint files of the library into the cache.
+     *
+     * When the cache already holds footprints, only files that were added or changed since
+     * they were cached are parsed.  Footprints whose file is unchanged are kept in memory and
+     * footprints whose file was removed are dropped from the cache.
+     */
     void Load();
 
     void Remove( const wxString& aFootprintName );
@@ -158,6 +211,19 @@ public:
      */
     long long GetTimestamp();
 
+    /**
+     * Function GetTimestamp
+     * Generate the same timestamp as the member function, but directly from the files found
+     * in \a aLibPath, without requiring the library to be loaded into a cache.
+     *
+     * @param aDirTime is the modification time of \a aLibPath when \a aFiles was filled.
+     * @param aFiles is the list of the footprint files of \a aLibPath.  The directory is only
+     *               listed again, and both parameters updated, when it was modified (i.e.
+     *               when files were added, removed or renamed).
+     */
+    static long long GetTimestamp( const wxString& aLibPath, long long& aDirTime,
+                                   wxArrayString& aFiles );
+
     /**
      * Function IsModified
      * Return true if the cache is not up-to-date.
@@ -247,7 +313,8 @@ void FP_CACHE::Save( MODULE* aModule )
             THROW_IO_ERROR( msg );
         }
 #endif
-        m_cache_timestamp += fn.GetModificationTime().GetValue().GetValue();
+        it->second->UpdateFileInfo();
+        m_cache_timestamp += it->second->GetModificationTime();
     }
 
     m_cache_timestamp += m_lib_path.GetModificationTime().GetValue().GetValue();
@@ -264,6 +331,7 @@ void FP_CACHE::Load()
 
     if( !dir.IsOpened() )
     {
+        m_modules.clear();
         m_cache_timestamp = 0;
         m_cache_dirty = false;
 
@@ -280,18 +348,38 @@ void FP_CACHE::Load()
         m_cache_dirty = false;
     }
 
-    wxString fpFileName;
-    wxString wildcard = wxT( "*." ) + KiCadFootprintFileExtension;
+    wxString            fpFileName;
+    wxString            wildcard = wxT( "*." ) + KiCadFootprintFileExtension;
+    std::set<wxString>  fpNamesOnDisk;
+    wxString            cacheError;
 
     if( dir.GetFirst( &fpFileName, wildcard, wxDIR_FILES ) )
     {
-        wxString cacheError;
-
         do
         {
             // prepend the libpath into fullPath
             wxFileName fullPath( m_lib_path.GetPath(), fpFileName );
 
+            // The footprint name is the file name without the extension.
+            wxString    fpName = fullPath.GetName();
+            MODULE_ITER it = m_modules.find( fpName );
+
+            fpNamesOnDisk.insert( fpName );
+
+            // Keep footprints whose file did not change since it was parsed.
+            if( it != m_modules.end() && !it->second->IsFileModified() )
+            {
+                m_cache_timestamp += it->second->GetModificationTime();
+                continue;
+            }
+
+            // The cached copy is stale, even if the new file fails to parse.
+            if( it != m_modules.end() )
+                m_modules.erase( it );
+
+            wxLogTrace( traceFootprintLibrary, wxT( "Parsing footprint file %s" ),
+                        GetChars( fullPath.GetFullPath() ) );
+
             // Queue I/O errors so only files that fail to parse don't get loaded.
             try
             {
@@ -299,15 +387,13 @@ void FP_CACHE::Load()
 
                 m_owner->m_parser->SetLineReader( &reader );
 
-                MODULE*     footprint = (MODULE*) m_owner->m_parser->Parse();
-
-                // The footprint name is the file name without the extension.
-                wxString    fpName = fullPath.GetName();
+                MODULE*         footprint = (MODULE*) m_owner->m_parser->Parse();
+                FP_CACHE_ITEM*  item = new FP_CACHE_ITEM( footprint, fullPath );
 
                 footprint->SetFPID( LIB_ID( fpName ) );
-                m_modules.insert( fpName, new FP_CACHE_ITEM( footprint, fullPath ) );
+                m_modules.insert( fpName, item );
 
-                m_cache_timestamp += fullPath.GetModificationTime().GetValue().GetValue();
+                m_cache_timestamp += item->GetModificationTime();
             }
             catch( const IO_ERROR& ioe )
             {
@@ -317,10 +403,25 @@ void FP_CACHE::Load()
                 cacheError += ioe.What();
             }
         } while( dir.GetNext( &fpFileName ) );
+    }
 
-        if( !cacheError.IsEmpty() )
-            THROW_IO_ERROR( cacheError );
+    // Drop the footprints whose file was removed from the library.
+    for( MODULE_ITER it = m_modules.begin();  it != m_modules.end(); )
+    {
+        if( fpNamesOnDisk.count( it->first ) == 0 )
+        {
+            wxLogTrace( traceFootprintLibrary, wxT( "Dropping removed footprint %s" ),
+                        GetChars( it->first ) );
+            m_modules.erase( it++ );
+        }
+        else
+        {
+            ++it;
+        }
     }
+
+    if( !cacheError.IsEmpty() )
+        THROW_IO_ERROR( cacheError );
 }
 
 
@@ -393,6 +494,50 @@ long long FP_CACHE::GetTimestamp()
 }
 
 
+long long FP_CACHE::GetTimestamp( const wxString& aLibPath, long long& aDirTime,
+                                 wxArrayString& aFiles )
+{
+    wxFileName  libPath;
+    libPath.AssignDir( aLibPath );
+
+    if( !libPath.DirExists() )
+        return wxDateTime::Now().GetValue().GetValue();
+
+    long long   files_timestamp = libPath.GetModificationTime().GetValue().GetValue();
+
+    if( files_timestamp != aDirTime )
+    {
+        wxDir dir( aLibPath );
+
+        if( !dir.IsOpened() )
+            return wxDateTime::Now().GetValue().GetValue();
+
+        aFiles.Clear();
+        aDirTime = files_timestamp;
+
+        wxString    fpFileName;
+        wxString    wildcard = wxT( "*." ) + KiCadFootprintFileExtension;
+
+        if( dir.GetFirst( &fpFileName, wildcard, wxDIR_FILES ) )
+        {
+            do
+            {
+                aFiles.Add( wxFileName( aLibPath, fpFileName ).GetFullPath() );
+            } while( dir.GetNext( &fpFileName ) );
+        }
+    }
+
+    for( size_t ii = 0; ii < aFiles.GetCount(); ++ii )
+    {
+        wxFileName fpFile( aFiles[ii] );
+
+        files_timestamp += fpFile.GetModificationTime().GetValue().GetValue();
+    }
+
+    return files_timestamp;
+}
+
+
 void PCB_IO::Save( const wxString& aFileName, BOARD* aBoard, const PROPERTIES* aProperties )
 {
     LOCALE_IO   toggle;     // toggles on, then off, the C locale.
@@ -1893,6 +2038,7 @@ void PCB_IO::format( ZONE_CONTAINER* aZone, int aNestLevel ) const
 
 PCB_IO::PCB_IO( int aControlFlags ) :
     m_cache( 0 ),
+    m_timestamp_dir_time( 0 ),
     m_ctl( aControlFlags ),
     m_parser( new PCB_PARSER() ),
     m_mapping( new NETINFO_MAPPING() )
@@ -1965,13 +2111,18 @@ void PCB_IO::init( const PROPERTIES* aProperties )
 
 void PCB_IO::validateCache( const wxString& aLibraryPath, bool checkModified )
 {
-    if( !m_cache || !m_cache->IsPath( aLibraryPath ) || ( checkModified && m_cache->IsModified() ) )
+    if( !m_cache || !m_cache->IsPath( aLibraryPath ) )
     {
         // a spectacular episode in memory management:
         delete m_cache;
         m_cache = new FP_CACHE( this, aLibraryPath );
         m_cache->Load();
     }
+    else if( checkModified && m_cache->IsModified() )
+    {
+        // Only the footprint files which changed since the last load are parsed again.
+        m_cache->Load();
+    }
 }
 
 
@@ -2150,9 +2301,19 @@ void PCB_IO::FootprintDelete( const wxString& aLibraryPath, const wxString& aFoo
 
 long long PCB_IO::GetLibraryTimestamp( const wxString& aLibraryPath ) const
 {
-    // If we have no cache, return a number which won't match any stored timestamps
+    // If we have no cache, build the timestamp from the file dates so it can be compared
+    // with timestamps stored before the library was loaded (e.g. in a footprint index).
     if( !m_cache || !m_cache->IsPath( aLibraryPath ) )
-        return wxDateTime::Now().GetValue().GetValue();
+    {
+        if( aLibraryPath != m_timestamp_lib_path )
+        {
+            m_timestamp_lib_path = aLibraryPath;
+            m_timestamp_dir_time = 0;
+            m_timestamp_files.Clear();
+        }
+
+        return FP_CACHE::GetTimestamp( aLibraryPath, m_timestamp_dir_time, m_timestamp_files );
+    }
 
     return m_cache->GetTimestamp();
 }
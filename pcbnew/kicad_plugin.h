@@ -179,6 +179,12 @@ protected:
     PROPERTIES*     m_props;        ///< passed via Save() or Load(), no ownership, may be NULL.
     FP_CACHE*       m_cache;        ///< Footprint library cache.
 
+    /// The footprint files of the library last timestamped without a cache, so its
+    /// directory is not listed on each GetLibraryTimestamp() call.
+    mutable wxString        m_timestamp_lib_path;
+    mutable long long       m_timestamp_dir_time;
+    mutable wxArrayString   m_timestamp_files;
+
     LINE_READER*    m_reader;       ///< no ownership here.
     wxString        m_filename;     ///< for saves only, name is in m_reader for loads
 
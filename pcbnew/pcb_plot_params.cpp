@@ -81,6 +81,9 @@ PCB_PLOT_PARAMS::PCB_PLOT_PARAMS()
     m_useGerberAttributes        = false;
     m_includeGerberNetlistInfo   = false;
     m_createGerberJobFile        = false;
+    m_mergeCopperShapes          = false;
+    m_svgPrecision               = -1;
+    m_svgCompressed              = false;
     m_gerberPrecision            = gbrDefaultPrecision;
     m_excludeEdgeLayer           = true;
     m_lineWidth                  = g_DrawDefaultLineThickness;
@@ -160,6 +163,18 @@ void PCB_PLOT_PARAMS::Format( OUTPUTFORMATTER* aFormatter,
         aFormatter->Print( aNestLevel+1, "(%s %d)\n",
                            getTokenName( T_gerberprecision ), m_gerberPrecision );
 
+    if( m_mergeCopperShapes )   // same as m_gerberPrecision
+        aFormatter->Print( aNestLevel+1, "(%s %s)\n",
+                           getTokenName( T_mergecoppershapes ), trueStr );
+
+    if( m_svgPrecision >= 0 )   // same as m_gerberPrecision
+        aFormatter->Print( aNestLevel+1, "(%s %d)\n",
+                           getTokenName( T_svgprecision ), m_svgPrecision );
+
+    if( m_svgCompressed )       // same as m_gerberPrecision
+        aFormatter->Print( aNestLevel+1, "(%s %s)\n",
+                           getTokenName( T_svgcompressed ), trueStr );
+
     aFormatter->Print( aNestLevel+1, "(%s %s)\n", getTokenName( T_excludeedgelayer ),
                        m_excludeEdgeLayer ? trueStr : falseStr );
     aFormatter->Print( aNestLevel+1, "(%s %f)\n", getTokenName( T_linewidth ),
@@ -230,6 +245,12 @@ bool PCB_PLOT_PARAMS::IsSameAs( const PCB_PLOT_PARAMS &aPcbPlotParams, bool aCom
         return false;
     if( m_createGerberJobFile != aPcbPlotParams.m_createGerberJobFile )
         return false;
+    if( m_mergeCopperShapes != aPcbPlotParams.m_mergeCopperShapes )
+        return false;
+    if( m_svgPrecision != aPcbPlotParams.m_svgPrecision )
+        return false;
+    if( m_svgCompressed != aPcbPlotParams.m_svgCompressed )
+        return false;
     if( m_gerberPrecision != aPcbPlotParams.m_gerberPrecision )
         return false;
     if( m_excludeEdgeLayer != aPcbPlotParams.m_excludeEdgeLayer )
@@ -398,6 +419,18 @@ void PCB_PLOT_PARAMS_PARSER::Parse( PCB_PLOT_PARAMS* aPcbPlotParams )
             aPcbPlotParams->m_createGerberJobFile = parseBool();
             break;
 
+        case T_mergecoppershapes:
+            aPcbPlotParams->m_mergeCopperShapes = parseBool();
+            break;
+
+        case T_svgprecision:
+            aPcbPlotParams->m_svgPrecision = parseInt( -1, 6 );
+            break;
+
+        case T_svgcompressed:
+            aPcbPlotParams->m_svgCompressed = parseBool();
+            break;
+
         case T_gerberprecision:
             aPcbPlotParams->m_gerberPrecision =
                 parseInt( gbrDefaultPrecision-1, gbrDefaultPrecision);
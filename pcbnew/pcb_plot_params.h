@@ -111,6 +111,19 @@ private:
     /// generate the auxiliary "job file" in gerber format
     bool        m_createGerberJobFile;
 
+    /** Plot copper layers as the union of their shapes, i.e. as filled polygons
+     * (regions in gerber files) instead of overlapping flashes, strokes and zones
+     */
+    bool        m_mergeCopperShapes;
+
+    /** Number of decimals of coordinates in SVG files.
+     * -1 to use the legacy output, 0 or more to merge the shapes in compact paths
+     */
+    int         m_svgPrecision;
+
+    /// Write gzip compressed SVG files (.svgz)
+    bool        m_svgCompressed;
+
     /// precision of coordinates in Gerber files: accepted 5 or 6
     /// when units are in mm (6 or 7 in inches, but Pcbnew uses mm).
     /// 6 is the internal resolution of Pcbnew, but not alwys accepted by board maker
@@ -251,6 +264,15 @@ public:
     void        SetCreateGerberJobFile( bool aCreate ) { m_createGerberJobFile = aCreate; }
     bool        GetCreateGerberJobFile() const { return m_createGerberJobFile; }
 
+    void        SetMergeCopperShapes( bool aMerge ) { m_mergeCopperShapes = aMerge; }
+    bool        GetMergeCopperShapes() const { return m_mergeCopperShapes; }
+
+    void        SetSvgPrecision( int aPrecision ) { m_svgPrecision = aPrecision; }
+    int         GetSvgPrecision() const { return m_svgPrecision; }
+
+    void        SetSvgCompressed( bool aCompress ) { m_svgCompressed = aCompress; }
+    bool        GetSvgCompressed() const { return m_svgCompressed; }
+
     void        SetUseGerberProtelExtensions( bool aUse ) { m_useGerberProtelExtensions = aUse; }
     bool        GetUseGerberProtelExtensions() const { return m_useGerberProtelExtensions; }
 
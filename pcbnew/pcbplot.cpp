@@ -571,6 +571,9 @@ bool PLOT_CONTROLLER::OpenPlotfile( const wxString &aSuffix,
         m_plotFile.SetPath( outputDir.GetPath() );
         wxString fileExt = GetDefaultPlotExtension( aFormat );
 
+        if( aFormat == PLOT_FORMAT_SVG && GetPlotOptions().GetSvgCompressed() )
+            fileExt = SVG_PLOTTER::GetCompressedFileExtension();
+
         // Gerber format can use specific file ext, depending on layers
         // (now not a good practice, because the official file ext is .gbr)
         if( GetPlotOptions().GetFormat() == PLOT_FORMAT_GERBER &&
@@ -29,6 +29,8 @@
 #ifndef PCBPLOT_H_
 #define PCBPLOT_H_
 
+#include <vector>
+
 #include <wx/filename.h>
 #include <pad_shapes.h>
 #include <pcb_plot_params.h>
@@ -183,6 +185,24 @@ PLOTTER* StartPlotBoard( BOARD* aBoard,
 void PlotOneBoardLayer( BOARD *aBoard, PLOTTER* aPlotter, PCB_LAYER_ID aLayer,
                         const PCB_PLOT_PARAMS& aPlotOpt );
 
+/**
+ * Function PlotLayersToFiles
+ * plots each layer of a list to its own file, like StartPlotBoard() followed by
+ * PlotOneBoardLayer() would, but plots several layers at once using threads.
+ * Each layer has its own plotter, so the files are the same as when plotted one by one.
+ * The board must not be modified until the function returns.
+ * @param aBoard = the board to plot
+ * @param aPlotOpts = the plot options
+ * @param aLayers = the layers to plot
+ * @param aFullFileNames = the full file name of each layer of aLayers
+ * @param aSheetDesc = the sheet description, used when plotting the frame reference
+ * @return a flag for each layer of aLayers, false if its file could not be created.
+ */
+std::vector<bool> PlotLayersToFiles( BOARD* aBoard, PCB_PLOT_PARAMS* aPlotOpts,
+                                     const std::vector<PCB_LAYER_ID>& aLayers,
+                                     const std::vector<wxString>& aFullFileNames,
+                                     const wxString& aSheetDesc );
+
 /**
  * Function PlotStandardLayer
  * plot copper or technical layers.
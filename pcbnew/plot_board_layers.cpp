@@ -51,6 +51,11 @@
 #include <pcbnew.h>
 #include <pcbplot.h>
 #include <plot_auxiliary_data.h>
+#include <geometry/geometry_utils.h>
+
+#include <atomic>
+#include <mutex>
+#include <thread>
 
 // Local
 /* Plot a solder mask layer.
@@ -61,6 +66,13 @@ static void PlotSolderMaskLayer( BOARD *aBoard, PLOTTER* aPlotter,
                                  LSET aLayerMask, const PCB_PLOT_PARAMS& aPlotOpt,
                                  int aMinThickness );
 
+/* Plot a copper layer as the union of the shapes of its items.
+ * Pads, tracks, vias, texts and zones are converted to polygons and merged, then plotted
+ * as filled polygons (regions in gerber files), so no item overlaps an other one.
+ */
+static void PlotMergedCopperLayer( BOARD* aBoard, PLOTTER* aPlotter, PCB_LAYER_ID aLayer,
+                                   LSET aLayerMask, const PCB_PLOT_PARAMS& aPlotOpt );
+
 /* Creates the plot for silkscreen layers
  * Silkscreen layers have specific requirement for pads (not filled) and texts
  * (with option to remove them from some copper areas (pads...)
@@ -177,6 +189,10 @@ void PlotOneBoardLayer( BOARD *aBoard, PLOTTER* aPlotter, PCB_LAYER_ID aLayer,
             plotOpt.SetSkipPlotNPTH_Pads( false );
             PlotLayerOutlines( aBoard, aPlotter, layer_mask, plotOpt );
         }
+        else if( plotOpt.GetMergeCopperShapes() && plotOpt.GetPlotMode() == FILLED )
+        {
+            PlotMergedCopperLayer( aBoard, aPlotter, aLayer, layer_mask, plotOpt );
+        }
         else
         {
             plotOpt.SetSkipPlotNPTH_Pads( true );
@@ -372,7 +388,10 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
             wxSize extraSize = margin * 2;
             extraSize.x += width_adj;
             extraSize.y += width_adj;
-            wxSize deltaSize = pad->GetDelta(); // has meaning only for trapezoidal pads
+
+            // The pad is plotted from a copy with the plot size, since the board may be
+            // plotted by several threads at once (see PlotLayersToFiles()).
+            D_PAD dummy( *pad );
 
             if( pad->GetShape() == PAD_SHAPE_TRAPEZOID )
             {   // The easy way is to use BuildPadPolygon to calculate
@@ -405,7 +424,7 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
                 else
                     delta.y = coord[1].x - coord[0].x;
 
-                pad->SetDelta( delta );
+                dummy.SetDelta( delta );
             }
             else
                 padPlotsSize = pad->GetSize() + extraSize;
@@ -422,29 +441,24 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
             if( pad->GetLayerSet()[F_Cu] )
                 color = color.LegacyMix( aBoard->Colors().GetItemColor( LAYER_PAD_FR ) );
 
-            // Temporary set the pad size to the required plot size:
-            wxSize tmppadsize = pad->GetSize();
-            pad->SetSize( padPlotsSize );
+            dummy.SetSize( padPlotsSize );
 
             switch( pad->GetShape() )
             {
             case PAD_SHAPE_CIRCLE:
             case PAD_SHAPE_OVAL:
                 if( aPlotOpt.GetSkipPlotNPTH_Pads() &&
-                    ( pad->GetSize() == pad->GetDrillSize() ) &&
-                    ( pad->GetAttribute() == PAD_ATTRIB_HOLE_NOT_PLATED ) )
+                    ( dummy.GetSize() == dummy.GetDrillSize() ) &&
+                    ( dummy.GetAttribute() == PAD_ATTRIB_HOLE_NOT_PLATED ) )
                     break;
                 // Fall through:
             case PAD_SHAPE_TRAPEZOID:
             case PAD_SHAPE_RECT:
             case PAD_SHAPE_ROUNDRECT:
             default:
-                itemplotter.PlotPad( pad, color, plotMode );
+                itemplotter.PlotPad( &dummy, color, plotMode );
                 break;
             }
-
-            pad->SetSize( tmppadsize );     // Restore the pad size
-            pad->SetDelta( deltaSize );
         }
 
         aPlotter->EndBlock( NULL );
@@ -574,6 +588,103 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
 }
 
 
+
+void PlotMergedCopperLayer( BOARD* aBoard, PLOTTER* aPlotter, PCB_LAYER_ID aLayer,
+                            LSET aLayerMask, const PCB_PLOT_PARAMS& aPlotOpt )
+{
+    BRDITEMS_PLOTTER itemplotter( aPlotter, aBoard, aPlotOpt );
+
+    // The board edges are not copper: they are plotted as usual
+    if( aLayerMask[Edge_Cuts] )
+    {
+        itemplotter.SetLayerSet( LSET( Edge_Cuts ) );
+        itemplotter.PlotBoardGraphicItems();
+    }
+
+    itemplotter.SetLayerSet( aLayerMask );
+
+    // Build the copper shapes like the 3D viewer and DXF outlines do, but with the
+    // accuracy used to fill zones, then merge them and remove the holes
+    // (gerber regions cannot have holes)
+    SHAPE_POLY_SET areas;
+
+    // The footprint texts are added below, following the plot options.
+    // NPTH pads with no copper around their hole are not on copper layers
+    aBoard->ConvertBrdLayerToPolygonalContours( aLayer, areas,
+                                                ARC_APPROX_SEGMENTS_COUNT_HIGHT_DEF, false, true );
+
+    const double correctionFactor =
+            GetCircletoPolyCorrectionFactor( ARC_APPROX_SEGMENTS_COUNT_HIGHT_DEF );
+
+    for( MODULE* module = aBoard->m_Modules; module; module = module->Next() )
+    {
+        // Same selection as BRDITEMS_PLOTTER::PlotAllTextsModule()
+        std::vector< TEXTE_MODULE* > texts;
+
+        if( aPlotOpt.GetPlotReference() && module->Reference().GetLayer() == aLayer
+            && ( module->Reference().IsVisible() || aPlotOpt.GetPlotInvisibleText() ) )
+            texts.push_back( &module->Reference() );
+
+        if( aPlotOpt.GetPlotValue() && module->Value().GetLayer() == aLayer
+            && ( module->Value().IsVisible() || aPlotOpt.GetPlotInvisibleText() ) )
+            texts.push_back( &module->Value() );
+
+        for( BOARD_ITEM* item = module->GraphicalItemsList(); item; item = item->Next() )
+        {
+            TEXTE_MODULE* textModule = dyn_cast<TEXTE_MODULE*>( item );
+
+            if( !textModule || !textModule->IsVisible() || textModule->GetLayer() != aLayer )
+                continue;
+
+            if( textModule->GetText() == wxT( "%R" ) && !aPlotOpt.GetPlotReference() )
+                continue;
+
+            if( textModule->GetText() == wxT( "%V" ) && !aPlotOpt.GetPlotValue() )
+                continue;
+
+            texts.push_back( textModule );
+        }
+
+        for( TEXTE_MODULE* text : texts )
+            text->TransformShapeWithClearanceToPolygonSet( areas, 0,
+                                                           ARC_APPROX_SEGMENTS_COUNT_HIGHT_DEF,
+                                                           correctionFactor );
+    }
+
+    areas.Simplify( SHAPE_POLY_SET::PM_FAST );
+    areas.Fracture( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+
+    GBR_METADATA gbr_metadata;
+    gbr_metadata.SetApertureAttrib( GBR_APERTURE_METADATA::GBR_APERTURE_ATTRIB_CONDUCTOR );
+
+    std::vector< wxPoint > cornerList;
+
+    aPlotter->SetColor( itemplotter.getColor( aLayer ) );
+    aPlotter->StartBlock( NULL );
+
+    for( int ii = 0; ii < areas.OutlineCount(); ii++ )
+    {
+        const SHAPE_LINE_CHAIN& outline = areas.COutline( ii );
+
+        cornerList.clear();
+
+        for( int jj = 0; jj < outline.PointCount(); jj++ )
+            cornerList.push_back( wxPoint( outline.CPoint( jj ).x, outline.CPoint( jj ).y ) );
+
+        // Ensure the polygon is closed
+        if( cornerList.size() && cornerList[0] != cornerList.back() )
+            cornerList.push_back( cornerList[0] );
+
+        aPlotter->PlotPoly( cornerList, FILLED_SHAPE, 0, &gbr_metadata );
+    }
+
+    aPlotter->EndBlock( NULL );
+
+    // Adding drill marks, if required and if the plotter is able to plot them:
+    if( aPlotOpt.GetDrillMarksType() != PCB_PLOT_PARAMS::NO_DRILL_SHAPE )
+        itemplotter.PlotDrillMarks();
+}
+
 // Seems like we want to plot from back to front?
 static const PCB_LAYER_ID plot_seq[] = {
 
@@ -1055,7 +1166,13 @@ PLOTTER* StartPlotBoard( BOARD *aBoard, PCB_PLOT_PARAMS *aPlotOpts,
         break;
 
     case PLOT_FORMAT_SVG:
-        plotter = new SVG_PLOTTER();
+        SVG_PLOTTER* SVG_plotter;
+        SVG_plotter = new SVG_PLOTTER();
+
+        if( aPlotOpts->GetSvgPrecision() >= 0 )
+            SVG_plotter->SetCompactOutput( true, aPlotOpts->GetSvgPrecision() );
+
+        plotter = SVG_plotter;
         break;
 
     default:
@@ -1126,3 +1243,67 @@ PLOTTER* StartPlotBoard( BOARD *aBoard, PCB_PLOT_PARAMS *aPlotOpts,
     delete plotter;
     return NULL;
 }
+
+
+std::vector<bool> PlotLayersToFiles( BOARD* aBoard, PCB_PLOT_PARAMS* aPlotOpts,
+                                     const std::vector<PCB_LAYER_ID>& aLayers,
+                                     const std::vector<wxString>& aFullFileNames,
+                                     const wxString& aSheetDesc )
+{
+    wxASSERT( aLayers.size() == aFullFileNames.size() );
+
+    // The worker threads print numbers too, and share the C locale set here.
+    LOCALE_IO toggle;
+
+    // Pads compute their bounding radius on first use: do it here, not from the threads.
+    for( MODULE* module = aBoard->m_Modules;  module;  module = module->Next() )
+    {
+        for( D_PAD* pad = module->PadsList();  pad;  pad = pad->Next() )
+            pad->GetBoundingRadius();
+    }
+
+    // std::vector<bool> elements cannot be written by several threads
+    std::vector<char>   plotted( aLayers.size(), false );
+    std::atomic<size_t> nextLayer( 0 );
+    std::mutex          startMutex;
+
+    auto plotLayers = [&]()
+    {
+        for( size_t ii = nextLayer++; ii < aLayers.size(); ii = nextLayer++ )
+        {
+            PLOTTER* plotter;
+
+            {
+                // The page layout used to plot the frame reference is shared
+                std::lock_guard<std::mutex> lock( startMutex );
+
+                plotter = StartPlotBoard( aBoard, aPlotOpts, aLayers[ii], aFullFileNames[ii],
+                                          aSheetDesc );
+            }
+
+            if( !plotter )
+                continue;
+
+            PlotOneBoardLayer( aBoard, plotter, aLayers[ii], *aPlotOpts );
+            plotter->EndPlot();
+            delete plotter;
+
+            plotted[ii] = true;
+        }
+    };
+
+    size_t threadCount = std::min<size_t>( aLayers.size(),
+                                           std::max( 1U, std::thread::hardware_concurrency() ) );
+    std::vector<std::thread> workers;
+
+    // The calling thread plots layers too
+    for( size_t ii = 1; ii < threadCount; ++ii )
+        workers.push_back( std::thread( plotLayers ) );
+
+    plotLayers();
+
+    for( auto& worker : workers )
+        worker.join();
+
+    return std::vector<bool>( plotted.begin(), plotted.end() );
+}
@@ -21,8 +21,11 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <climits>
+#include <cmath>
 #include <iostream>
 #include <sstream>
+#include <stdint.h>
 #include <wx/filename.h>
 #include <wx/string.h>
 #include <wx/log.h>
@@ -46,6 +49,182 @@
     } } while( 0 )
 
 
+// exact powers of ten representable by a double
+static const double pow10Table[] =
+{
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+
+static inline double scalePow10( double aValue, int aExponent )
+{
+    if( aExponent >= 0 )
+    {
+        if( aExponent <= 22 )
+            return aValue * pow10Table[aExponent];
+
+        return aValue * pow( 10.0, aExponent );
+    }
+
+    if( aExponent >= -22 )
+        return aValue / pow10Table[-aExponent];
+
+    return aValue * pow( 10.0, aExponent );
+}
+
+
+// a number must be followed by white space, a separator or the end of the line
+static inline bool isNumberEnd( char aChar )
+{
+    return (unsigned char) aChar <= 0x20 || ',' == aChar || '#' == aChar
+           || '[' == aChar || ']' == aChar || '{' == aChar || '}' == aChar;
+}
+
+
+// Parse a float in the VRML (C locale) format: [+-]digits[.digits][(e|E)[+-]digits].
+// Unlike strtod() and the stream operators this does not depend on the locale,
+// and it does not need a copy of the token.  Returns the position after the
+// number or NULL if there is no valid number at aStart.
+static const char* parseFloat( const char* aStart, float& aValue )
+{
+    // beyond this many significant digits the float result cannot change
+    const uint64_t maxMantissa = 100000000000000000ULL;
+
+    const char* cp = aStart;
+    bool negative = false;
+
+    if( '-' == *cp || '+' == *cp )
+        negative = ( '-' == *cp++ );
+
+    uint64_t mantissa = 0;
+    int exponent = 0;
+    int ndigits = 0;
+
+    for( ; *cp >= '0' && *cp <= '9'; ++cp, ++ndigits )
+    {
+        if( mantissa < maxMantissa )
+            mantissa = mantissa * 10 + ( *cp - '0' );
+        else
+            ++exponent;
+    }
+
+    if( '.' == *cp )
+    {
+        for( ++cp; *cp >= '0' && *cp <= '9'; ++cp, ++ndigits )
+        {
+            if( mantissa < maxMantissa )
+            {
+                mantissa = mantissa * 10 + ( *cp - '0' );
+                --exponent;
+            }
+        }
+    }
+
+    if( 0 == ndigits )
+        return NULL;
+
+    if( 'e' == *cp || 'E' == *cp )
+    {
+        ++cp;
+        bool negExp = false;
+
+        if( '-' == *cp || '+' == *cp )
+            negExp = ( '-' == *cp++ );
+
+        if( *cp < '0' || *cp > '9' )
+            return NULL;
+
+        int exp = 0;
+
+        for( ; *cp >= '0' && *cp <= '9'; ++cp )
+        {
+            if( exp < 10000 )
+                exp = exp * 10 + ( *cp - '0' );
+        }
+
+        exponent += negExp ? -exp : exp;
+    }
+
+    double value = 0.0;
+
+    if( mantissa )
+        value = scalePow10( (double) mantissa, exponent );
+
+    aValue = (float)( negative ? -value : value );
+
+    // out of range values are rejected as by the stream operators
+    if( !std::isfinite( aValue ) )
+        return NULL;
+
+    return cp;
+}
+
+
+// Parse a decimal or hexadecimal ("0x" prefix) integer; returns the position
+// after the number or NULL if there is no valid number at aStart.
+static const char* parseInt( const char* aStart, int& aValue )
+{
+    const char* cp = aStart;
+    bool negative = false;
+
+    if( '-' == *cp || '+' == *cp )
+        negative = ( '-' == *cp++ );
+
+    int64_t value = 0;
+    int ndigits = 0;
+
+    if( '0' == cp[0] && ( 'x' == cp[1] || 'X' == cp[1] ) )
+    {
+        // Rules: "0x" + "0-9, A-F" - VRML is case sensitive but in
+        // this instance we do no enforce case.
+        for( cp += 2; ; ++cp, ++ndigits )
+        {
+            int digit;
+
+            if( *cp >= '0' && *cp <= '9' )
+                digit = *cp - '0';
+            else if( *cp >= 'a' && *cp <= 'f' )
+                digit = *cp - 'a' + 10;
+            else if( *cp >= 'A' && *cp <= 'F' )
+                digit = *cp - 'A' + 10;
+            else
+                break;
+
+            value = value * 16 + digit;
+
+            if( value > 0xFFFFFFFFLL )
+                return NULL;
+        }
+
+        // hexadecimal values are bit patterns (typically packed colors)
+        value = (int32_t)(uint32_t) value;
+    }
+    else
+    {
+        for( ; *cp >= '0' && *cp <= '9'; ++cp, ++ndigits )
+        {
+            value = value * 10 + ( *cp - '0' );
+
+            if( value > 0x80000000LL )
+                return NULL;
+        }
+    }
+
+    if( 0 == ndigits )
+        return NULL;
+
+    if( negative )
+        value = -value;
+
+    if( value > INT_MAX || value < INT_MIN )
+        return NULL;
+
+    aValue = (int) value;
+    return cp;
+}
+
+
 WRLPROC::WRLPROC( LINE_READER* aLineReader )
 {
     m_fileVersion = VRML_INVALID;
@@ -218,6 +397,151 @@ RETRY:
 }
 
 
+bool WRLPROC::skipSeparator( bool aComma )
+{
+    // skip the white space on the current line without the EatSpace() overhead;
+    // EatSpace() is only needed to read the next lines and to discard comments
+    while( true )
+    {
+        while( m_bufpos < m_buf.size() && (unsigned char) m_buf[m_bufpos] <= 0x20 )
+            ++m_bufpos;
+
+        if( m_bufpos < m_buf.size() && '#' != m_buf[m_bufpos] )
+        {
+            if( !aComma || ',' != m_buf[m_bufpos] )
+                return true;
+
+            // the comma is a special instance of blank space; only one is allowed
+            ++m_bufpos;
+            aComma = false;
+            continue;
+        }
+
+        if( !EatSpace() )
+            return false;
+    }
+}
+
+
+bool WRLPROC::readFloats( float* aValues, int aCount, const char* aType )
+{
+    for( int i = 0; i < aCount; ++i )
+    {
+        if( !skipSeparator( i > 0 ) )
+            return false;
+
+        const char* sp = m_buf.c_str() + m_bufpos;
+        const char* ep = parseFloat( sp, aValues[i] );
+
+        if( NULL == ep || !isNumberEnd( *ep ) )
+        {
+            m_error = "invalid character in ";
+            m_error.append( aType );
+            return false;
+        }
+
+        m_bufpos += ep - sp;
+    }
+
+    // a comma immediately following the value is part of it
+    if( m_bufpos < m_buf.size() && ',' == m_buf[m_bufpos] )
+        ++m_bufpos;
+
+    return true;
+}
+
+
+bool WRLPROC::readInt( int& aValue )
+{
+    const char* sp = m_buf.c_str() + m_bufpos;
+    const char* ep = parseInt( sp, aValue );
+
+    if( NULL == ep || !isNumberEnd( *ep ) )
+    {
+        m_error = "invalid character in SFInt";
+        return false;
+    }
+
+    m_bufpos += ep - sp;
+
+    // a comma immediately following the value is part of it
+    if( m_bufpos < m_buf.size() && ',' == m_buf[m_bufpos] )
+        ++m_bufpos;
+
+    return true;
+}
+
+
+bool WRLPROC::readFloatArray( std::vector< float >& aValues, int aTupleSize,
+                              const char* aType )
+{
+    // the values of huge arrays (coordinates, normals) are parsed here in one
+    // loop rather than one SF field at a time
+    while( true )
+    {
+        if( !skipSeparator( true ) )
+            return false;
+
+        const char* sp = m_buf.c_str() + m_bufpos;
+
+        if( ']' == *sp )
+            break;
+
+        float value;
+        const char* ep = parseFloat( sp, value );
+
+        if( NULL == ep || !isNumberEnd( *ep ) )
+        {
+            m_error = "invalid character in ";
+            m_error.append( aType );
+            return false;
+        }
+
+        aValues.push_back( value );
+        m_bufpos += ep - sp;
+    }
+
+    if( aValues.size() % aTupleSize )
+    {
+        m_error = "incomplete ";
+        m_error.append( aType );
+        return false;
+    }
+
+    ++m_bufpos;
+    return true;
+}
+
+
+bool WRLPROC::readIntArray( std::vector< int >& aValues )
+{
+    while( true )
+    {
+        if( !skipSeparator( true ) )
+            return false;
+
+        if( ']' == m_buf[m_bufpos] )
+            break;
+
+        int value;
+        const char* sp = m_buf.c_str() + m_bufpos;
+        const char* ep = parseInt( sp, value );
+
+        if( NULL == ep || !isNumberEnd( *ep ) )
+        {
+            m_error = "invalid character in SFInt";
+            return false;
+        }
+
+        aValues.push_back( value );
+        m_bufpos += ep - sp;
+    }
+
+    ++m_bufpos;
+    return true;
+}
+
+
 WRLVERSION WRLPROC::GetVRMLType( void )
 {
     return m_fileVersion;
@@ -799,21 +1123,7 @@ bool WRLPROC::ReadSFFloat( float& aSFFloat )
     size_t fileline = m_fileline;
     size_t linepos = m_bufpos;
 
-    while( true )
-    {
-        if( !EatSpace() )
-            return false;
-
-        // if the text is the start of a comment block, clear the buffer and loop
-        if( '#' == m_buf[m_bufpos] )
-            m_buf.clear();
-        else
-            break;
-    }
-
-    std::string tmp;
-
-    if( !ReadGlob( tmp ) )
+    if( !readFloats( &aSFFloat, 1, "SFFloat" ) )
     {
         std::ostringstream ostr;
         ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -826,18 +1136,30 @@ bool WRLPROC::ReadSFFloat( float& aSFFloat )
         return false;
     }
 
-    std::istringstream istr;
-    istr.str( tmp );
-    istr >> aSFFloat;
+    return true;
+}
+
+
+bool WRLPROC::ReadSFInt( int& aSFInt32 )
+{
+    if( !m_file )
+    {
+        m_error = "no open file";
+        return false;
+    }
+
+    aSFInt32 = 0;
+    size_t fileline = m_fileline;
+    size_t linepos = m_bufpos;
 
-    if( istr.fail() || !istr.eof() )
+    if( !skipSeparator( false ) || !readInt( aSFInt32 ) )
     {
         std::ostringstream ostr;
         ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
         ostr << " * [INFO] failed on file '" << m_filename << "'\n";
         ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
         ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
-        ostr << " * [INFO] invalid character in SFFloat";
+        ostr << " * [INFO] " << m_error;
         m_error = ostr.str();
 
         return false;
@@ -847,7 +1169,7 @@ bool WRLPROC::ReadSFFloat( float& aSFFloat )
 }
 
 
-bool WRLPROC::ReadSFInt( int& aSFInt32 )
+bool WRLPROC::ReadSFRotation( WRLROTATION& aSFRotation )
 {
     if( !m_file )
     {
@@ -855,30 +1177,21 @@ bool WRLPROC::ReadSFInt( int& aSFInt32 )
         return false;
     }
 
-    aSFInt32 = 0;
+    aSFRotation.x = 0.0;
+    aSFRotation.y = 0.0;
+    aSFRotation.z = 1.0;
+    aSFRotation.w = 0.0;
+
     size_t fileline = m_fileline;
     size_t linepos = m_bufpos;
+    float tval[4];
 
-    while( true )
-    {
-        if( !EatSpace() )
-            return false;
-
-        // if the text is the start of a comment block, clear the buffer and loop
-        if( '#' == m_buf[m_bufpos] )
-            m_buf.clear();
-        else
-            break;
-    }
-
-    std::string tmp;
-
-    if( !ReadGlob( tmp ) )
+    if( !readFloats( tval, 4, "space delimited quartet" ) )
     {
         std::ostringstream ostr;
         ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
         ostr << " * [INFO] failed on file '" << m_filename << "'\n";
-        ostr << " * [INFO] line " << fileline<< ", char " << linepos << " -- ";
+        ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
         ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
         ostr << " * [INFO] " << m_error;
         m_error = ostr.str();
@@ -886,183 +1199,51 @@ bool WRLPROC::ReadSFInt( int& aSFInt32 )
         return false;
     }
 
-    if( std::string::npos != tmp.find( "0x" ) )
+    aSFRotation.x = tval[0];
+    aSFRotation.y = tval[1];
+    aSFRotation.z = tval[2];
+    aSFRotation.w = tval[3];
+
+    return true;
+}
+
+
+bool WRLPROC::ReadSFVec2f( WRLVEC2F& aSFVec2f )
+{
+    if( !m_file )
     {
-        // Rules: "0x" + "0-9, A-F" - VRML is case sensitive but in
-        // this instance we do no enforce case.
-        std::stringstream sstr;
-        sstr << std::hex << tmp;
-        sstr >> aSFInt32;
-        return true;
+        m_error = "no open file";
+        return false;
     }
 
-    std::istringstream istr;
-    istr.str( tmp );
-    istr >> aSFInt32;
+    aSFVec2f.x = 0.0;
+    aSFVec2f.y = 0.0;
+
+    size_t fileline = m_fileline;
+    size_t linepos = m_bufpos;
+    float tval[2];
 
-    if( istr.fail() || !istr.eof() )
+    if( !readFloats( tval, 2, "space delimited pair" ) )
     {
         std::ostringstream ostr;
         ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
         ostr << " * [INFO] failed on file '" << m_filename << "'\n";
         ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
         ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
-        ostr << " * [INFO] invalid character in SFInt";
+        ostr << " * [INFO] " << m_error;
         m_error = ostr.str();
 
         return false;
     }
 
+    aSFVec2f.x = tval[0];
+    aSFVec2f.y = tval[1];
+
     return true;
 }
 
 
-bool WRLPROC::ReadSFRotation( WRLROTATION& aSFRotation )
-{
-    if( !m_file )
-    {
-        m_error = "no open file";
-        return false;
-    }
-
-    aSFRotation.x = 0.0;
-    aSFRotation.y = 0.0;
-    aSFRotation.z = 1.0;
-    aSFRotation.w = 0.0;
-
-    size_t fileline = m_fileline;
-    size_t linepos = m_bufpos;
-
-    while( true )
-    {
-        if( !EatSpace() )
-            return false;
-
-        // if the text is the start of a comment block, clear the buffer and loop
-        if( '#' == m_buf[m_bufpos] )
-            m_buf.clear();
-        else
-            break;
-    }
-
-    std::string tmp;
-    float trot[4];
-
-    for( int i = 0; i < 4; ++i )
-    {
-        if( !ReadGlob( tmp ) )
-        {
-            std::ostringstream ostr;
-            ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
-            ostr << " * [INFO] failed on file '" << m_filename << "'\n";
-            ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
-            ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
-            ostr << " * [INFO] " << m_error;
-            m_error = ostr.str();
-
-            return false;
-        }
-
-        std::istringstream istr;
-        istr.str( tmp );
-        istr >> trot[i];
-
-        if( istr.fail() || !istr.eof() )
-        {
-            std::ostringstream ostr;
-            ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
-            ostr << " * [INFO] failed on file '" << m_filename << "'\n";
-            ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
-            ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
-            ostr << " * [INFO] invalid character in space delimited quartet";
-            m_error = ostr.str();
-
-            return false;
-        }
-
-    }
-
-    aSFRotation.x = trot[0];
-    aSFRotation.y = trot[1];
-    aSFRotation.z = trot[2];
-    aSFRotation.w = trot[3];
-
-    return true;
-}
-
-
-bool WRLPROC::ReadSFVec2f( WRLVEC2F& aSFVec2f )
-{
-    if( !m_file )
-    {
-        m_error = "no open file";
-        return false;
-    }
-
-    aSFVec2f.x = 0.0;
-    aSFVec2f.y = 0.0;
-
-    size_t fileline = m_fileline;
-    size_t linepos = m_bufpos;
-
-    while( true )
-    {
-        if( !EatSpace() )
-            return false;
-
-        // if the text is the start of a comment block, clear the buffer and loop
-        if( '#' == m_buf[m_bufpos] )
-            m_buf.clear();
-        else
-            break;
-    }
-
-    std::string tmp;
-
-    float tcol[2];
-
-    for( int i = 0; i < 2; ++i )
-    {
-        if( !ReadGlob( tmp ) )
-        {
-            std::ostringstream ostr;
-            ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
-            ostr << " * [INFO] failed on file '" << m_filename << "'\n";
-            ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
-            ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
-            ostr << " * [INFO] " << m_error;
-            m_error = ostr.str();
-
-            return false;
-        }
-
-        std::istringstream istr;
-        istr.str( tmp );
-        istr >> tcol[i];
-
-        if( istr.fail() || !istr.eof() )
-        {
-            std::ostringstream ostr;
-            ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
-            ostr << " * [INFO] failed on file '" << m_filename << "'\n";
-            ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
-            ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
-            ostr << " * [INFO] invalid character in space delimited pair";
-            m_error = ostr.str();
-
-            return false;
-        }
-
-    }
-
-    aSFVec2f.x = tcol[0];
-    aSFVec2f.y = tcol[1];
-
-    return true;
-}
-
-
-bool WRLPROC::ReadSFVec3f( WRLVEC3F& aSFVec3f )
+bool WRLPROC::ReadSFVec3f( WRLVEC3F& aSFVec3f )
 {
     if( !m_file )
     {
@@ -1076,67 +1257,24 @@ bool WRLPROC::ReadSFVec3f( WRLVEC3F& aSFVec3f )
 
     size_t fileline = m_fileline;
     size_t linepos = m_bufpos;
+    float tval[3];
 
-    while( true )
+    if( !readFloats( tval, 3, "space delimited triplet" ) )
     {
-        if( !EatSpace() )
-            return false;
-
-        // if the text is the start of a comment block, clear the buffer and loop
-        if( '#' == m_buf[m_bufpos] )
-            m_buf.clear();
-        else
-            break;
-    }
-
-    std::string tmp;
-
-    float tcol[3];
-
-    for( int i = 0; i < 3; ++i )
-    {
-        if( !ReadGlob( tmp ) )
-        {
-            std::ostringstream ostr;
-            ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
-            ostr << " * [INFO] failed on file '" << m_filename << "'\n";
-            ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
-            ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
-            ostr << " * [INFO] " << m_error;
-            m_error = ostr.str();
-
-            return false;
-        }
-
-        // ignore any commas
-        if( !EatSpace() )
-            return false;
-
-        if( ',' == m_buf[m_bufpos] )
-            Pop();
-
-        std::istringstream istr;
-        istr.str( tmp );
-        istr >> tcol[i];
-
-        if( istr.fail() || !istr.eof() )
-        {
-            std::ostringstream ostr;
-            ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
-            ostr << " * [INFO] failed on file '" << m_filename << "'\n";
-            ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
-            ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
-            ostr << " * [INFO] invalid character in space delimited triplet";
-            m_error = ostr.str();
-
-            return false;
-        }
+        std::ostringstream ostr;
+        ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
+        ostr << " * [INFO] failed on file '" << m_filename << "'\n";
+        ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
+        ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
+        ostr << " * [INFO] " << m_error;
+        m_error = ostr.str();
 
+        return false;
     }
 
-    aSFVec3f.x = tcol[0];
-    aSFVec3f.y = tcol[1];
-    aSFVec3f.z = tcol[2];
+    aSFVec3f.x = tval[0];
+    aSFVec3f.y = tval[1];
+    aSFVec3f.z = tval[2];
 
     return true;
 }
@@ -1324,51 +1462,42 @@ bool WRLPROC::ReadMFColor( std::vector< WRLVEC3F >& aMFColor )
 
     ++m_bufpos;
 
-    while( true )
-    {
-        if( !EatSpace() )
-            return false;
-
-        if( ']' == m_buf[m_bufpos] )
-            break;
-
-        if( !ReadSFColor( lcolor ) )
-        {
-            std::ostringstream ostr;
-            ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
-            ostr << " * [INFO] failed on file '" << m_filename << "'\n";
-            ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
-            ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
-            ostr << " * [INFO] " << m_error;
-            m_error = ostr.str();
+    std::vector< float > values;
 
-            return false;
-        }
+    if( !readFloatArray( values, 3, "space delimited triplet" ) )
+    {
+        std::ostringstream ostr;
+        ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
+        ostr << " * [INFO] failed on file '" << m_filename << "'\n";
+        ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
+        ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
+        ostr << " * [INFO] " << m_error;
+        m_error = ostr.str();
 
-        aMFColor.push_back( lcolor );
+        return false;
+    }
 
-        if( !EatSpace() )
+    for( size_t i = 0; i < values.size(); ++i )
+    {
+        if( values[i] < 0.0 || values[i] > 1.0 )
         {
             std::ostringstream ostr;
             ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
             ostr << " * [INFO] failed on file '" << m_filename << "'\n";
             ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
             ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
-            ostr << " * [INFO] could not check characters after the string";
+            ostr << " * [INFO] invalid RGB value in color triplet";
             m_error = ostr.str();
 
             return false;
         }
+    }
 
-        if( ']' == m_buf[m_bufpos] )
-            break;
+    aMFColor.reserve( values.size() / 3 );
 
-        if( ',' == m_buf[m_bufpos] )
-            Pop();
+    for( size_t i = 0; i < values.size(); i += 3 )
+        aMFColor.push_back( WRLVEC3F( values[i], values[i + 1], values[i + 2] ) );
 
-    }
-
-    ++m_bufpos;
     return true;
 }
 
@@ -1436,51 +1565,19 @@ bool WRLPROC::ReadMFFloat( std::vector< float >& aMFFloat )
 
     ++m_bufpos;
 
-    while( true )
+    if( !readFloatArray( aMFFloat, 1, "SFFloat" ) )
     {
-        if( !EatSpace() )
-            return false;
-
-        if( ']' == m_buf[m_bufpos] )
-            break;
-
-        if( !ReadSFFloat( temp ) )
-        {
-            std::ostringstream ostr;
-            ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
-            ostr << " * [INFO] failed on file '" << m_filename << "'\n";
-            ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
-            ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
-            ostr << " * [INFO] " << m_error;
-            m_error = ostr.str();
-
-            return false;
-        }
-
-        aMFFloat.push_back( temp );
-
-        if( !EatSpace() )
-        {
-            std::ostringstream ostr;
-            ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
-            ostr << " * [INFO] failed on file '" << m_filename << "'\n";
-            ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
-            ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
-            ostr << " * [INFO] could not check characters after the string";
-            m_error = ostr.str();
-
-            return false;
-        }
-
-        if( ']' == m_buf[m_bufpos] )
-            break;
-
-        if( ',' == m_buf[m_bufpos] )
-            Pop();
+        std::ostringstream ostr;
+        ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
+        ostr << " * [INFO] failed on file '" << m_filename << "'\n";
+        ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
+        ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
+        ostr << " * [INFO] " << m_error;
+        m_error = ostr.str();
 
+        return false;
     }
 
-    ++m_bufpos;
     return true;
 }
 
@@ -1548,51 +1645,19 @@ bool WRLPROC::ReadMFInt( std::vector< int >& aMFInt32 )
 
     ++m_bufpos;
 
-    while( true )
+    if( !readIntArray( aMFInt32 ) )
     {
-        if( !EatSpace() )
-            return false;
-
-        if( ']' == m_buf[m_bufpos] )
-            break;
-
-        if( !ReadSFInt( temp ) )
-        {
-            std::ostringstream ostr;
-            ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
-            ostr << " * [INFO] failed on file '" << m_filename << "'\n";
-            ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
-            ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
-            ostr << " * [INFO] " << m_error;
-            m_error = ostr.str();
-
-            return false;
-        }
-
-        aMFInt32.push_back( temp );
-
-        if( !EatSpace() )
-        {
-            std::ostringstream ostr;
-            ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
-            ostr << " * [INFO] failed on file '" << m_filename << "'\n";
-            ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
-            ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
-            ostr << " * [INFO] could not check characters after the string";
-            m_error = ostr.str();
-
-            return false;
-        }
-
-        if( ']' == m_buf[m_bufpos] )
-            break;
-
-        if( ',' == m_buf[m_bufpos] )
-            Pop();
+        std::ostringstream ostr;
+        ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
+        ostr << " * [INFO] failed on file '" << m_filename << "'\n";
+        ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
+        ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
+        ostr << " * [INFO] " << m_error;
+        m_error = ostr.str();
 
+        return false;
     }
 
-    ++m_bufpos;
     return true;
 }
 
@@ -1660,51 +1725,26 @@ bool WRLPROC::ReadMFRotation( std::vector< WRLROTATION >& aMFRotation )
 
     ++m_bufpos;
 
-    while( true )
-    {
-        if( !EatSpace() )
-            return false;
-
-        if( ']' == m_buf[m_bufpos] )
-            break;
-
-        if( !ReadSFRotation( lrot ) )
-        {
-            std::ostringstream ostr;
-            ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
-            ostr << " * [INFO] failed on file '" << m_filename << "'\n";
-            ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
-            ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
-            ostr << " * [INFO] " << m_error;
-            m_error = ostr.str();
-
-            return false;
-        }
+    std::vector< float > values;
 
-        aMFRotation.push_back( lrot );
-
-        if( !EatSpace() )
-        {
-            std::ostringstream ostr;
-            ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
-            ostr << " * [INFO] failed on file '" << m_filename << "'\n";
-            ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
-            ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
-            ostr << " * [INFO] could not check characters after the string";
-            m_error = ostr.str();
-
-            return false;
-        }
+    if( !readFloatArray( values, 4, "space delimited quartet" ) )
+    {
+        std::ostringstream ostr;
+        ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
+        ostr << " * [INFO] failed on file '" << m_filename << "'\n";
+        ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
+        ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
+        ostr << " * [INFO] " << m_error;
+        m_error = ostr.str();
 
-        if( ']' == m_buf[m_bufpos] )
-            break;
+        return false;
+    }
 
-        if( ',' == m_buf[m_bufpos] )
-            Pop();
+    aMFRotation.reserve( values.size() / 4 );
 
-    }
+    for( size_t i = 0; i < values.size(); i += 4 )
+        aMFRotation.push_back( WRLROTATION( values[i], values[i + 1], values[i + 2], values[i + 3] ) );
 
-    ++m_bufpos;
     return true;
 }
 
@@ -1772,51 +1812,26 @@ bool WRLPROC::ReadMFVec2f( std::vector< WRLVEC2F >& aMFVec2f )
 
     ++m_bufpos;
 
-    while( true )
-    {
-        if( !EatSpace() )
-            return false;
-
-        if( ']' == m_buf[m_bufpos] )
-            break;
-
-        if( !ReadSFVec2f( lvec2f ) )
-        {
-            std::ostringstream ostr;
-            ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
-            ostr << " * [INFO] failed on file '" << m_filename << "'\n";
-            ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
-            ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
-            ostr << " * [INFO] " << m_error;
-            m_error = ostr.str();
-
-            return false;
-        }
-
-        aMFVec2f.push_back( lvec2f );
+    std::vector< float > values;
 
-        if( !EatSpace() )
-        {
-            std::ostringstream ostr;
-            ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
-            ostr << " * [INFO] failed on file '" << m_filename << "'\n";
-            ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
-            ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
-            ostr << " * [INFO] could not check characters after the string";
-            m_error = ostr.str();
-
-            return false;
-        }
+    if( !readFloatArray( values, 2, "space delimited pair" ) )
+    {
+        std::ostringstream ostr;
+        ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
+        ostr << " * [INFO] failed on file '" << m_filename << "'\n";
+        ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
+        ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
+        ostr << " * [INFO] " << m_error;
+        m_error = ostr.str();
 
-        if( ']' == m_buf[m_bufpos] )
-            break;
+        return false;
+    }
 
-        if( ',' == m_buf[m_bufpos] )
-            Pop();
+    aMFVec2f.reserve( values.size() / 2 );
 
-    }
+    for( size_t i = 0; i < values.size(); i += 2 )
+        aMFVec2f.push_back( WRLVEC2F( values[i], values[i + 1] ) );
 
-    ++m_bufpos;
     return true;
 }
 
@@ -1884,54 +1899,26 @@ bool WRLPROC::ReadMFVec3f( std::vector< WRLVEC3F >& aMFVec3f )
 
     ++m_bufpos;
 
-    while( true )
-    {
-        if( !EatSpace() )
-            return false;
-
-        if( ']' == m_buf[m_bufpos] )
-            break;
-
-        if( !ReadSFVec3f( lvec3f ) )
-        {
-            std::ostringstream ostr;
-            ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
-            ostr << " * [INFO] failed on file '" << m_filename << "'\n";
-            ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
-            ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
-            ostr << " * [INFO] " << m_error;
-            m_error = ostr.str();
-
-            return false;
-        }
-
-        aMFVec3f.push_back( lvec3f );
-
-        if( !EatSpace() )
-        {
-            std::ostringstream ostr;
-            ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
-            ostr << " * [INFO] failed on file '" << m_filename << "'\n";
-            ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
-            ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
-            ostr << " * [INFO] could not check characters after the string";
-            m_error = ostr.str();
-
-            return false;
-        }
+    std::vector< float > values;
 
-        if( !EatSpace() )
-            return false;
+    if( !readFloatArray( values, 3, "space delimited triplet" ) )
+    {
+        std::ostringstream ostr;
+        ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
+        ostr << " * [INFO] failed on file '" << m_filename << "'\n";
+        ostr << " * [INFO] line " << fileline << ", char " << linepos << " -- ";
+        ostr << "line " << m_fileline << ", char " << m_bufpos << "\n";
+        ostr << " * [INFO] " << m_error;
+        m_error = ostr.str();
 
-        if( ']' == m_buf[m_bufpos] )
-            break;
+        return false;
+    }
 
-        if( ',' == m_buf[m_bufpos] )
-            Pop();
+    aMFVec3f.reserve( values.size() / 3 );
 
-    }
+    for( size_t i = 0; i < values.size(); i += 3 )
+        aMFVec3f.push_back( WRLVEC3F( values[i], values[i + 1], values[i + 2] ) );
 
-    ++m_bufpos;
     return true;
 }
 
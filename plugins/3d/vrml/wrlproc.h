@@ -58,6 +58,19 @@ private:
     // parameters are updated as appropriate.
     bool getRawLine( void );
 
+    // skipSeparator discards white space and comments up to the next token;
+    // if aComma is true a single comma is also discarded
+    bool skipSeparator( bool aComma );
+
+    // number readers working directly on the line buffer; the values are
+    // parsed in the C locale whatever the locale of the application is
+    bool readFloats( float* aValues, int aCount, const char* aType );
+    bool readInt( int& aValue );
+
+    // read the values of an MF field up to and including the closing bracket
+    bool readFloatArray( std::vector< float >& aValues, int aTupleSize, const char* aType );
+    bool readIntArray( std::vector< int >& aValues );
+
 public:
     WRLPROC( LINE_READER* aLineReader );
     ~WRLPROC();
@@ -0,0 +1,252 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2017 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * Renders a board with the raytracer to a PNG file, without OpenGL.
+ *
+ * With a board file, the board is rendered to the given PNG file.
+ * Without arguments, a small board is built and rendered to a temporary file,
+ * then the size and the contents of the image are checked.
+ */
+
+#include <io_mgr.h>
+#include <kicad_plugin.h>
+
+#include <class_board.h>
+#include <class_drawsegment.h>
+#include <class_track.h>
+#include <convert_to_biu.h>
+
+#include <3d_rendering/3d_render_raytracing/c3d_render_raytracing.h>
+
+#include <wx/filename.h>
+#include <wx/image.h>
+
+#include <memory>
+
+
+BOARD* loadBoard( const std::string& filename )
+{
+    PLUGIN::RELEASER pi( new PCB_IO );
+    BOARD* brd = nullptr;
+
+    try
+    {
+        brd = pi->Load( wxString( filename.c_str() ), NULL, NULL );
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        wxString msg = wxString::Format( _( "Error loading board.\n%s" ),
+                ioe.Problem() );
+
+        printf( "%s\n", (const char*) msg.mb_str() );
+        return nullptr;
+    }
+
+    return brd;
+}
+
+
+/**
+ * Creates a 20 x 15 mm board, with a wide track on the top copper layer.
+ */
+BOARD* createTestBoard()
+{
+    BOARD* brd = new BOARD();
+
+    const wxPoint corners[4] =
+    {
+        wxPoint( 0, 0 ),
+        wxPoint( Millimeter2iu( 20 ), 0 ),
+        wxPoint( Millimeter2iu( 20 ), Millimeter2iu( 15 ) ),
+        wxPoint( 0, Millimeter2iu( 15 ) )
+    };
+
+    for( int ii = 0; ii < 4; ++ii )
+    {
+        DRAWSEGMENT* segment = new DRAWSEGMENT( brd );
+
+        segment->SetLayer( Edge_Cuts );
+        segment->SetStart( corners[ii] );
+        segment->SetEnd( corners[( ii + 1 ) % 4] );
+        segment->SetWidth( Millimeter2iu( 0.1 ) );
+        brd->Add( segment );
+    }
+
+    TRACK* track = new TRACK( brd );
+
+    track->SetLayer( F_Cu );
+    track->SetStart( wxPoint( Millimeter2iu( 2 ), Millimeter2iu( 7.5 ) ) );
+    track->SetEnd( wxPoint( Millimeter2iu( 18 ), Millimeter2iu( 7.5 ) ) );
+    track->SetWidth( Millimeter2iu( 3 ) );
+    brd->Add( track );
+
+    return brd;
+}
+
+
+/**
+ * Sets the board of aSettings, and its camera to see the board from above,
+ * slightly tilted to show the copper thickness.
+ */
+void initSettings( CINFO3D_VISU& aSettings, BOARD* aBoard )
+{
+    aSettings.SetBoard( aBoard );
+    aSettings.RenderEngineSet( RENDER_ENGINE_RAYTRACING );
+    aSettings.CameraGet().RotateX( -0.3f );
+}
+
+
+bool renderBoard( CINFO3D_VISU& aSettings, const wxSize& aSize, const wxString& aFileName )
+{
+    C3D_RENDER_RAYTRACING renderer( aSettings );
+    RT_RENDER_TIMINGS     timings;
+
+    if( !renderer.RenderToFile( aSize, aFileName, &timings ) )
+        return false;
+
+    printf( "scene %.3f s, BVH %.3f s, tracing %.3f s, post-shading %.3f s\n",
+            timings.m_sceneBuild / 1e6, timings.m_accelerator / 1e6,
+            timings.m_tracing / 1e6, timings.m_postShading / 1e6 );
+
+    return true;
+}
+
+
+/**
+ * Renders the test board and checks the image: it must have the requested size,
+ * a uniform background in the corners and the board in the center.
+ */
+int selfTest()
+{
+    const wxSize   size( 128, 96 );
+    const wxString tempName = wxFileName::CreateTempFileName( wxT( "rt_render" ) );
+    const wxString fileName = tempName + wxT( ".png" );
+
+    wxRemoveFile( tempName );   // only its name is used
+
+    std::unique_ptr<BOARD> brd( createTestBoard() );
+    CINFO3D_VISU           settings;
+
+    initSettings( settings, brd.get() );
+
+    // A uniform background, and the board far enough to not reach the corners
+    settings.m_BgColorTop = SFVEC3D( 0.0, 0.0, 1.0 );
+    settings.m_BgColorBot = SFVEC3D( 0.0, 0.0, 1.0 );
+    settings.CameraGet().Zoom( 0.5f );
+
+    if( !renderBoard( settings, size, fileName ) )
+    {
+        printf( "render failed\n" );
+        return 1;
+    }
+
+    wxImage image;
+    bool    loaded = image.LoadFile( fileName, wxBITMAP_TYPE_PNG );
+
+    wxRemoveFile( fileName );
+
+    if( !loaded )
+    {
+        printf( "cannot read the rendered image\n" );
+        return 1;
+    }
+
+    if( image.GetWidth() != size.x || image.GetHeight() != size.y )
+    {
+        printf( "bad image size %dx%d, expected %dx%d\n",
+                image.GetWidth(), image.GetHeight(), size.x, size.y );
+        return 1;
+    }
+
+    auto samePixel = [&]( int x0, int y0, int x1, int y1 )
+    {
+        return image.GetRed( x0, y0 ) == image.GetRed( x1, y1 ) &&
+               image.GetGreen( x0, y0 ) == image.GetGreen( x1, y1 ) &&
+               image.GetBlue( x0, y0 ) == image.GetBlue( x1, y1 );
+    };
+
+    const int xMax = size.x - 1;
+    const int yMax = size.y - 1;
+
+    if( !samePixel( 0, 0, xMax, 0 ) || !samePixel( 0, 0, 0, yMax ) ||
+        !samePixel( 0, 0, xMax, yMax ) )
+    {
+        printf( "the background is not uniform\n" );
+        return 1;
+    }
+
+    if( image.GetBlue( 0, 0 ) < 128 || image.GetRed( 0, 0 ) > 64 )
+    {
+        printf( "the background does not have the requested color\n" );
+        return 1;
+    }
+
+    if( samePixel( 0, 0, size.x / 2, size.y / 2 ) )
+    {
+        printf( "the board is not rendered\n" );
+        return 1;
+    }
+
+    printf( "ok\n" );
+    return 0;
+}
+
+
+int main( int argc, char* argv[] )
+{
+    wxInitAllImageHandlers();
+
+    if( argc == 1 )
+        return selfTest();
+
+    if( argc != 3 && argc != 5 )
+    {
+        printf( "A tool rendering a board with the raytracer, without OpenGL.\n" );
+        printf( "usage : %s board_file.kicad_pcb image_file.png [width height]\n", argv[0] );
+        printf( "        %s (renders a test board and checks the image)\n\n", argv[0] );
+        return -1;
+    }
+
+    wxSize size( 1024, 768 );
+
+    if( argc == 5 )
+        size = wxSize( atoi( argv[3] ), atoi( argv[4] ) );
+
+    std::unique_ptr<BOARD> brd( loadBoard( argv[1] ) );
+
+    if( !brd )
+        return -1;
+
+    CINFO3D_VISU settings;
+
+    initSettings( settings, brd.get() );
+
+    if( !renderBoard( settings, size, wxString( argv[2] ) ) )
+    {
+        printf( "cannot render the board to %s (the image must be at least 64x64)\n", argv[2] );
+        return -1;
+    }
+
+    return 0;
+}